@@ -1,13 +1,13 @@
-// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
-
-using UnrealBuildTool;
-using System.Collections.Generic;
-
-public class NeuronWeaponPlaygroundTarget : TargetRules
-{
-	public NeuronWeaponPlaygroundTarget(TargetInfo Target) : base(Target)
-	{
-		Type = TargetType.Game;
-		ExtraModuleNames.Add("NeuronWeaponPlayground");
-	}
-}
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class NeuronWeaponPlaygroundTarget : TargetRules
+{
+	public NeuronWeaponPlaygroundTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Game;
+		ExtraModuleNames.Add("NeuronWeaponPlayground");
+	}
+}
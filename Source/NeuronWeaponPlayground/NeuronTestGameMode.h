@@ -1,19 +1,19 @@
-// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/GameModeBase.h"
-#include "NeuronTestGameMode.generated.h"
-
-UCLASS(minimalapi)
-class ANeuronTestGameMode : public AGameModeBase
-{
-	GENERATED_BODY()
-
-public:
-	ANeuronTestGameMode();
-};
-
-
-
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "NeuronTestGameMode.generated.h"
+
+UCLASS(minimalapi)
+class ANeuronTestGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	ANeuronTestGameMode();
+};
+
+
+
@@ -1,25 +1,25 @@
-// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
-
-#pragma once 
-
-#include "CoreMinimal.h"
-#include "GameFramework/HUD.h"
-#include "NeuronTestHUD.generated.h"
-
-UCLASS()
-class ANeuronTestHUD : public AHUD
-{
-	GENERATED_BODY()
-
-public:
-	ANeuronTestHUD();
-
-	/** Primary draw call for the HUD */
-	virtual void DrawHUD() override;
-
-private:
-	/** Crosshair asset pointer */
-	class UTexture2D* CrosshairTex;
-
-};
-
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once 
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "NeuronTestHUD.generated.h"
+
+UCLASS()
+class ANeuronTestHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	ANeuronTestHUD();
+
+	/** Primary draw call for the HUD */
+	virtual void DrawHUD() override;
+
+private:
+	/** Crosshair asset pointer */
+	class UTexture2D* CrosshairTex;
+
+};
+
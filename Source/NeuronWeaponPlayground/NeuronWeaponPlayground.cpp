@@ -1,8 +1,8 @@
-// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
-
-#include "NeuronWeaponPlayground.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, NeuronWeaponPlayground, "NeuronWeaponPlayground" );
- 
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#include "NeuronWeaponPlayground.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, NeuronWeaponPlayground, "NeuronWeaponPlayground" );
+ 
 DEFINE_LOG_CATEGORY(LogNWP);
\ No newline at end of file
@@ -1,57 +1,83 @@
-// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
-// Collision projectiles
-#define COLLISION_WEAPON			ECC_GameTraceChannel1
-
-// Console variables
-static TAutoConsoleVariable<int32> CVarbDebugWeapon(
-	TEXT("NWP.bDebugWeapon"),
-	0,
-	TEXT("Shows the debug information of the weapon.\n")
-	TEXT("0: Disables display of weapon debug information. \n")
-	TEXT("1: Enables display of weapon debug information. \n"),
-	ECVF_Default);
-
-// Log category
-DECLARE_LOG_CATEGORY_EXTERN(LogNWP, Log, All);
-
-// Enum for the states of the weapon
-UENUM(BlueprintType)
-enum class ENWPWeaponState : uint8
-{
-	Invalid,
-	None,
-	Shooting,
-	Reloading,
-};
-
-// Enum for the types of cadence
-UENUM(BlueprintType)
-enum class ENWPWeaponCadenceType : uint8
-{
-	Automatic,
-	SemiAutomatic,
-	COUNT,
-};
-
-// Enum for the cadence configurations
-UENUM(BlueprintType)
-enum class ENWPWeaponCadenceConfig : uint8
-{
-	Automatic,
-	SemiAutomatic,
-	Both,
-};
-
-// Enum for the states of the smart projectiles
-UENUM(BlueprintType)
-enum class ENWPSmartProjectileState : uint8
-{
-	OrientatingToAvoidObstacle,
-	OrientatingToTarget,
-	HitWithSomething,
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// Collision projectiles
+#define COLLISION_WEAPON			ECC_GameTraceChannel1
+
+// Trace used by the smart projectiles to find obstacles. Projectiles ignore it, so they never block each other
+#define COLLISION_PROJECTILE_OBSTACLE	ECC_GameTraceChannel3
+
+// Console variables
+// Defined in NWPWeapon.cpp, read by the weapons
+extern TAutoConsoleVariable<int32> CVarbDebugWeapon;
+
+// Stats group
+DECLARE_STATS_GROUP(TEXT("NWP"), STATGROUP_NWP, STATCAT_Advanced);
+
+// Log category
+DECLARE_LOG_CATEGORY_EXTERN(LogNWP, Log, All);
+
+// Enum for the states of the weapon
+UENUM(BlueprintType)
+enum class ENWPWeaponState : uint8
+{
+	Invalid,
+	None,
+	Shooting,
+	Reloading,
+};
+
+// Enum for the types of cadence
+UENUM(BlueprintType)
+enum class ENWPWeaponCadenceType : uint8
+{
+	Automatic,
+	SemiAutomatic,
+	COUNT,
+};
+
+// Enum for the cadence configurations
+UENUM(BlueprintType)
+enum class ENWPWeaponCadenceConfig : uint8
+{
+	Automatic,
+	SemiAutomatic,
+	Both,
+};
+
+// Enum for the states of the smart projectiles
+UENUM(BlueprintType)
+enum class ENWPSmartProjectileState : uint8
+{
+	OrientatingToAvoidObstacle,
+	OrientatingToTarget,
+	HitWithSomething,
+};
+
+// Enum for the qualities of the traces
+UENUM(BlueprintType)
+enum class ENWPTraceQuality : uint8
+{
+	// Only the simple collision
+	Simple,
+	// The simple collision, refined with the complex collision if it has hit something
+	SimpleThenComplex,
+	// Only the complex collision
+	Complex,
+};
+
+// Enum for the policies used to select the target of each smart projectile
+UENUM(BlueprintType)
+enum class ENWPTargetAllocationPolicy : uint8
+{
+	// The target with the smallest angle with respect to the weapon forward
+	BestAngle,
+	// The target selected the longest time ago, so a burst goes through all the targets
+	RoundRobin,
+	// The target followed by the fewest projectiles in flight
+	FewestAssignments,
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPObstacleCache.h"
+
+// UE
+#include "Engine/World.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+#include "NWPUtils.h"
+
+// Stats
+DECLARE_DWORD_COUNTER_STAT(TEXT("Obstacle Cache Hits"), STAT_NWPObstacleCacheHits, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Obstacle Cache Misses"), STAT_NWPObstacleCacheMisses, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cached Obstacles"), STAT_NWPCachedObstacles, STATGROUP_NWP);
+
+FNWPObstacleCacheEntry::FNWPObstacleCacheEntry()
+{
+	Transform = FTransform::Identity;
+	Bounds = FBox(ForceInit);
+	HalfXYDiagonal = 0.0f;
+	HalfHeight = 0.0f;
+}
+
+ANWPObstacleCache::ANWPObstacleCache(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// The obstacles are refreshed when they are requested
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+void ANWPObstacleCache::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Stop listening to the obstacles that are still alive
+	for (const TPair<TWeakObjectPtr<AActor>, FNWPObstacleCacheEntry>& Obstacle : Obstacles)
+	{
+		if (AActor* ObstacleActor = Obstacle.Key.Get())
+		{
+			ObstacleActor->OnEndPlay.RemoveDynamic(this, &ANWPObstacleCache::OnObstacleEndPlay);
+		}
+	}
+
+	DEC_DWORD_STAT_BY(STAT_NWPCachedObstacles, Obstacles.Num());
+	Obstacles.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+ANWPObstacleCache* ANWPObstacleCache::GetObstacleCache(UWorld* World, bool _bSpawnIfMissing)
+{
+	return UNWPUtils::GetWorldManager<ANWPObstacleCache>(World, _bSpawnIfMissing);
+}
+
+const FNWPObstacleCacheEntry& ANWPObstacleCache::GetObstacle(AActor* _Obstacle)
+{
+	check(_Obstacle);
+
+	FNWPObstacleCacheEntry* Entry = Obstacles.Find(_Obstacle);
+
+	// Return the cached data if the obstacle has not moved
+	if (Entry && Entry->Transform.Equals(_Obstacle->GetActorTransform(), 0.0f))
+	{
+		INC_DWORD_STAT(STAT_NWPObstacleCacheHits);
+		return *Entry;
+	}
+
+	// Start listening to the obstacle, so it leaves the cache when it ends play
+	if (!Entry)
+	{
+		Entry = &Obstacles.Add(_Obstacle);
+		_Obstacle->OnEndPlay.AddUniqueDynamic(this, &ANWPObstacleCache::OnObstacleEndPlay);
+
+		INC_DWORD_STAT(STAT_NWPCachedObstacles);
+	}
+
+	INC_DWORD_STAT(STAT_NWPObstacleCacheMisses);
+
+	ComputeObstacle(_Obstacle, *Entry);
+	return *Entry;
+}
+
+void ANWPObstacleCache::ComputeObstacle(const AActor* _Obstacle, FNWPObstacleCacheEntry& _OutEntry)
+{
+	_OutEntry.Transform = _Obstacle->GetActorTransform();
+	_OutEntry.Bounds = _Obstacle->GetComponentsBoundingBox();
+
+	// Calculate the diagonal of the bounding box in XY & its height
+	const FVector BoundsSize = _OutEntry.Bounds.GetSize();
+	_OutEntry.HalfXYDiagonal = FMath::Sqrt(BoundsSize.X * BoundsSize.X + BoundsSize.Y * BoundsSize.Y) / 2.0f;
+	_OutEntry.HalfHeight = BoundsSize.Z / 2.0f;
+}
+
+void ANWPObstacleCache::OnObstacleEndPlay(AActor* _Obstacle, EEndPlayReason::Type EndPlayReason)
+{
+	if (Obstacles.Remove(_Obstacle) > 0)
+	{
+		DEC_DWORD_STAT(STAT_NWPCachedObstacles);
+	}
+}
@@ -1,3 +1,36 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPTarget.h"
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPTarget.h"
+
+// NWP
+#include "NWPTargetRegistry.h"
+
+ANWPTarget::ANWPTarget(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	OwnerRegistry = nullptr;
+	RegistryIndex = INDEX_NONE;
+}
+
+void ANWPTarget::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Join the target registry of the world
+	ANWPTargetRegistry* TargetRegistry = ANWPTargetRegistry::GetTargetRegistry(GetWorld());
+
+	if (TargetRegistry)
+	{
+		TargetRegistry->RegisterTarget(this);
+	}
+}
+
+void ANWPTarget::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leave the target registry
+	if (OwnerRegistry)
+	{
+		OwnerRegistry->UnregisterTarget(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,322 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPTargetRegistry.h"
+
+// UE
+#include "ConvexVolume.h"
+#include "Engine/World.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+#include "NWPTarget.h"
+#include "NWPUtils.h"
+
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Target Registry Tick"), STAT_NWPTargetRegistryTick, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Targets"), STAT_NWPRegisteredTargets, STATGROUP_NWP);
+DECLARE_CYCLE_STAT(TEXT("Target Registry Query"), STAT_NWPTargetRegistryQuery, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Query Visited Cells"), STAT_NWPTargetQueryVisitedCells, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Query Tested Targets"), STAT_NWPTargetQueryTestedTargets, STATGROUP_NWP);
+
+// Console variables
+static TAutoConsoleVariable<float> CVarTargetGridCellSize(
+	TEXT("NWP.TargetGridCellSize"),
+	2000.0f,
+	TEXT("Size of the cells of the grid used by the target registry to find the targets.\n"),
+	ECVF_Default);
+
+ANWPTargetRegistry::ANWPTargetRegistry(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// Refresh the positions after the physics, so the HUD & the next weapon update read where the targets ended the frame
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	ChangeCounter = 0;
+	GridCellSize = FMath::Max(CVarTargetGridCellSize.GetValueOnGameThread(), 1.0f);
+}
+
+void ANWPTargetRegistry::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Detach the targets, so they do not try to leave a registry that no longer exists
+	for (ANWPTarget* Target : Targets)
+	{
+		if (Target)
+		{
+			Target->RegistryIndex = INDEX_NONE;
+			Target->OwnerRegistry = nullptr;
+		}
+	}
+
+	Targets.Empty();
+	TargetPositions.Empty();
+	TargetBounds.Empty();
+	TargetGridCells.Empty();
+	GridCells.Empty();
+	++ChangeCounter;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANWPTargetRegistry::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NWPTargetRegistryTick);
+
+	Super::Tick(DeltaSeconds);
+
+	// Rebuild the grid if the cell size has been changed
+	const float NewGridCellSize = FMath::Max(CVarTargetGridCellSize.GetValueOnGameThread(), 1.0f);
+
+	if (NewGridCellSize != GridCellSize)
+	{
+		RebuildGrid(NewGridCellSize);
+	}
+
+	bool bAnyTargetMoved = false;
+
+	for (int32 Index = 0; Index < Targets.Num(); ++Index)
+	{
+		bAnyTargetMoved |= RefreshTarget(Index);
+	}
+
+	if (bAnyTargetMoved)
+	{
+		++ChangeCounter;
+	}
+
+	SET_DWORD_STAT(STAT_NWPRegisteredTargets, Targets.Num());
+}
+
+ANWPTargetRegistry* ANWPTargetRegistry::GetTargetRegistry(UWorld* World, bool _bSpawnIfMissing)
+{
+	return UNWPUtils::GetWorldManager<ANWPTargetRegistry>(World, _bSpawnIfMissing);
+}
+
+bool ANWPTargetRegistry::GetTargetPosition(const class ANWPTarget* _Target, FVector& _OutPosition) const
+{
+	// Early return if the target is not registered here
+	if (!_Target || _Target->OwnerRegistry != this || !TargetPositions.IsValidIndex(_Target->RegistryIndex))
+	{
+		return false;
+	}
+
+	_OutPosition = TargetPositions[_Target->RegistryIndex];
+	return true;
+}
+
+void ANWPTargetRegistry::RegisterTarget(class ANWPTarget* _Target)
+{
+	// Early return if invalid or already registered
+	if (!_Target || _Target->OwnerRegistry == this)
+	{
+		return;
+	}
+
+	_Target->RegistryIndex = Targets.Add(_Target);
+	_Target->OwnerRegistry = this;
+
+	TargetPositions.AddZeroed();
+	TargetBounds.AddZeroed();
+	RefreshTarget(_Target->RegistryIndex, true);
+
+	TargetGridCells.Add(GetGridCell(TargetPositions[_Target->RegistryIndex]));
+	AddToGridCell(TargetGridCells.Last(), _Target->RegistryIndex);
+
+	++ChangeCounter;
+}
+
+void ANWPTargetRegistry::UnregisterTarget(class ANWPTarget* _Target)
+{
+	// Early return if the target is not registered here
+	if (!_Target || _Target->OwnerRegistry != this || !Targets.IsValidIndex(_Target->RegistryIndex))
+	{
+		return;
+	}
+
+	checkf(Targets[_Target->RegistryIndex] == _Target, TEXT("ANWPTargetRegistry::UnregisterTarget: The registry index of %s is not valid"), *_Target->GetName());
+
+	// Swap the last target into the freed slot, so the arrays stay dense
+	const int32 Index = _Target->RegistryIndex;
+	const int32 LastIndex = Targets.Num() - 1;
+
+	RemoveFromGridCell(TargetGridCells[Index], Index);
+
+	if (Index != LastIndex)
+	{
+		RemoveFromGridCell(TargetGridCells[LastIndex], LastIndex);
+		AddToGridCell(TargetGridCells[LastIndex], Index);
+	}
+
+	Targets.RemoveAtSwap(Index, 1, false);
+	TargetPositions.RemoveAtSwap(Index, 1, false);
+	TargetBounds.RemoveAtSwap(Index, 1, false);
+	TargetGridCells.RemoveAtSwap(Index, 1, false);
+
+	if (Targets.IsValidIndex(Index))
+	{
+		Targets[Index]->RegistryIndex = Index;
+	}
+
+	_Target->RegistryIndex = INDEX_NONE;
+	_Target->OwnerRegistry = nullptr;
+
+	++ChangeCounter;
+}
+
+bool ANWPTargetRegistry::RefreshTarget(int32 _Index, bool _bForce)
+{
+	const ANWPTarget* Target = Targets[_Index];
+	const USceneComponent* TargetRoot = Target ? Target->GetRootComponent() : nullptr;
+
+	// Early return if the target has no transform
+	if (!TargetRoot)
+	{
+		return false;
+	}
+
+	const FVector NewPosition = TargetRoot->GetComponentLocation();
+
+	if (!_bForce && NewPosition.Equals(TargetPositions[_Index]))
+	{
+		return false;
+	}
+
+	TargetPositions[_Index] = NewPosition;
+	TargetBounds[_Index] = TargetRoot->Bounds;
+
+	// Move the target to its new cell. Not done while registering, the cell is added afterwards
+	if (TargetGridCells.IsValidIndex(_Index))
+	{
+		UpdateGridCell(_Index);
+	}
+
+	return true;
+}
+
+void ANWPTargetRegistry::QueryTargets(const struct FConvexVolume& _Frustum, const FBox& _FrustumBounds, TArray<int32>& _OutTargetIndices) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_NWPTargetRegistryQuery);
+
+	// Early return if nothing to query
+	if (GridCells.Num() == 0 || !_FrustumBounds.IsValid)
+	{
+		return;
+	}
+
+	const FIntVector MinCell = GetGridCell(_FrustumBounds.Min);
+	const FIntVector MaxCell = GetGridCell(_FrustumBounds.Max);
+	const int64 NumBoundsCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) * int64(MaxCell.Z - MinCell.Z + 1);
+
+	// Tests the targets of a cell if the cell touches the frustum
+	auto QueryCell = [this, &_Frustum, &_OutTargetIndices](const FIntVector& _Cell, const TArray<int32>& _CellTargets)
+	{
+		INC_DWORD_STAT(STAT_NWPTargetQueryVisitedCells);
+
+		const FVector CellExtent(GridCellSize * 0.5f);
+		const FVector CellOrigin = FVector(_Cell) * GridCellSize + CellExtent;
+
+		if (!_Frustum.IntersectBox(CellOrigin, CellExtent))
+		{
+			return;
+		}
+
+		INC_DWORD_STAT_BY(STAT_NWPTargetQueryTestedTargets, _CellTargets.Num());
+
+		for (int32 TargetIndex : _CellTargets)
+		{
+			if (_Frustum.IntersectSphere(TargetPositions[TargetIndex], 0.0f))
+			{
+				_OutTargetIndices.Add(TargetIndex);
+			}
+		}
+	};
+
+	// Visit the occupied cells if there are less of them than cells inside the bounds
+	if (NumBoundsCells > GridCells.Num())
+	{
+		for (const TPair<FIntVector, TArray<int32>>& GridCell : GridCells)
+		{
+			const FIntVector& Cell = GridCell.Key;
+
+			if (Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y && Cell.Z >= MinCell.Z && Cell.Z <= MaxCell.Z)
+			{
+				QueryCell(Cell, GridCell.Value);
+			}
+		}
+
+		return;
+	}
+
+	for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				const FIntVector Cell(X, Y, Z);
+				const TArray<int32>* CellTargets = GridCells.Find(Cell);
+
+				if (CellTargets)
+				{
+					QueryCell(Cell, *CellTargets);
+				}
+			}
+		}
+	}
+}
+
+FIntVector ANWPTargetRegistry::GetGridCell(const FVector& _Position) const
+{
+	return FIntVector(FMath::FloorToInt(_Position.X / GridCellSize), FMath::FloorToInt(_Position.Y / GridCellSize), FMath::FloorToInt(_Position.Z / GridCellSize));
+}
+
+void ANWPTargetRegistry::AddToGridCell(const FIntVector& _Cell, int32 _Index)
+{
+	GridCells.FindOrAdd(_Cell).Add(_Index);
+}
+
+void ANWPTargetRegistry::RemoveFromGridCell(const FIntVector& _Cell, int32 _Index)
+{
+	TArray<int32>* CellTargets = GridCells.Find(_Cell);
+
+	// Early return if the cell is empty
+	if (!CellTargets)
+	{
+		return;
+	}
+
+	CellTargets->RemoveSingleSwap(_Index, false);
+
+	// Forget the empty cells, so the queries only visit occupied cells
+	if (CellTargets->Num() == 0)
+	{
+		GridCells.Remove(_Cell);
+	}
+}
+
+void ANWPTargetRegistry::UpdateGridCell(int32 _Index)
+{
+	const FIntVector NewCell = GetGridCell(TargetPositions[_Index]);
+
+	// Early return if the target is still in the same cell
+	if (NewCell == TargetGridCells[_Index])
+	{
+		return;
+	}
+
+	RemoveFromGridCell(TargetGridCells[_Index], _Index);
+	AddToGridCell(NewCell, _Index);
+	TargetGridCells[_Index] = NewCell;
+}
+
+void ANWPTargetRegistry::RebuildGrid(float _CellSize)
+{
+	GridCellSize = _CellSize;
+	GridCells.Empty();
+
+	for (int32 Index = 0; Index < TargetGridCells.Num(); ++Index)
+	{
+		TargetGridCells[Index] = GetGridCell(TargetPositions[Index]);
+		AddToGridCell(TargetGridCells[Index], Index);
+	}
+}
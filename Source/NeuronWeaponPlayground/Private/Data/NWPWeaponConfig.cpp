@@ -1,131 +1,224 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPWeaponConfig.h"
-
-#include "NeuronWeaponPlayground.h"
-
-UNWPWeaponConfig::UNWPWeaponConfig(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
-{
-	CurrentLoadFinishedDelegate = nullptr;
-	bIsLoading = false;
-	CachedWeaponMesh = nullptr;
-	CachedMuzzleEffect = nullptr;
-	CachedShootSound = nullptr;
-	CachedShootingMontage = nullptr;
-	InitialAmmo = 30;
-	MaximumAmmo = 100;
-	AmmoPerMagazine = 30;
-	MagazineReloadTime = 0.5;
-	ShootDistance = 10000.0f;
-	bUseProjectileAsAmmo = false;
-	bUseEyesAsShootOrigin = true;
-	MuzzleSocketName = TEXT("");
-	EyesOffsetLocation = FVector::ZeroVector;
-	EyesOffsetRotation = FRotator::ZeroRotator;
-	MuzzleBoneOffsetLocation = FVector::ZeroVector;
-	MuzzleBoneOffsetRotation = FRotator::ZeroRotator;
-}
-
-ENWPWeaponCadenceType UNWPWeaponConfig::GetCadenceType() const
-{
-	// Check if the weapon is automatic or semi automatic
-	if (IsAutomatic())
-	{
-		return ENWPWeaponCadenceType::Automatic;
-	}
-	else if(IsSemiAutomatic())
-	{
-		return ENWPWeaponCadenceType::SemiAutomatic;
-	}
-
-	return ENWPWeaponCadenceType::COUNT;
-}
-
-void UNWPWeaponConfig::LoadWeaponConfig(bool bSyncLoad, const FNWPOnWaponConfigLoaded& _Callback)
-{
-	// Check if there is a load in progress
-	if (bIsLoading)
-	{
-		return;
-	}
-
-	// Bind callback if specified
-	if (_Callback.IsBound())
-	{
-		// Bind the function to the delegate
-		CurrentLoadFinishedDelegate = _Callback;
-	}
-
-	// Mark the loading flag
-	bIsLoading = true;
-
-	// Check if the load has to be synchronous
-	if (bSyncLoad)
-	{
-		// TODO: [NWP-REVIEW] This cache references load system does not scale well.
-
-		// Load weapon mesh
-		if (!WeaponMesh.IsNull())
-		{
-			CachedWeaponMesh = WeaponMesh.LoadSynchronous();
-		}
-
-		// Load effects
-		if (!MuzzleEffect.IsNull())
-		{
-			CachedMuzzleEffect = MuzzleEffect.LoadSynchronous();
-		}
-
-		// Load sounds
-		if (!ShootSound.IsNull())
-		{
-			CachedShootSound = ShootSound.LoadSynchronous();
-		}
-
-		// Load montages
-		if (!ShootMontage.IsNull())
-		{
-			CachedShootingMontage = ShootMontage.LoadSynchronous();
-		}
-
-		// Finish the weapon load
-		FinishWeaponConfigLoad();
-	}
-	else
-	{
-		// TODO: [NWP-REVIEW] Implement weapon config async load
-		UE_LOG(LogNWP, Warning, TEXT("UNWPWeaponConfig::LoadWeaponConfig: WeaponConfig async load yet unimplemented"));
-	}
-}
-
-void UNWPWeaponConfig::ReleaseWeaponConfig()
-{
-	// Release the hard references
-	CachedWeaponMesh = nullptr;
-	CachedShootingMontage = nullptr;
-}
-
-void UNWPWeaponConfig::FinishWeaponConfigLoad()
-{
-	// Return if not loading
-	if (!bIsLoading)
-	{
-		return;
-	}
-
-	// Cache the loaded assets
-	if (WeaponMesh)
-	{
-		CachedWeaponMesh = WeaponMesh.Get();
-	}
-
-	// Reset load mark
-	bIsLoading = false;
-
-	// Execute callback
-	if (CurrentLoadFinishedDelegate.IsBound())
-	{
-		CurrentLoadFinishedDelegate.ExecuteIfBound();
-		CurrentLoadFinishedDelegate = nullptr;
-	}
-}
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeaponConfig.h"
+
+// UE
+#include "Engine/AssetManager.h"
+#include "HAL/PlatformTime.h"
+
+#include "NeuronWeaponPlayground.h"
+
+// Latency of the last load of each weapon config class
+static TMap<FName, float> WeaponConfigLoadLatencies;
+
+// Console commands
+static FAutoConsoleCommand DumpWeaponConfigLoadLatenciesCommand(
+	TEXT("NWP.DumpWeaponConfigLoadLatencies"),
+	TEXT("Writes the latency of the last load of each weapon config class to the log."),
+	FConsoleCommandDelegate::CreateStatic(&UNWPWeaponConfig::LogLoadLatencies));
+
+UNWPWeaponConfig::UNWPWeaponConfig(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	bIsLoading = false;
+	bIsLoaded = false;
+	LoadStartTime = 0.0;
+	LastLoadLatency = 0.0f;
+	CachedWeaponMesh = nullptr;
+	CachedMuzzleEffect = nullptr;
+	CachedShootSound = nullptr;
+	CachedShootingMontage = nullptr;
+	CachedSimulatedProjectileMesh = nullptr;
+	bAccumulateSubFrameShots = false;
+	InitialAmmo = 30;
+	MaximumAmmo = 100;
+	AmmoPerMagazine = 30;
+	MagazineReloadTime = 0.5;
+	ProjectilePoolPrewarmSize = 16;
+	ShootDistance = 10000.0f;
+	bUseProjectileAsAmmo = false;
+	bUseSimulatedProjectiles = false;
+	bUseAsyncHitscan = false;
+	HitscanTraceQuality = ENWPTraceQuality::Complex;
+	bUseEyesAsShootOrigin = true;
+	MuzzleSocketName = TEXT("");
+	EyesOffsetLocation = FVector::ZeroVector;
+	EyesOffsetRotation = FRotator::ZeroRotator;
+	MuzzleBoneOffsetLocation = FVector::ZeroVector;
+	MuzzleBoneOffsetRotation = FRotator::ZeroRotator;
+}
+
+ENWPWeaponCadenceType UNWPWeaponConfig::GetCadenceType() const
+{
+	// Check if the weapon is automatic or semi automatic
+	if (IsAutomatic())
+	{
+		return ENWPWeaponCadenceType::Automatic;
+	}
+	else if(IsSemiAutomatic())
+	{
+		return ENWPWeaponCadenceType::SemiAutomatic;
+	}
+
+	return ENWPWeaponCadenceType::COUNT;
+}
+
+void UNWPWeaponConfig::LoadWeaponConfig(bool bSyncLoad, const FNWPOnWaponConfigLoaded& _Callback, TAsyncLoadPriority _Priority)
+{
+	// Execute the callback immediately if already loaded
+	if (bIsLoaded)
+	{
+		_Callback.ExecuteIfBound();
+		return;
+	}
+
+	// Add the callback to the listeners of the load
+	if (_Callback.IsBound())
+	{
+		PendingLoadFinishedDelegates.Add(_Callback);
+	}
+
+	// Check if there is a load in progress. The new listener is told when it finishes
+	if (bIsLoading)
+	{
+		return;
+	}
+
+	// Mark the loading flag
+	bIsLoading = true;
+	LoadStartTime = FPlatformTime::Seconds();
+
+	TArray<FSoftObjectPath> AssetsToLoad;
+	GetAssetsToLoad(AssetsToLoad);
+
+	// Finish the load if there is nothing to load
+	if (AssetsToLoad.Num() == 0)
+	{
+		FinishWeaponConfigLoad();
+		return;
+	}
+
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+
+	// Check if the load has to be synchronous
+	if (bSyncLoad)
+	{
+		LoadHandle = StreamableManager.RequestSyncLoad(AssetsToLoad);
+		FinishWeaponConfigLoad();
+	}
+	else
+	{
+		LoadHandle = StreamableManager.RequestAsyncLoad(AssetsToLoad, FStreamableDelegate::CreateUObject(this, &UNWPWeaponConfig::OnAsyncLoadCompleted), _Priority);
+
+		// The handle is not valid if the request failed, so the load is finished with the assets that could be resolved
+		if (!LoadHandle.IsValid())
+		{
+			FinishWeaponConfigLoad();
+		}
+	}
+}
+
+void UNWPWeaponConfig::ReleaseWeaponConfig()
+{
+	// Stop the load in progress or release the loaded assets
+	if (LoadHandle.IsValid())
+	{
+		if (LoadHandle->IsLoadingInProgress())
+		{
+			LoadHandle->CancelHandle();
+		}
+		else
+		{
+			LoadHandle->ReleaseHandle();
+		}
+
+		LoadHandle.Reset();
+	}
+
+	// Forget the listeners of the load in progress
+	PendingLoadFinishedDelegates.Empty();
+	bIsLoading = false;
+	bIsLoaded = false;
+
+	// Release the hard references
+	CachedWeaponMesh = nullptr;
+	CachedMuzzleEffect = nullptr;
+	CachedShootSound = nullptr;
+	CachedShootingMontage = nullptr;
+	CachedSimulatedProjectileMesh = nullptr;
+}
+
+void UNWPWeaponConfig::RemoveLoadFinishedCallbacks(const UObject* _Listener)
+{
+	PendingLoadFinishedDelegates.RemoveAll([_Listener](const FNWPOnWaponConfigLoaded& LoadFinishedDelegate)
+	{
+		return LoadFinishedDelegate.IsBoundToObject(_Listener);
+	});
+}
+
+void UNWPWeaponConfig::LogLoadLatencies()
+{
+	for (const TPair<FName, float>& LoadLatency : WeaponConfigLoadLatencies)
+	{
+		UE_LOG(LogNWP, Log, TEXT("Weapon config %s: Last load latency: %.2f ms"), *LoadLatency.Key.ToString(), LoadLatency.Value * 1000.0f);
+	}
+}
+
+void UNWPWeaponConfig::GetAssetsToLoad(TArray<FSoftObjectPath>& _OutAssetsToLoad) const
+{
+	const FSoftObjectPath AssetsToLoad[] = 
+	{ 
+		WeaponMesh.ToSoftObjectPath(), 
+		MuzzleEffect.ToSoftObjectPath(), 
+		ShootSound.ToSoftObjectPath(), 
+		ShootMontage.ToSoftObjectPath(), 
+		SimulatedProjectileMesh.ToSoftObjectPath() 
+	};
+
+	for (const FSoftObjectPath& AssetToLoad : AssetsToLoad)
+	{
+		if (!AssetToLoad.IsNull())
+		{
+			_OutAssetsToLoad.AddUnique(AssetToLoad);
+		}
+	}
+}
+
+void UNWPWeaponConfig::OnAsyncLoadCompleted()
+{
+	FinishWeaponConfigLoad();
+}
+
+void UNWPWeaponConfig::FinishWeaponConfigLoad()
+{
+	// Return if not loading
+	if (!bIsLoading)
+	{
+		return;
+	}
+
+	// Cache the loaded assets. The handle keeps them resident
+	CachedWeaponMesh = WeaponMesh.Get();
+	CachedMuzzleEffect = MuzzleEffect.Get();
+	CachedShootSound = ShootSound.Get();
+	CachedShootingMontage = ShootMontage.Get();
+	CachedSimulatedProjectileMesh = SimulatedProjectileMesh.Get();
+
+	// Record the load latency
+	LastLoadLatency = FPlatformTime::Seconds() - LoadStartTime;
+	WeaponConfigLoadLatencies.Add(GetClass()->GetFName(), LastLoadLatency);
+
+	UE_LOG(LogNWP, Log, TEXT("UNWPWeaponConfig::FinishWeaponConfigLoad: %s loaded in %.2f ms"), *GetClass()->GetName(), LastLoadLatency * 1000.0f);
+
+	// Reset load mark
+	bIsLoading = false;
+	bIsLoaded = true;
+
+	// Execute the callbacks. The listeners are moved first, as a callback may request a new load
+	TArray<FNWPOnWaponConfigLoaded> LoadFinishedDelegates = MoveTemp(PendingLoadFinishedDelegates);
+	PendingLoadFinishedDelegates.Reset();
+
+	for (const FNWPOnWaponConfigLoaded& LoadFinishedDelegate : LoadFinishedDelegates)
+	{
+		LoadFinishedDelegate.ExecuteIfBound();
+	}
+}
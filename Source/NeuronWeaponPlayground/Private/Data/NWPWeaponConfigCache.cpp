@@ -0,0 +1,156 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeaponConfigCache.h"
+
+// UE
+#include "Engine/World.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+#include "NWPUtils.h"
+
+// Stats
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Shared Weapon Configs"), STAT_NWPSharedWeaponConfigs, STATGROUP_NWP);
+
+// Console commands
+static FAutoConsoleCommandWithWorld DumpSharedWeaponConfigsCommand(
+	TEXT("NWP.DumpSharedWeaponConfigs"),
+	TEXT("Writes the shared weapon configs & their reference count to the log."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		ANWPWeaponConfigCache* WeaponConfigCache = ANWPWeaponConfigCache::GetWeaponConfigCache(World, false);
+
+		if (WeaponConfigCache)
+		{
+			WeaponConfigCache->LogSharedWeaponConfigs();
+		}
+	}));
+
+ANWPWeaponConfigCache::ANWPWeaponConfigCache(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+void ANWPWeaponConfigCache::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Release the assets of every shared weapon config, the weapons can not release them anymore
+	for (TPair<UClass*, FNWPSharedWeaponConfig>& SharedWeaponConfig : SharedWeaponConfigs)
+	{
+		if (SharedWeaponConfig.Value.WeaponConfig)
+		{
+			SharedWeaponConfig.Value.WeaponConfig->ReleaseWeaponConfig();
+		}
+	}
+
+	SharedWeaponConfigs.Empty();
+
+	SET_DWORD_STAT(STAT_NWPSharedWeaponConfigs, 0);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+ANWPWeaponConfigCache* ANWPWeaponConfigCache::GetWeaponConfigCache(UWorld* World, bool _bSpawnIfMissing)
+{
+	return UNWPUtils::GetWorldManager<ANWPWeaponConfigCache>(World, _bSpawnIfMissing);
+}
+
+int32 ANWPWeaponConfigCache::GetReferenceCount(const UNWPWeaponConfig* _WeaponConfig) const
+{
+	// Early return if invalid weapon config
+	if (!_WeaponConfig)
+	{
+		return 0;
+	}
+
+	const FNWPSharedWeaponConfig* SharedWeaponConfig = SharedWeaponConfigs.Find(_WeaponConfig->GetClass());
+
+	return SharedWeaponConfig && SharedWeaponConfig->WeaponConfig == _WeaponConfig ? SharedWeaponConfig->ReferenceCount : 0;
+}
+
+const UNWPWeaponConfig* ANWPWeaponConfigCache::AcquireWeaponConfig(TSubclassOf<UNWPWeaponConfig> _WeaponConfigClass)
+{
+	// Early return if invalid class
+	if (!_WeaponConfigClass)
+	{
+		return nullptr;
+	}
+
+	// Create the shared weapon config the first time the class is requested
+	FNWPSharedWeaponConfig& SharedWeaponConfig = SharedWeaponConfigs.FindOrAdd(_WeaponConfigClass.Get());
+
+	if (!SharedWeaponConfig.WeaponConfig)
+	{
+		SharedWeaponConfig.WeaponConfig = NewObject<UNWPWeaponConfig>(this, _WeaponConfigClass);
+		SharedWeaponConfig.ReferenceCount = 0;
+
+		SET_DWORD_STAT(STAT_NWPSharedWeaponConfigs, SharedWeaponConfigs.Num());
+	}
+
+	++SharedWeaponConfig.ReferenceCount;
+
+	return SharedWeaponConfig.WeaponConfig;
+}
+
+void ANWPWeaponConfigCache::LoadWeaponConfig(const UNWPWeaponConfig* _WeaponConfig, bool _bSyncLoad, const FNWPOnWaponConfigLoaded& _Callback, 
+	TAsyncLoadPriority _Priority)
+{
+	FNWPSharedWeaponConfig* SharedWeaponConfig = FindSharedWeaponConfig(_WeaponConfig);
+
+	// Early return if the weapon config is not shared by this cache
+	if (!SharedWeaponConfig)
+	{
+		return;
+	}
+
+	SharedWeaponConfig->WeaponConfig->LoadWeaponConfig(_bSyncLoad, _Callback, _Priority);
+}
+
+void ANWPWeaponConfigCache::ReleaseWeaponConfig(const UNWPWeaponConfig* _WeaponConfig, const UObject* _Listener)
+{
+	FNWPSharedWeaponConfig* SharedWeaponConfig = FindSharedWeaponConfig(_WeaponConfig);
+
+	// Early return if the weapon config is not shared by this cache
+	if (!SharedWeaponConfig)
+	{
+		return;
+	}
+
+	// The listener is not told about a load that finishes after the release
+	if (_Listener)
+	{
+		SharedWeaponConfig->WeaponConfig->RemoveLoadFinishedCallbacks(_Listener);
+	}
+
+	// Release the assets when the last weapon goes away
+	if (--SharedWeaponConfig->ReferenceCount <= 0)
+	{
+		SharedWeaponConfig->WeaponConfig->ReleaseWeaponConfig();
+		SharedWeaponConfigs.Remove(_WeaponConfig->GetClass());
+
+		SET_DWORD_STAT(STAT_NWPSharedWeaponConfigs, SharedWeaponConfigs.Num());
+	}
+}
+
+FNWPSharedWeaponConfig* ANWPWeaponConfigCache::FindSharedWeaponConfig(const UNWPWeaponConfig* _WeaponConfig)
+{
+	// Early return if invalid weapon config
+	if (!_WeaponConfig)
+	{
+		return nullptr;
+	}
+
+	FNWPSharedWeaponConfig* SharedWeaponConfig = SharedWeaponConfigs.Find(_WeaponConfig->GetClass());
+
+	return SharedWeaponConfig && SharedWeaponConfig->WeaponConfig == _WeaponConfig ? SharedWeaponConfig : nullptr;
+}
+
+void ANWPWeaponConfigCache::LogSharedWeaponConfigs() const
+{
+	for (const TPair<UClass*, FNWPSharedWeaponConfig>& SharedWeaponConfig : SharedWeaponConfigs)
+	{
+		const UNWPWeaponConfig* WeaponConfig = SharedWeaponConfig.Value.WeaponConfig;
+
+		UE_LOG(LogNWP, Log, TEXT("Weapon config %s: References: %d, Loaded: %d"), *GetNameSafe(SharedWeaponConfig.Key), 
+			SharedWeaponConfig.Value.ReferenceCount, WeaponConfig && WeaponConfig->IsLoaded() ? 1 : 0);
+	}
+}
@@ -1,112 +1,267 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPProjectile.h"
-
-// UE
-#include "Components/SphereComponent.h"
-#include "Particles/ParticleSystemComponent.h"
-#include "Kismet/GameplayStatics.h"
-
-// NWP
-#include "NWPWeapon.h"
-#include "NWPProjectileMovementComponent.h"
-
-ANWPProjectile::ANWPProjectile(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
-{
-	// Use a sphere as a simple collision representation
-	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
-	CollisionComp->InitSphereRadius(5.0f);
-	CollisionComp->BodyInstance.SetCollisionProfileName("Projectile");
-	CollisionComp->OnComponentHit.AddDynamic(this, &ANWPProjectile::OnHit);		// set up a notification for when this component hits something blocking
-
-	// Players can't walk on it
-	CollisionComp->SetWalkableSlopeOverride(FWalkableSlopeOverride(WalkableSlope_Unwalkable, 0.f));
-	CollisionComp->CanCharacterStepUpOn = ECB_No;
-
-	// Set as root component
-	RootComponent = CollisionComp;
-
-	// Use a ProjectileMovementComponent to govern this projectile's movement
-	ProjectileMovement = CreateDefaultSubobject<UNWPProjectileMovementComponent>(TEXT("ProjectileMovement"));
-	ProjectileMovement->UpdatedComponent = CollisionComp;
-	ProjectileMovement->InitialSpeed = 3000.f;
-	ProjectileMovement->MaxSpeed = 3000.f;
-	ProjectileMovement->bRotationFollowsVelocity = true;
-	ProjectileMovement->bShouldBounce = true;
-
-	// Die after 3 seconds by default
-	InitialLifeSpan = 3.0f;
-
-	// Initialize some values
-	TracerComponent = nullptr;
-	ImpulseStrenghtFactor = 10.0f;
-}
-
-void ANWPProjectile::BeginPlay()
-{
-	Super::BeginPlay();
-
-	// Try to spawn the tracer effect
-	if (TracerEffect)
-	{
-		TracerComponent = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), TracerEffect, GetActorTransform());
-
-		if (TracerComponent)
-		{
-			TracerComponent->AttachToComponent(CollisionComp, FAttachmentTransformRules::SnapToTargetIncludingScale);
-			TracerComponent->SetAbsolute(false, false, false);
-		}
-	}
-}
-
-void ANWPProjectile::SetOwnerWeapon(class ANWPWeapon* _NewOwnerWeapon)
-{
-	OwnerWeapon = _NewOwnerWeapon;
-}
-
-void ANWPProjectile::OnHit(class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
-{
-	UE_LOG(LogNWP, Log, TEXT("Projectile %s has hit: HitActor: %s HitComponent: %s "), *this->GetName(), *OtherActor->GetName(), *OtherComp->GetName());
-
-	// Tell the weapon that the projectile has hit something
-	if (OwnerWeapon)
-	{
-		OwnerWeapon->OnProjectileHit(this, HitComp, OtherActor, OtherComp, NormalImpulse, Hit);
-	}
-
-	// Only add impulse and destroy projectile if we hit a physics
-	if ((OtherActor != NULL) && (OtherActor != this) && (OtherComp != NULL) && OtherComp->IsSimulatingPhysics())
-	{
-		OtherComp->AddImpulseAtLocation(GetVelocity() * ImpulseStrenghtFactor, GetActorLocation());
-	}
-
-	// Tell the weapon owner that the projectile is going to be destroyed
-	if (OwnerWeapon)
-	{
-		OwnerWeapon->OnProjectileIsGoingToBeDestroyed(this);
-	}
-
-	// Deactivate tracer component
-	if (TracerComponent)
-	{
-		TracerComponent->DestroyComponent(true);
-	}
-
-	// Try to spawn the hit effect
-	if (ImpactEffect)
-	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactEffect, Hit.ImpactPoint, Hit.Normal.Rotation());
-	}
-
-	// Destroy the projectile
-	Destroy();
-}
-
-void ANWPProjectile::OnProjectileVelocityComputed(FVector& _ComputedVelocity, float DeltaTime)
-{
-	// Tell the weapon that the velocity has been computed
-	if (OwnerWeapon)
-	{
-		OwnerWeapon->OnProjectileVelocityComputed(this, _ComputedVelocity, DeltaTime);
-	}
-}
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPProjectile.h"
+
+// UE
+#include "Components/SphereComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+
+// NWP
+#include "NWPWeapon.h"
+#include "NWPProjectileMovementComponent.h"
+#include "NWPProjectilePool.h"
+
+ANWPProjectile::ANWPProjectile(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// Use a sphere as a simple collision representation
+	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
+	CollisionComp->InitSphereRadius(5.0f);
+	CollisionComp->BodyInstance.SetCollisionProfileName("Projectile");
+	CollisionComp->OnComponentHit.AddDynamic(this, &ANWPProjectile::OnHit);		// set up a notification for when this component hits something blocking
+
+	// Players can't walk on it
+	CollisionComp->SetWalkableSlopeOverride(FWalkableSlopeOverride(WalkableSlope_Unwalkable, 0.f));
+	CollisionComp->CanCharacterStepUpOn = ECB_No;
+
+	// Set as root component
+	RootComponent = CollisionComp;
+
+	// Use a ProjectileMovementComponent to govern this projectile's movement
+	ProjectileMovement = CreateDefaultSubobject<UNWPProjectileMovementComponent>(TEXT("ProjectileMovement"));
+	ProjectileMovement->UpdatedComponent = CollisionComp;
+	ProjectileMovement->InitialSpeed = 3000.f;
+	ProjectileMovement->MaxSpeed = 3000.f;
+	ProjectileMovement->bRotationFollowsVelocity = true;
+	ProjectileMovement->bShouldBounce = true;
+
+	// Die after 3 seconds by default
+	InitialLifeSpan = 3.0f;
+
+	// Initialize some values
+	TracerComponent = nullptr;
+	ImpulseStrenghtFactor = 10.0f;
+	OwnerWeapon = nullptr;
+	OwnerPool = nullptr;
+	bIsInPool = false;
+}
+
+void ANWPProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Pooled projectiles start disabled, the tracer is spawned when they are acquired
+	if (IsPooled())
+	{
+		return;
+	}
+
+	// Try to spawn the tracer effect
+	ActivateTracer();
+}
+
+void ANWPProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Every way of destroying the projectile ends here: the lifespan, a hit or the level being removed
+	NotifyOwnerWeaponProjectileFinished();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANWPProjectile::LifeSpanExpired()
+{
+	// Return the projectile to the pool instead of destroying it
+	if (IsPooled())
+	{
+		// Tell the weapon owner that the projectile is going to be released
+		NotifyOwnerWeaponProjectileFinished();
+
+		FinishProjectile();
+		return;
+	}
+
+	// The weapon owner is told in EndPlay
+	Super::LifeSpanExpired();
+}
+
+float ANWPProjectile::GetCollisionRadius() const
+{
+	return CollisionComp->GetUnscaledSphereRadius();
+}
+
+void ANWPProjectile::SetOwnerWeapon(class ANWPWeapon* _NewOwnerWeapon)
+{
+	OwnerWeapon = _NewOwnerWeapon;
+	OwnerWeaponHandle.Reset();
+}
+
+void ANWPProjectile::AdvanceSimulation(float _DeltaTime)
+{
+	// Early return if nothing to simulate
+	if (_DeltaTime <= 0.0f || !ProjectileMovement->IsActive())
+	{
+		return;
+	}
+
+	// Tick the movement manually, so the collisions are also evaluated
+	ProjectileMovement->TickComponent(_DeltaTime, LEVELTICK_All, nullptr);
+}
+
+void ANWPProjectile::OnHit(class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	UE_LOG(LogNWP, Log, TEXT("Projectile %s has hit: HitActor: %s HitComponent: %s "), *this->GetName(), *OtherActor->GetName(), *OtherComp->GetName());
+
+	// Tell the weapon that the projectile has hit something
+	if (OwnerWeapon)
+	{
+		OwnerWeapon->OnProjectileHit(this, HitComp, OtherActor, OtherComp, NormalImpulse, Hit);
+	}
+
+	// Only add impulse and destroy projectile if we hit a physics
+	if ((OtherActor != NULL) && (OtherActor != this) && (OtherComp != NULL) && OtherComp->IsSimulatingPhysics())
+	{
+		OtherComp->AddImpulseAtLocation(GetVelocity() * ImpulseStrenghtFactor, GetActorLocation());
+	}
+
+	// Tell the weapon owner that the projectile is going to be destroyed
+	NotifyOwnerWeaponProjectileFinished();
+
+	// Deactivate tracer component
+	DeactivateTracer();
+
+	// Try to spawn the hit effect
+	if (ImpactEffect)
+	{
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactEffect, Hit.ImpactPoint, Hit.Normal.Rotation());
+	}
+
+	// Release or destroy the projectile
+	FinishProjectile();
+}
+
+void ANWPProjectile::OnProjectileVelocityComputed(FVector& _ComputedVelocity, float DeltaTime)
+{
+	// Tell the weapon that the velocity has been computed
+	if (OwnerWeapon)
+	{
+		OwnerWeapon->OnProjectileVelocityComputed(this, _ComputedVelocity, DeltaTime);
+	}
+}
+
+void ANWPProjectile::FinishProjectile()
+{
+	// Return the projectile to the pool if possible
+	if (IsPooled())
+	{
+		OwnerPool->ReleaseProjectile(this);
+		return;
+	}
+
+	// Destroy the projectile
+	Destroy();
+}
+
+void ANWPProjectile::NotifyOwnerWeaponProjectileFinished()
+{
+	// Early return if already told or no owner
+	if (!OwnerWeapon)
+	{
+		return;
+	}
+
+	ANWPWeapon* WeaponToNotify = OwnerWeapon;
+	OwnerWeapon = nullptr;
+
+	WeaponToNotify->OnProjectileIsGoingToBeDestroyed(this);
+	OwnerWeaponHandle.Reset();
+}
+
+void ANWPProjectile::ActivateTracer()
+{
+	// Early return if no tracer configured
+	if (!TracerEffect)
+	{
+		return;
+	}
+
+	// Restart the tracer if it was already spawned (pooled projectiles keep their tracer)
+	if (TracerComponent)
+	{
+		TracerComponent->ActivateSystem(true);
+		return;
+	}
+
+	// Pooled projectiles reuse the tracer, so it must not be destroyed automatically
+	TracerComponent = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), TracerEffect, GetActorTransform(), !IsPooled());
+
+	if (TracerComponent)
+	{
+		TracerComponent->AttachToComponent(CollisionComp, FAttachmentTransformRules::SnapToTargetIncludingScale);
+		TracerComponent->SetAbsolute(false, false, false);
+	}
+}
+
+void ANWPProjectile::DeactivateTracer()
+{
+	// Early return if no tracer spawned
+	if (!TracerComponent)
+	{
+		return;
+	}
+
+	// Keep the tracer for the next use if pooled
+	if (IsPooled())
+	{
+		TracerComponent->DeactivateSystem();
+		TracerComponent->KillParticlesForced();
+		return;
+	}
+
+	TracerComponent->DestroyComponent(true);
+	TracerComponent = nullptr;
+}
+
+void ANWPProjectile::SetOwnerPool(class ANWPProjectilePool* _NewOwnerPool)
+{
+	OwnerPool = _NewOwnerPool;
+}
+
+void ANWPProjectile::OnAcquiredFromPool(const FVector& _Location, const FRotator& _Rotation)
+{
+	// Place the projectile
+	SetActorLocationAndRotation(_Location, _Rotation, false, nullptr, ETeleportType::ResetPhysics);
+
+	// Enable the projectile
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// Restart the movement using the new orientation
+	ProjectileMovement->ResetMovement(_Rotation.Vector());
+
+	// Restart the lifespan. SetLifeSpan overwrites InitialLifeSpan, so the class default is used
+	SetLifeSpan(GetClass()->GetDefaultObject<ANWPProjectile>()->InitialLifeSpan);
+
+	// Restart the tracer
+	ActivateTracer();
+}
+
+void ANWPProjectile::OnReleasedToPool()
+{
+	// Stop the lifespan timer
+	SetLifeSpan(0.0f);
+
+	// Stop the movement
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	// Stop the tracer
+	DeactivateTracer();
+
+	// Disable the projectile
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// Forget the owner weapon
+	OwnerWeapon = nullptr;
+	OwnerWeaponHandle.Reset();
+}
@@ -1,20 +1,36 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPProjectileMovementComponent.h"
-
-// NWP
-#include "NWPProjectile.h"
-
-FVector UNWPProjectileMovementComponent::ComputeVelocity(FVector InitialVelocity, float DeltaTime) const
-{
-	FVector ComputedVelocity = Super::ComputeVelocity(InitialVelocity, DeltaTime);
-
-	// Tell the projectile that the velocity has been computed
-	ANWPProjectile* Projectile = Cast<ANWPProjectile>(GetOwner());
-	if (Projectile)
-	{
-		Projectile->OnProjectileVelocityComputed(ComputedVelocity, DeltaTime);
-	}
-
-	return ComputedVelocity;
-}
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPProjectileMovementComponent.h"
+
+// NWP
+#include "NWPProjectile.h"
+
+FVector UNWPProjectileMovementComponent::ComputeVelocity(FVector InitialVelocity, float DeltaTime) const
+{
+	FVector ComputedVelocity = Super::ComputeVelocity(InitialVelocity, DeltaTime);
+
+	// Tell the projectile that the velocity has been computed
+	ANWPProjectile* Projectile = Cast<ANWPProjectile>(GetOwner());
+	if (Projectile)
+	{
+		Projectile->OnProjectileVelocityComputed(ComputedVelocity, DeltaTime);
+	}
+
+	return ComputedVelocity;
+}
+
+void UNWPProjectileMovementComponent::ResetMovement(const FVector& _Direction)
+{
+	// Restore the updated component if the simulation was stopped
+	if (!UpdatedComponent && GetOwner())
+	{
+		SetUpdatedComponent(GetOwner()->GetRootComponent());
+	}
+
+	// Set the velocity using the new direction
+	Velocity = _Direction.GetSafeNormal() * InitialSpeed;
+	UpdateComponentVelocity();
+
+	// Restart the simulation
+	Activate(true);
+}
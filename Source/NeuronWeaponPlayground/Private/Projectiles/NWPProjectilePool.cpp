@@ -0,0 +1,240 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPProjectilePool.h"
+
+// UE
+#include "Engine/World.h"
+
+// NWP
+#include "NWPWeapon.h"
+#include "NWPUtils.h"
+
+// Stats
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Hits"), STAT_NWPProjectilePoolHits, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Misses"), STAT_NWPProjectilePoolMisses, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Active"), STAT_NWPProjectilePoolActive, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool High Water"), STAT_NWPProjectilePoolHighWater, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Size"), STAT_NWPProjectilePoolSize, STATGROUP_NWP);
+
+// Console commands
+static FAutoConsoleCommandWithWorld DumpProjectilePoolStatsCommand(
+	TEXT("NWP.DumpProjectilePoolStats"),
+	TEXT("Writes the statistics of the projectile pools of the world to the log."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		ANWPProjectilePool* ProjectilePool = UNWPUtils::GetWorldManager<ANWPProjectilePool>(World, false);
+
+		if (ProjectilePool)
+		{
+			ProjectilePool->LogPoolStats();
+		}
+	}));
+
+ANWPProjectilePool::ANWPProjectilePool(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	HighWater = 0;
+}
+
+void ANWPProjectilePool::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Report how the pools have been used
+	LogPoolStats();
+
+	ProjectilePools.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+ANWPProjectilePool* ANWPProjectilePool::GetProjectilePool(UWorld* World)
+{
+	return UNWPUtils::GetWorldManager<ANWPProjectilePool>(World);
+}
+
+const FNWPProjectilePoolStats* ANWPProjectilePool::GetPoolStats(TSubclassOf<ANWPProjectile> _ProjectileClass) const
+{
+	const FNWPProjectilePoolEntry* PoolEntry = ProjectilePools.Find(_ProjectileClass.Get());
+	return PoolEntry ? &PoolEntry->Stats : nullptr;
+}
+
+void ANWPProjectilePool::PrewarmProjectiles(TSubclassOf<ANWPProjectile> _ProjectileClass, int32 _Count)
+{
+	// Early return if invalid class
+	if (!_ProjectileClass.Get())
+	{
+		return;
+	}
+
+	FNWPProjectilePoolEntry& PoolEntry = ProjectilePools.FindOrAdd(_ProjectileClass.Get());
+
+	// Spawn the projectiles that are missing
+	while (PoolEntry.Stats.PooledProjectiles < _Count)
+	{
+		ANWPProjectile* SpawnedProjectile = SpawnPooledProjectile(_ProjectileClass);
+
+		if (!SpawnedProjectile)
+		{
+			break;
+		}
+
+		PoolEntry.AvailableProjectiles.Add(SpawnedProjectile);
+		++PoolEntry.Stats.PooledProjectiles;
+	}
+
+	UpdateGlobalStats();
+}
+
+ANWPProjectile* ANWPProjectilePool::AcquireProjectile(TSubclassOf<ANWPProjectile> _ProjectileClass, const FVector& _Location, const FRotator& _Rotation, class ANWPWeapon* _OwnerWeapon)
+{
+	// Early return if invalid class
+	if (!_ProjectileClass.Get())
+	{
+		return nullptr;
+	}
+
+	// Apply the same collision handling than the projectiles spawned with AdjustIfPossibleButDontSpawnIfColliding
+	FVector AcquireLocation = _Location;
+	UWorld* World = GetWorld();
+
+	// Early return if the location is rejected, before the pool is touched as a new spawn would have been rejected too
+	if (World && !World->FindTeleportSpot(_ProjectileClass->GetDefaultObject<ANWPProjectile>(), AcquireLocation, _Rotation))
+	{
+		return nullptr;
+	}
+
+	FNWPProjectilePoolEntry& PoolEntry = ProjectilePools.FindOrAdd(_ProjectileClass.Get());
+	ANWPProjectile* AcquiredProjectile = nullptr;
+
+	// Take the last available projectile (skipping the ones destroyed externally)
+	while (!AcquiredProjectile && PoolEntry.AvailableProjectiles.Num() > 0)
+	{
+		AcquiredProjectile = PoolEntry.AvailableProjectiles.Pop(false);
+
+		if (!IsValid(AcquiredProjectile))
+		{
+			AcquiredProjectile = nullptr;
+			--PoolEntry.Stats.PooledProjectiles;
+		}
+	}
+
+	// Evaluate if the pool has been able to serve the projectile
+	if (AcquiredProjectile)
+	{
+		++PoolEntry.Stats.Hits;
+	}
+	else
+	{
+		++PoolEntry.Stats.Misses;
+
+		AcquiredProjectile = SpawnPooledProjectile(_ProjectileClass);
+
+		if (!AcquiredProjectile)
+		{
+			return nullptr;
+		}
+
+		++PoolEntry.Stats.PooledProjectiles;
+	}
+
+	// Update the usage stats
+	++PoolEntry.Stats.ActiveProjectiles;
+	PoolEntry.Stats.HighWater = FMath::Max(PoolEntry.Stats.HighWater, PoolEntry.Stats.ActiveProjectiles);
+	UpdateGlobalStats();
+
+	// Enable the projectile
+	AcquiredProjectile->bIsInPool = false;
+	AcquiredProjectile->SetOwnerWeapon(_OwnerWeapon);
+	AcquiredProjectile->OnAcquiredFromPool(AcquireLocation, _Rotation);
+
+	return AcquiredProjectile;
+}
+
+void ANWPProjectilePool::ReleaseProjectile(ANWPProjectile* _ProjectileToRelease)
+{
+	// Early return if the projectile does not belong to this pool or it has already been released
+	if (!_ProjectileToRelease || _ProjectileToRelease->OwnerPool != this || _ProjectileToRelease->bIsInPool)
+	{
+		return;
+	}
+
+	// Disable the projectile
+	_ProjectileToRelease->OnReleasedToPool();
+	_ProjectileToRelease->bIsInPool = true;
+
+	// Make the projectile available again
+	FNWPProjectilePoolEntry& PoolEntry = ProjectilePools.FindOrAdd(_ProjectileToRelease->GetClass());
+	PoolEntry.AvailableProjectiles.Add(_ProjectileToRelease);
+	PoolEntry.Stats.ActiveProjectiles = FMath::Max(0, PoolEntry.Stats.ActiveProjectiles - 1);
+
+	UpdateGlobalStats();
+}
+
+void ANWPProjectilePool::LogPoolStats() const
+{
+	for (auto It = ProjectilePools.CreateConstIterator(); It; ++It)
+	{
+		const FNWPProjectilePoolStats& Stats = It.Value().Stats;
+		const int32 Acquisitions = Stats.Hits + Stats.Misses;
+
+		UE_LOG(LogNWP, Log, TEXT("Projectile pool %s: Hits: %d Misses: %d HitRate: %.1f%% Active: %d HighWater: %d Pooled: %d"),
+			*GetNameSafe(It.Key()), Stats.Hits, Stats.Misses, Acquisitions > 0 ? 100.0f * Stats.Hits / Acquisitions : 0.0f,
+			Stats.ActiveProjectiles, Stats.HighWater, Stats.PooledProjectiles);
+	}
+}
+
+ANWPProjectile* ANWPProjectilePool::SpawnPooledProjectile(TSubclassOf<ANWPProjectile> _ProjectileClass)
+{
+	UWorld* World = GetWorld();
+
+	// Early return if no world
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	// Spawn deferred, so the projectile knows that it is pooled when BeginPlay is executed
+	const FTransform SpawnTransform = GetActorTransform();
+	ANWPProjectile* SpawnedProjectile = World->SpawnActorDeferred<ANWPProjectile>(_ProjectileClass, SpawnTransform, nullptr, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	if (!SpawnedProjectile)
+	{
+		return nullptr;
+	}
+
+	SpawnedProjectile->SetOwnerPool(this);
+	SpawnedProjectile->FinishSpawning(SpawnTransform);
+
+	// Projectiles remain disabled until they are acquired
+	SpawnedProjectile->OnReleasedToPool();
+	SpawnedProjectile->bIsInPool = true;
+
+	return SpawnedProjectile;
+}
+
+void ANWPProjectilePool::UpdateGlobalStats()
+{
+	FNWPProjectilePoolStats GlobalStats;
+
+	// Accumulate the stats of each pool
+	for (auto It = ProjectilePools.CreateConstIterator(); It; ++It)
+	{
+		const FNWPProjectilePoolStats& Stats = It.Value().Stats;
+
+		GlobalStats.Hits += Stats.Hits;
+		GlobalStats.Misses += Stats.Misses;
+		GlobalStats.ActiveProjectiles += Stats.ActiveProjectiles;
+		GlobalStats.PooledProjectiles += Stats.PooledProjectiles;
+	}
+
+	// The high water is the peak of projectiles in use at the same time, not the sum of the peak of each pool
+	HighWater = FMath::Max(HighWater, GlobalStats.ActiveProjectiles);
+	GlobalStats.HighWater = HighWater;
+
+	SET_DWORD_STAT(STAT_NWPProjectilePoolHits, GlobalStats.Hits);
+	SET_DWORD_STAT(STAT_NWPProjectilePoolMisses, GlobalStats.Misses);
+	SET_DWORD_STAT(STAT_NWPProjectilePoolActive, GlobalStats.ActiveProjectiles);
+	SET_DWORD_STAT(STAT_NWPProjectilePoolHighWater, GlobalStats.HighWater);
+	SET_DWORD_STAT(STAT_NWPProjectilePoolSize, GlobalStats.PooledProjectiles);
+}
@@ -0,0 +1,332 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPProjectileSimulation.h"
+
+// UE
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+#include "NWPProjectileMovementComponent.h"
+#include "NWPWeapon.h"
+#include "NWPUtils.h"
+
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Projectile Simulation Tick"), STAT_NWPProjectileSimulationTick, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Simulated Projectiles"), STAT_NWPSimulatedProjectiles, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated Projectile Sweeps"), STAT_NWPSimulatedProjectileSweeps, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated Projectile Lost Sweeps"), STAT_NWPSimulatedProjectileLostSweeps, STATGROUP_NWP);
+
+ANWPProjectileSimulation::ANWPProjectileSimulation(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+}
+
+void ANWPProjectileSimulation::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NWPProjectileSimulationTick);
+
+	Super::Tick(DeltaSeconds);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(NWPSimulatedProjectile), false);
+	CurrentQueryParamsWeapon = nullptr;
+
+	for (FNWPSimulatedProjectileGroup& Group : ProjectileGroups)
+	{
+		// Iterate backwards, so the projectiles removed by swapping are not skipped
+		for (int32 Index = Group.Num() - 1; Index >= 0; --Index)
+		{
+			if (ResolveProjectileSweep(Group, Index, QueryParams))
+			{
+				StepProjectile(Group, Index, DeltaSeconds, QueryParams);
+			}
+		}
+
+		UpdateInstances(Group);
+	}
+
+	SET_DWORD_STAT(STAT_NWPSimulatedProjectiles, GetNumSimulatedProjectiles());
+}
+
+ANWPProjectileSimulation* ANWPProjectileSimulation::GetProjectileSimulation(UWorld* World)
+{
+	return UNWPUtils::GetWorldManager<ANWPProjectileSimulation>(World);
+}
+
+int32 ANWPProjectileSimulation::GetNumSimulatedProjectiles() const
+{
+	int32 NumProjectiles = 0;
+
+	for (const FNWPSimulatedProjectileGroup& Group : ProjectileGroups)
+	{
+		NumProjectiles += Group.Num();
+	}
+
+	return NumProjectiles;
+}
+
+void ANWPProjectileSimulation::SpawnProjectile(class ANWPWeapon* _OwnerWeapon, TSubclassOf<ANWPProjectile> _ProjectileClass, class UStaticMesh* _Mesh,
+	const FVector& _Location, const FRotator& _Rotation, float _TimeOffset)
+{
+	FNWPSimulatedProjectileGroup* Group = FindOrAddGroup(_ProjectileClass, _Mesh);
+
+	// Early return if the group could not be created
+	if (!Group)
+	{
+		return;
+	}
+
+	const FVector Velocity = _Rotation.Vector() * Group->InitialSpeed;
+
+	Group->Positions.Add(_Location);
+	Group->Velocities.Add(Velocity);
+	Group->RemainingLifeTimes.Add(Group->LifeSpan > 0.0f ? Group->LifeSpan : MAX_flt);
+	Group->OwnerWeapons.Add(_OwnerWeapon);
+	Group->InstanceTransforms.Add(FTransform(_Rotation, _Location));
+	Group->InstancedMesh->AddInstanceWorldSpace(Group->InstanceTransforms.Last());
+	Group->SweepHandles.Add(FTraceHandle());
+	Group->SweepEnds.Add(_Location);
+
+	// The projectile catches up with the time it was shot earlier in the frame on its first step
+	Group->PendingTimes.Add(FMath::Max(_TimeOffset, 0.0f));
+}
+
+void ANWPProjectileSimulation::RemoveProjectilesOfWeapon(const class ANWPWeapon* _OwnerWeapon)
+{
+	for (FNWPSimulatedProjectileGroup& Group : ProjectileGroups)
+	{
+		for (int32 Index = Group.Num() - 1; Index >= 0; --Index)
+		{
+			if (Group.OwnerWeapons[Index].Get() == _OwnerWeapon)
+			{
+				RemoveProjectile(Group, Index);
+			}
+		}
+	}
+}
+
+FNWPSimulatedProjectileGroup* ANWPProjectileSimulation::FindOrAddGroup(TSubclassOf<ANWPProjectile> _ProjectileClass, class UStaticMesh* _Mesh)
+{
+	// Early return if invalid configuration
+	if (!_ProjectileClass.Get() || !_Mesh)
+	{
+		return nullptr;
+	}
+
+	// Return the group if it already exists
+	for (FNWPSimulatedProjectileGroup& Group : ProjectileGroups)
+	{
+		if (Group.ProjectileClass == _ProjectileClass && Group.Mesh == _Mesh)
+		{
+			return &Group;
+		}
+	}
+
+	// Read the configuration from the projectile class defaults
+	const ANWPProjectile* ProjectileCDO = _ProjectileClass->GetDefaultObject<ANWPProjectile>();
+	const UNWPProjectileMovementComponent* ProjectileMovement = ProjectileCDO->GetNWPProjectileMovementComponent();
+
+	FNWPSimulatedProjectileGroup& Group = ProjectileGroups.AddDefaulted_GetRef();
+	Group.ProjectileClass = _ProjectileClass;
+	Group.Mesh = _Mesh;
+	Group.Radius = ProjectileCDO->GetCollisionRadius();
+	Group.InitialSpeed = ProjectileMovement->InitialSpeed;
+	Group.MaxSpeed = ProjectileMovement->MaxSpeed;
+	Group.GravityScale = ProjectileMovement->ProjectileGravityScale;
+	Group.LifeSpan = ProjectileCDO->InitialLifeSpan;
+	Group.ImpactEffect = ProjectileCDO->GetImpactEffect();
+	Group.ImpulseStrenghtFactor = ProjectileCDO->GetImpulseStrenghtFactor();
+
+	// Create the component that draws the projectiles. The collisions are evaluated by the simulation
+	Group.InstancedMesh = NewObject<UInstancedStaticMeshComponent>(this);
+	Group.InstancedMesh->SetStaticMesh(_Mesh);
+	Group.InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Group.InstancedMesh->SetCanEverAffectNavigation(false);
+	Group.InstancedMesh->SetMobility(EComponentMobility::Movable);
+	Group.InstancedMesh->CastShadow = false;
+	Group.InstancedMesh->RegisterComponent();
+
+	return &Group;
+}
+
+bool ANWPProjectileSimulation::ResolveProjectileSweep(FNWPSimulatedProjectileGroup& _Group, int32 _Index, FCollisionQueryParams& _QueryParams)
+{
+	FTraceHandle& SweepHandle = _Group.SweepHandles[_Index];
+
+	// Early return if there is no sweep in flight
+	if (!SweepHandle.IsValid())
+	{
+		return true;
+	}
+
+	UWorld* World = GetWorld();
+	const FVector Start = _Group.Positions[_Index];
+	const FVector End = _Group.SweepEnds[_Index];
+	FTraceDatum SweepData;
+	FHitResult Hit;
+	bool bHit = false;
+
+	if (World->QueryTraceData(SweepHandle, SweepData))
+	{
+		for (const FHitResult& SweepHit : SweepData.OutHits)
+		{
+			if (SweepHit.bBlockingHit)
+			{
+				Hit = SweepHit;
+				bHit = true;
+				break;
+			}
+		}
+	}
+	else
+	{
+		// The results are only kept for one frame, so the sweep is repeated if the simulation has not ticked during the last one
+		INC_DWORD_STAT(STAT_NWPSimulatedProjectileLostSweeps);
+
+		UpdateQueryParams(_QueryParams, _Group.OwnerWeapons[_Index].Get());
+		bHit = World->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, COLLISION_WEAPON, FCollisionShape::MakeSphere(_Group.Radius), _QueryParams);
+	}
+
+	SweepHandle = FTraceHandle();
+
+	if (bHit)
+	{
+		_Group.Positions[_Index] = Hit.Location;
+		OnProjectileHit(_Group, _Index, Hit);
+		return false;
+	}
+
+	_Group.Positions[_Index] = End;
+	return true;
+}
+
+bool ANWPProjectileSimulation::StepProjectile(FNWPSimulatedProjectileGroup& _Group, int32 _Index, float _DeltaTime, FCollisionQueryParams& _QueryParams)
+{
+	UWorld* World = GetWorld();
+	ANWPWeapon* OwnerWeapon = _Group.OwnerWeapons[_Index].Get();
+
+	// Add the time that has not been simulated yet
+	const float StepTime = _DeltaTime + _Group.PendingTimes[_Index];
+	_Group.PendingTimes[_Index] = 0.0f;
+
+	// Remove the projectile if it has expired
+	_Group.RemainingLifeTimes[_Index] -= StepTime;
+
+	if (_Group.RemainingLifeTimes[_Index] <= 0.0f)
+	{
+		RemoveProjectile(_Group, _Index);
+		return false;
+	}
+
+	// Compute the new velocity
+	FVector& Velocity = _Group.Velocities[_Index];
+	Velocity.Z += World->GetGravityZ() * _Group.GravityScale * StepTime;
+
+	if (OwnerWeapon)
+	{
+		OwnerWeapon->OnProjectileVelocityComputed(nullptr, Velocity, StepTime);
+	}
+
+	if (_Group.MaxSpeed > 0.0f)
+	{
+		Velocity = Velocity.GetClampedToMaxSize(_Group.MaxSpeed);
+	}
+
+	UpdateQueryParams(_QueryParams, OwnerWeapon);
+
+	// Submit the sweep of the projectile. It is resolved during the next frame, so the projectile is drawn where its last sweep has ended
+	const FVector Start = _Group.Positions[_Index];
+	const FVector End = Start + Velocity * StepTime;
+
+	INC_DWORD_STAT(STAT_NWPSimulatedProjectileSweeps);
+
+	_Group.SweepHandles[_Index] = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, COLLISION_WEAPON,
+		FCollisionShape::MakeSphere(_Group.Radius), _QueryParams);
+	_Group.SweepEnds[_Index] = End;
+
+	return true;
+}
+
+void ANWPProjectileSimulation::UpdateQueryParams(FCollisionQueryParams& _QueryParams, class ANWPWeapon* _OwnerWeapon)
+{
+	// Early return if the params already ignore the weapon
+	if (CurrentQueryParamsWeapon.Get() == _OwnerWeapon)
+	{
+		return;
+	}
+
+	_QueryParams.ClearIgnoredActors();
+
+	if (_OwnerWeapon)
+	{
+		_QueryParams.AddIgnoredActor(_OwnerWeapon);
+		_QueryParams.AddIgnoredActor(_OwnerWeapon->GetOwner());
+	}
+
+	CurrentQueryParamsWeapon = _OwnerWeapon;
+}
+
+void ANWPProjectileSimulation::OnProjectileHit(FNWPSimulatedProjectileGroup& _Group, int32 _Index, const FHitResult& _Hit)
+{
+	AActor* OtherActor = _Hit.GetActor();
+	UPrimitiveComponent* OtherComp = _Hit.GetComponent();
+
+	// Tell the weapon that the projectile has hit something. There is no projectile actor, so the instanced mesh is the hit component
+	if (ANWPWeapon* OwnerWeapon = _Group.OwnerWeapons[_Index].Get())
+	{
+		OwnerWeapon->OnProjectileHit(nullptr, _Group.InstancedMesh, OtherActor, OtherComp, FVector::ZeroVector, _Hit);
+	}
+
+	// Only add impulse if we hit a physics
+	if (OtherActor && OtherComp && OtherComp->IsSimulatingPhysics())
+	{
+		OtherComp->AddImpulseAtLocation(_Group.Velocities[_Index] * _Group.ImpulseStrenghtFactor, _Group.Positions[_Index]);
+	}
+
+	// Try to spawn the hit effect
+	if (_Group.ImpactEffect)
+	{
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), _Group.ImpactEffect, _Hit.ImpactPoint, _Hit.Normal.Rotation());
+	}
+
+	RemoveProjectile(_Group, _Index);
+}
+
+void ANWPProjectileSimulation::RemoveProjectile(FNWPSimulatedProjectileGroup& _Group, int32 _Index)
+{
+	_Group.Positions.RemoveAtSwap(_Index, 1, false);
+	_Group.Velocities.RemoveAtSwap(_Index, 1, false);
+	_Group.RemainingLifeTimes.RemoveAtSwap(_Index, 1, false);
+	_Group.OwnerWeapons.RemoveAtSwap(_Index, 1, false);
+	_Group.InstanceTransforms.RemoveAtSwap(_Index, 1, false);
+	_Group.SweepHandles.RemoveAtSwap(_Index, 1, false);
+	_Group.SweepEnds.RemoveAtSwap(_Index, 1, false);
+	_Group.PendingTimes.RemoveAtSwap(_Index, 1, false);
+
+	// The instances are rewritten every frame, so removing the last one keeps them matching the projectiles
+	if (_Group.InstancedMesh)
+	{
+		_Group.InstancedMesh->RemoveInstance(_Group.InstancedMesh->GetInstanceCount() - 1);
+	}
+}
+
+void ANWPProjectileSimulation::UpdateInstances(FNWPSimulatedProjectileGroup& _Group)
+{
+	// Early return if nothing to draw
+	if (!_Group.InstancedMesh || _Group.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < _Group.Num(); ++Index)
+	{
+		_Group.InstanceTransforms[Index].SetLocation(_Group.Positions[Index]);
+		_Group.InstanceTransforms[Index].SetRotation(_Group.Velocities[Index].ToOrientationQuat());
+	}
+
+	_Group.InstancedMesh->BatchUpdateInstancesTransforms(0, _Group.InstanceTransforms, true, true, false);
+}
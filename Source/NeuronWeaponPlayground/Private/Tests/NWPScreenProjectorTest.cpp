@@ -0,0 +1,240 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPScreenProjector.h"
+
+// UE
+#include "ConvexVolume.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SceneView.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NWPScreenProjectorTest
+{
+	// Builds the projection data of a 90 degrees view the same way ULocalPlayer::GetProjectionData does
+	FSceneViewProjectionData MakeProjectionData(const FVector& _ViewLocation, const FRotator& _ViewRotation, const FIntRect& _ViewRect)
+	{
+		FSceneViewProjectionData ProjectionData;
+		ProjectionData.ViewOrigin = _ViewLocation;
+
+		// Swap the axes, so the view looks down the Z axis
+		ProjectionData.ViewRotationMatrix = FInverseRotationMatrix(_ViewRotation) * FMatrix(
+			FPlane(0.0f, 0.0f, 1.0f, 0.0f),
+			FPlane(1.0f, 0.0f, 0.0f, 0.0f),
+			FPlane(0.0f, 1.0f, 0.0f, 0.0f),
+			FPlane(0.0f, 0.0f, 0.0f, 1.0f));
+
+		ProjectionData.ProjectionMatrix = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(45.0f), _ViewRect.Width(), _ViewRect.Height(), 10.0f);
+		ProjectionData.SetViewRectangle(_ViewRect);
+
+		return ProjectionData;
+	}
+
+	// Spreads positions around the view, including some behind it
+	void MakePositions(int32 _NumPositions, const FVector& _ViewLocation, TArray<FVector>& _OutPositions)
+	{
+		FRandomStream RandomStream(_NumPositions);
+		_OutPositions.SetNumUninitialized(_NumPositions);
+
+		for (FVector& Position : _OutPositions)
+		{
+			Position = _ViewLocation + RandomStream.GetUnitVector() * RandomStream.FRandRange(100.0f, 10000.0f);
+		}
+	}
+}
+
+// The tests build the view from projection data, so they run headless.
+// Usage: UE4Editor-Cmd NeuronWeaponPlayground -nullrhi -unattended -ExecCmds="Automation RunTests NWP.ScreenProjector; Quit"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPScreenProjectorProjectionTest, "NWP.ScreenProjector.Projection",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPScreenProjectorFrustumTest, "NWP.ScreenProjector.Frustum",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPScreenProjectorBenchmarkTest, "NWP.ScreenProjector.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNWPScreenProjectorProjectionTest::RunTest(const FString& Parameters)
+{
+	const FVector ViewLocation(100.0f, -200.0f, 150.0f);
+	const FIntRect ViewRect(0, 0, 1920, 1080);
+	const FSceneViewProjectionData ProjectionData = NWPScreenProjectorTest::MakeProjectionData(ViewLocation, FRotator(-10.0f, 30.0f, 0.0f), ViewRect);
+	const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+
+	FNWPBatchedScreenProjector ScreenProjector;
+	TestFalse(TEXT("A projector without setup is not valid"), ScreenProjector.IsValid());
+
+	ScreenProjector.SetupFromProjectionData(ProjectionData);
+	TestTrue(TEXT("The projector is valid after the setup"), ScreenProjector.IsValid());
+
+	TArray<FVector> Positions;
+	NWPScreenProjectorTest::MakePositions(1000, ViewLocation, Positions);
+
+	TArray<FVector2D> ScreenPositions;
+	TArray<bool> ValidPositions;
+	ScreenProjector.ProjectPositions(Positions, ScreenPositions, ValidPositions);
+
+	// Project every other position through the indexed path
+	TArray<int32> Indices;
+
+	for (int32 Index = 0; Index < Positions.Num(); Index += 2)
+	{
+		Indices.Add(Index);
+	}
+
+	TArray<FVector2D> IndexedScreenPositions;
+	TArray<bool> IndexedValidPositions;
+	ScreenProjector.ProjectIndexedPositions(Positions, Indices, IndexedScreenPositions, IndexedValidPositions);
+
+	int32 NumInFront = 0;
+	int32 NumMismatches = 0;
+
+	// Compare against the projection used by APlayerController::ProjectWorldLocationToScreen
+	for (int32 Index = 0; Index < Positions.Num(); ++Index)
+	{
+		FVector2D ExpectedScreenPosition;
+		const bool bExpectedValid = FSceneView::ProjectWorldToScreen(Positions[Index], ViewRect, ViewProjectionMatrix, ExpectedScreenPosition);
+
+		FVector2D SingleScreenPosition;
+		const bool bSingleValid = ScreenProjector.ProjectPosition(Positions[Index], SingleScreenPosition);
+
+		NumInFront += bExpectedValid ? 1 : 0;
+
+		const bool bIndexed = (Index % 2) == 0;
+
+		if (ValidPositions[Index] != bExpectedValid || bSingleValid != bExpectedValid || (bIndexed ? IndexedValidPositions[Index] != bExpectedValid : IndexedValidPositions[Index]))
+		{
+			++NumMismatches;
+			continue;
+		}
+
+		// The positions close to the view plane project far from the screen, so the tolerance grows with the distance to it
+		const float Tolerance = FMath::Max(0.01f, ExpectedScreenPosition.GetAbsMax() * 1e-4f);
+
+		if (bExpectedValid && (!ScreenPositions[Index].Equals(ExpectedScreenPosition, Tolerance) || !SingleScreenPosition.Equals(ExpectedScreenPosition, Tolerance) ||
+			(bIndexed && !IndexedScreenPositions[Index].Equals(ExpectedScreenPosition, Tolerance))))
+		{
+			++NumMismatches;
+		}
+	}
+
+	TestTrue(TEXT("Some positions are in front of the view & some behind it"), NumInFront > 0 && NumInFront < Positions.Num());
+	TestEqual(TEXT("The batched projection matches the player controller projection"), NumMismatches, 0);
+
+	return true;
+}
+
+bool FNWPScreenProjectorFrustumTest::RunTest(const FString& Parameters)
+{
+	const FVector ViewLocation(0.0f, 0.0f, 100.0f);
+	const FIntRect ViewRect(0, 0, 1920, 1080);
+	const FVector2D ScreenMin(480.0f, 270.0f);
+	const FVector2D ScreenMax(1440.0f, 810.0f);
+	const float MaxDistance = 5000.0f;
+	const float Margin = 2.0f;
+
+	FNWPBatchedScreenProjector ScreenProjector;
+	ScreenProjector.SetupFromProjectionData(NWPScreenProjectorTest::MakeProjectionData(ViewLocation, FRotator(0.0f, 45.0f, 0.0f), ViewRect));
+
+	FConvexVolume Frustum;
+	FBox Bounds;
+	TestTrue(TEXT("The frustum is built"), ScreenProjector.BuildScreenRectFrustum(ScreenMin, ScreenMax, MaxDistance, Frustum, Bounds));
+
+	TArray<FVector> Positions;
+	NWPScreenProjectorTest::MakePositions(1000, ViewLocation, Positions);
+
+	const FVector ViewDirection = FRotator(0.0f, 45.0f, 0.0f).Vector();
+	int32 NumInside = 0;
+	int32 NumMismatches = 0;
+
+	// The positions projected inside the rectangle are inside the frustum, the ones outside of it are not. Skip the ones at the borders
+	for (const FVector& Position : Positions)
+	{
+		FVector2D ScreenPosition;
+		const float Distance = (Position - ViewLocation) | ViewDirection;
+
+		if (!ScreenProjector.ProjectPosition(Position, ScreenPosition) || FMath::Abs(Distance - MaxDistance) < Margin)
+		{
+			continue;
+		}
+
+		const bool bInsideRect = ScreenPosition.X > ScreenMin.X + Margin && ScreenPosition.X < ScreenMax.X - Margin &&
+			ScreenPosition.Y > ScreenMin.Y + Margin && ScreenPosition.Y < ScreenMax.Y - Margin;
+		const bool bOutsideRect = ScreenPosition.X < ScreenMin.X - Margin || ScreenPosition.X > ScreenMax.X + Margin ||
+			ScreenPosition.Y < ScreenMin.Y - Margin || ScreenPosition.Y > ScreenMax.Y + Margin;
+
+		if (!bInsideRect && !bOutsideRect)
+		{
+			continue;
+		}
+
+		const bool bExpectedInside = bInsideRect && Distance < MaxDistance;
+		NumInside += bExpectedInside ? 1 : 0;
+
+		if (Frustum.IntersectSphere(Position, 0.0f) != bExpectedInside || (bExpectedInside && !Bounds.IsInside(Position)))
+		{
+			++NumMismatches;
+		}
+	}
+
+	TestTrue(TEXT("Some positions are inside the frustum"), NumInside > 0);
+	TestEqual(TEXT("The frustum matches the screen rectangle"), NumMismatches, 0);
+
+	return true;
+}
+
+bool FNWPScreenProjectorBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FVector ViewLocation(0.0f, 0.0f, 100.0f);
+	const FIntRect ViewRect(0, 0, 1920, 1080);
+	const FSceneViewProjectionData ProjectionData = NWPScreenProjectorTest::MakeProjectionData(ViewLocation, FRotator::ZeroRotator, ViewRect);
+	const int32 NumIterations = 100;
+	const int32 NumPositionsCases[] = { 100, 1000, 10000 };
+
+	for (int32 NumPositions : NumPositionsCases)
+	{
+		TArray<FVector> Positions;
+		NWPScreenProjectorTest::MakePositions(NumPositions, ViewLocation, Positions);
+
+		TArray<FVector2D> ScreenPositions;
+		TArray<bool> ValidPositions;
+		ScreenPositions.SetNumUninitialized(NumPositions);
+		ValidPositions.SetNumZeroed(NumPositions);
+
+		// Per position, as APlayerController::ProjectWorldLocationToScreen rebuilds the view projection on every call
+		double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			for (int32 Index = 0; Index < NumPositions; ++Index)
+			{
+				ValidPositions[Index] = FSceneView::ProjectWorldToScreen(Positions[Index], ProjectionData.GetConstrainedViewRect(),
+					ProjectionData.ComputeViewProjectionMatrix(), ScreenPositions[Index]);
+			}
+		}
+
+		const double PerPositionTime = FPlatformTime::Seconds() - StartTime;
+
+		// Batched, building the view projection once per frame
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			FNWPBatchedScreenProjector ScreenProjector;
+			ScreenProjector.SetupFromProjectionData(ProjectionData);
+			ScreenProjector.ProjectPositions(Positions, ScreenPositions, ValidPositions);
+		}
+
+		const double BatchedTime = FPlatformTime::Seconds() - StartTime;
+		const double NumProjections = (double)NumPositions * NumIterations;
+
+		AddInfo(FString::Printf(TEXT("Positions: %d Per position: %.2f ns/position Batched: %.2f ns/position Speed up: %.2fx"),
+			NumPositions, PerPositionTime * 1e9 / NumProjections, BatchedTime * 1e9 / NumProjections, PerPositionTime / FMath::Max(BatchedTime, 1e-9)));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,125 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPSmartWeapon.h"
+
+// UE
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The tests only use the steering math, so they run headless.
+// Usage: UE4Editor-Cmd NeuronWeaponPlayground -nullrhi -unattended -ExecCmds="Automation RunTests NWP.SmartWeapon; Quit"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPSmartWeaponSteeringTest, "NWP.SmartWeapon.Steering",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPSmartWeaponSteeringBenchmarkTest, "NWP.SmartWeapon.SteeringBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNWPSmartWeaponSteeringTest::RunTest(const FString& Parameters)
+{
+	const FVector Velocity(3000.0f, 0.0f, 0.0f);
+	const float SubstepTime = 1.0f / 240.0f;
+	const float OrientationVelocity = 10.0f;
+
+	// Target to the side of the projectile
+	const FVector SteeredVelocity = ANWPSmartWeapon::SteerVelocity(Velocity, FVector::ZeroVector, FVector(1000.0f, 1000.0f, 0.0f), SubstepTime, OrientationVelocity);
+
+	TestEqual(TEXT("The steering keeps the speed"), SteeredVelocity.Size(), Velocity.Size(), 0.1f);
+	TestTrue(TEXT("The steering turns the projectile to the target"), SteeredVelocity.Y > 0.0f);
+	TestTrue(TEXT("The steering turns the direction by the orientation velocity at most"),
+		(SteeredVelocity.GetSafeNormal() - Velocity.GetSafeNormal()).Size() <= SubstepTime * OrientationVelocity + KINDA_SMALL_NUMBER);
+
+	// Target behind the projectile
+	TestEqual(TEXT("The projectiles moving away from the target fly straight"),
+		ANWPSmartWeapon::SteerVelocity(Velocity, FVector::ZeroVector, FVector(-1000.0f, 10.0f, 0.0f), SubstepTime, OrientationVelocity), Velocity);
+
+	// Follow a static target during two seconds of substeps
+	FVector Location(0.0f, 0.0f, 0.0f);
+	FVector CurrentVelocity(0.0f, 3000.0f, 0.0f);
+	const FVector TargetPoint(2000.0f, 2000.0f, 0.0f);
+
+	for (int32 Substep = 0; Substep < 480; ++Substep)
+	{
+		CurrentVelocity = ANWPSmartWeapon::SteerVelocity(CurrentVelocity, Location, TargetPoint, SubstepTime, OrientationVelocity);
+		Location += CurrentVelocity * SubstepTime;
+
+		// Stop once the projectile reaches the target
+		if (FVector::Dist(Location, TargetPoint) < 50.0f)
+		{
+			break;
+		}
+	}
+
+	TestTrue(TEXT("The steered projectile reaches the target"), FVector::Dist(Location, TargetPoint) < 50.0f);
+
+	return true;
+}
+
+bool FNWPSmartWeaponSteeringBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 NumSubsteps = 4;
+	const float SubstepTime = 1.0f / (60.0f * NumSubsteps);
+	const float OrientationVelocity = 10.0f;
+	const int32 NumFrames = 60;
+
+	for (int32 NumProjectiles = 10; NumProjectiles <= 10000; NumProjectiles *= 10)
+	{
+		// Build synthetic projectiles flying around their targets
+		FRandomStream RandomStream(NumProjectiles);
+		TArray<FVector> InitialLocations;
+		TArray<FVector> InitialVelocities;
+		TArray<FVector> TargetPoints;
+
+		for (int32 Index = 0; Index < NumProjectiles; ++Index)
+		{
+			InitialLocations.Add(RandomStream.VRand() * RandomStream.FRandRange(100.0f, 10000.0f));
+			InitialVelocities.Add(RandomStream.VRand() * 3000.0f);
+			TargetPoints.Add(RandomStream.VRand() * RandomStream.FRandRange(100.0f, 1000.0f));
+		}
+
+		// Steers & moves a projectile during the substeps of a frame, like its movement component does
+		auto StepProjectile = [&TargetPoints, SubstepTime, OrientationVelocity, NumSubsteps](FVector& _Location, FVector& _Velocity, int32 _Index)
+		{
+			for (int32 Substep = 0; Substep < NumSubsteps; ++Substep)
+			{
+				_Velocity = ANWPSmartWeapon::SteerVelocity(_Velocity, _Location, TargetPoints[_Index], SubstepTime, OrientationVelocity);
+				_Location += _Velocity * SubstepTime;
+			}
+		};
+
+		// Per projectile & substep on the game thread, as the velocity callback does
+		TArray<FVector> Locations = InitialLocations;
+		TArray<FVector> Velocities = InitialVelocities;
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 Index = 0; Index < NumProjectiles; ++Index)
+			{
+				StepProjectile(Locations[Index], Velocities[Index], Index);
+			}
+		}
+
+		const double SteeringTime = FPlatformTime::Seconds() - StartTime;
+		const double NumSteps = (double)NumProjectiles * NumFrames * NumSubsteps;
+
+		AddInfo(FString::Printf(TEXT("Projectiles: %d Substeps: %d Steering: %.2f ns/substep %.3f ms/frame"),
+			NumProjectiles, NumSubsteps, SteeringTime * 1e9 / NumSteps, SteeringTime * 1e3 / NumFrames));
+
+		// The steering keeps the speed of every projectile
+		int32 NumSpeedMismatches = 0;
+
+		for (int32 Index = 0; Index < NumProjectiles; ++Index)
+		{
+			NumSpeedMismatches += FMath::IsNearlyEqual(Velocities[Index].Size(), InitialVelocities[Index].Size(), 1.0f) ? 0 : 1;
+		}
+
+		TestEqual(TEXT("The steering keeps the speed of every projectile"), NumSpeedMismatches, 0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
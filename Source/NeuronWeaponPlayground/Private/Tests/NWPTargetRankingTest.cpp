@@ -0,0 +1,81 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPTargetRanking.h"
+
+// UE
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+// NWP
+#include "NWPTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Usage: UE4Editor-Cmd NeuronWeaponPlayground -nullrhi -unattended -ExecCmds="Automation RunTests NWP.TargetRanking; Quit"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPTargetRankingPolicyTest, "NWP.TargetRanking.Policy",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPTargetRankingDestroyedTargetTest, "NWP.TargetRanking.DestroyedTarget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNWPTargetRankingPolicyTest::RunTest(const FString& Parameters)
+{
+	FNWPTestWorld TestWorld;
+	const AActor* AlignedTarget = TestWorld.World->SpawnActor<AActor>();
+	const AActor* SideTarget = TestWorld.World->SpawnActor<AActor>();
+
+	FNWPTargetRanking TargetRanking;
+	TestTrue(TEXT("The default policy is the best angle"), TargetRanking.GetPolicy() == ENWPTargetAllocationPolicy::BestAngle);
+
+	TargetRanking.BeginUpdate();
+	TargetRanking.RankTarget(AlignedTarget, 0.9f);
+	TargetRanking.RankTarget(SideTarget, 0.5f);
+	TargetRanking.EndUpdate();
+
+	// The best angle keeps selecting the most aligned target
+	TestTrue(TEXT("The best angle selects the most aligned target"), TargetRanking.AllocateTarget() == AlignedTarget);
+	TestTrue(TEXT("The best angle selects the most aligned target again"), TargetRanking.AllocateTarget() == AlignedTarget);
+
+	// The fewest assignments goes to the target without projectiles
+	TargetRanking.SetPolicy(ENWPTargetAllocationPolicy::FewestAssignments);
+	TestTrue(TEXT("The fewest assignments selects the target without projectiles"), TargetRanking.AllocateTarget() == SideTarget);
+
+	// Releasing the projectiles of the aligned target makes it the best one again
+	TargetRanking.ReleaseTarget(AlignedTarget);
+	TargetRanking.ReleaseTarget(AlignedTarget);
+	TestTrue(TEXT("The released target is selected again"), TargetRanking.GetBestTarget() == AlignedTarget);
+
+	// The targets that are not ranked again leave the ranking
+	TargetRanking.BeginUpdate();
+	TargetRanking.RankTarget(SideTarget, 0.5f);
+	TargetRanking.EndUpdate();
+	TestEqual(TEXT("The targets not ranked again are removed"), TargetRanking.Num(), 1);
+
+	return true;
+}
+
+bool FNWPTargetRankingDestroyedTargetTest::RunTest(const FString& Parameters)
+{
+	FNWPTestWorld TestWorld;
+	AActor* AlignedTarget = TestWorld.World->SpawnActor<AActor>();
+	AActor* SideTarget = TestWorld.World->SpawnActor<AActor>();
+
+	FNWPTargetRanking TargetRanking;
+	TargetRanking.BeginUpdate();
+	TargetRanking.RankTarget(AlignedTarget, 0.9f);
+	TargetRanking.RankTarget(SideTarget, 0.5f);
+	TargetRanking.EndUpdate();
+
+	// Destroy the best target between two updates, as a target killed during the frame before the smart weapon updates its targets
+	AlignedTarget->Destroy();
+
+	TestTrue(TEXT("The destroyed target is skipped"), TargetRanking.AllocateTarget() == SideTarget);
+	TestEqual(TEXT("The destroyed target leaves the ranking"), TargetRanking.Num(), 1);
+
+	SideTarget->Destroy();
+	TestNull(TEXT("No target is selected when every target has been destroyed"), TargetRanking.AllocateTarget());
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,65 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+// NWP
+#include "NWPWeapon.h"
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Transient game world used by the automation tests that need actors. It is destroyed when it goes out of scope
+struct FNWPTestWorld
+{
+// Constructors
+public:
+
+	FNWPTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FNWPTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	FNWPTestWorld(const FNWPTestWorld&) = delete;
+	FNWPTestWorld& operator=(const FNWPTestWorld&) = delete;
+
+// Member variables
+public:
+
+	// World where the actors are spawned
+	UWorld* World;
+};
+
+// Gives the automation tests access to the internals of the weapons
+struct FNWPWeaponTestAccess
+{
+	// Returns the mesh of the weapon
+	static const USkeletalMeshComponent* GetFirstPersonGun(const ANWPWeapon& _Weapon) { return _Weapon.FirstPersonGun; }
+
+	// Makes the weapon load its config synchronously, so the config is loaded when LoadWeapon returns
+	static void SetLoadWeaponConfigAsync(ANWPWeapon& _Weapon, bool _bAsync) { _Weapon.bLoadWeaponConfigAsync = _bAsync; }
+
+	// Computes the shot origin reading the runtime profile
+	static bool ComputeShotOrigin(const ANWPWeapon& _Weapon, FVector& _OutLocation, FRotator& _OutRotation, FTransform& _OutMuzzleTransform)
+	{
+		return _Weapon.ComputeShotOrigin(_OutLocation, _OutRotation, _OutMuzzleTransform);
+	}
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
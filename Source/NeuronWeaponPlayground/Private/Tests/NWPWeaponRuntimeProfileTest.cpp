@@ -0,0 +1,233 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeapon.h"
+
+// UE
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+// NWP
+#include "NeuronTestCharacter.h"
+#include "NWPTestUtils.h"
+#include "NWPWeaponConfig.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Weapon spawned by the tests
+static const TCHAR* RuntimeProfileWeaponClassPath = TEXT("/Game/Weapons/BP_DefaultWeapon.BP_DefaultWeapon_C");
+
+// Weapon configs baked by the tests
+static const TCHAR* RuntimeProfileWeaponConfigClassPaths[] =
+{
+	TEXT("/Game/Data/WeaponConfigs/BP_DefaultWeaponConfig.BP_DefaultWeaponConfig_C"),
+	TEXT("/Game/Data/WeaponConfigs/BP_PistolWeaponConfig.BP_PistolWeaponConfig_C"),
+	TEXT("/Game/Data/WeaponConfigs/BP_AssaultRifleConfig.BP_AssaultRifleConfig_C"),
+	TEXT("/Game/Data/WeaponConfigs/BP_ShotgunConfig.BP_ShotgunConfig_C"),
+	TEXT("/Game/Data/WeaponConfigs/BP_SniperRifleConfig.BP_SniperRifleConfig_C"),
+	TEXT("/Game/Data/WeaponConfigs/BP_GrenadeLauncherConfig.BP_GrenadeLauncherConfig_C"),
+	TEXT("/Game/Data/WeaponConfigs/BP_RocketLauncherConfig.BP_RocketLauncherConfig_C"),
+};
+
+// Computes the shot origin reading the weapon config, as the fire path did before the runtime profile
+static bool ComputeShotOriginFromConfig(const ANWPWeapon& _Weapon, FVector& _OutLocation, FRotator& _OutRotation, FTransform& _OutMuzzleTransform)
+{
+	const UNWPWeaponConfig* WeaponConfig = _Weapon.GetWeaponConfig();
+	const USkeletalMeshComponent* FirstPersonGun = FNWPWeaponTestAccess::GetFirstPersonGun(_Weapon);
+
+	bool bMuzzleSocketIsValid = FirstPersonGun->DoesSocketExist(FName(*WeaponConfig->GetMuzzleBoneName()));
+
+	// Calculate muzzle transform
+	if (bMuzzleSocketIsValid)
+	{
+		// Add the offsets to the socket transform
+		_OutMuzzleTransform = FirstPersonGun->GetSocketTransform(FName(*WeaponConfig->GetMuzzleBoneName()));
+		FVector TransformedOffset = _OutMuzzleTransform.TransformVector(WeaponConfig->GetMuzzleBoneOffsetLocation());
+		_OutMuzzleTransform.SetLocation(_OutMuzzleTransform.GetLocation() + TransformedOffset);
+		_OutMuzzleTransform.SetRotation((_OutMuzzleTransform.GetRotation().Rotator() + WeaponConfig->GetMuzzleBoneOffsetRotation()).Quaternion());
+	}
+
+	// Check if the socket exists & the shot is from the muzzle
+	if (bMuzzleSocketIsValid && !WeaponConfig->ShouldUseEyesAsShootOrigin())
+	{
+		_OutLocation = _OutMuzzleTransform.GetLocation();
+		_OutRotation = _OutMuzzleTransform.GetRotation().Rotator();
+	}
+	else
+	{
+		// Get the eyes location / rotation
+		_Weapon.GetCharacterOwner()->GetActorEyesViewPoint(_OutLocation, _OutRotation);
+		const FTransform EyesTransform = FTransform(_OutRotation, _OutLocation);
+		_OutLocation += EyesTransform.TransformVector(WeaponConfig->GetEyesOffsetLocation());
+		_OutRotation += WeaponConfig->GetEyesOffsetRotation();
+	}
+
+	return bMuzzleSocketIsValid;
+}
+
+// Spawns the weapon held by a character. Returns nullptr if the weapon could not be spawned
+static ANWPWeapon* SpawnRuntimeProfileWeapon(UWorld* _World)
+{
+	UClass* WeaponClass = LoadClass<ANWPWeapon>(nullptr, RuntimeProfileWeaponClassPath);
+	ANeuronTestCharacter* Character = _World->SpawnActor<ANeuronTestCharacter>(FVector(0.0f, 0.0f, 200.0f), FRotator(-10.0f, 30.0f, 0.0f));
+	ANWPWeapon* Weapon = WeaponClass ? _World->SpawnActor<ANWPWeapon>(WeaponClass, FVector::ZeroVector, FRotator::ZeroRotator) : nullptr;
+
+	// Early return if the actors could not be spawned
+	if (!Character || !Weapon)
+	{
+		return nullptr;
+	}
+
+	// Load the configs synchronously, so the profile is baked with the muzzle of the loaded mesh
+	Weapon->SetOwnerCharacter(Character, false);
+	FNWPWeaponTestAccess::SetLoadWeaponConfigAsync(*Weapon, false);
+
+	return Weapon;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPWeaponRuntimeProfileTest, "NWP.Weapon.RuntimeProfile",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPWeaponRuntimeProfileBenchmarkTest, "NWP.Weapon.RuntimeProfileBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNWPWeaponRuntimeProfileTest::RunTest(const FString& Parameters)
+{
+	FNWPTestWorld TestWorld;
+	ANWPWeapon* Weapon = SpawnRuntimeProfileWeapon(TestWorld.World);
+
+	if (!TestNotNull(TEXT("The weapon is spawned"), Weapon))
+	{
+		return false;
+	}
+
+	for (const TCHAR* WeaponConfigClassPath : RuntimeProfileWeaponConfigClassPaths)
+	{
+		TSubclassOf<UNWPWeaponConfig> WeaponConfigClass = LoadClass<UNWPWeaponConfig>(nullptr, WeaponConfigClassPath);
+
+		if (!TestNotNull(*FString::Printf(TEXT("%s is loaded"), WeaponConfigClassPath), WeaponConfigClass.Get()))
+		{
+			continue;
+		}
+
+		Weapon->LoadWeapon(WeaponConfigClass);
+
+		const UNWPWeaponConfig* WeaponConfig = Weapon->GetWeaponConfig();
+		const FNWPWeaponRuntimeProfile& RuntimeProfile = Weapon->GetRuntimeProfile();
+
+		if (!TestTrue(*FString::Printf(TEXT("%s is loaded by the weapon"), WeaponConfigClassPath), WeaponConfig && WeaponConfig->IsLoaded()))
+		{
+			continue;
+		}
+
+		// The profile is a copy of the config
+		TestEqual(*FString::Printf(TEXT("%s: Shoot distance"), WeaponConfigClassPath), RuntimeProfile.ShootDistance, WeaponConfig->GetShootDistance());
+		TestEqual(*FString::Printf(TEXT("%s: Projectile as ammo"), WeaponConfigClassPath), (bool)RuntimeProfile.bUseProjectileAsAmmo, WeaponConfig->ShouldUseProjectileAsAmmo());
+		TestEqual(*FString::Printf(TEXT("%s: Async hitscan"), WeaponConfigClassPath), (bool)RuntimeProfile.bUseAsyncHitscan, WeaponConfig->ShouldUseAsyncHitscan());
+		TestEqual(*FString::Printf(TEXT("%s: Eyes as origin"), WeaponConfigClassPath), (bool)RuntimeProfile.bUseEyesAsShootOrigin, WeaponConfig->ShouldUseEyesAsShootOrigin());
+		TestTrue(*FString::Printf(TEXT("%s: Hitscan trace quality"), WeaponConfigClassPath), RuntimeProfile.HitscanTraceQuality == WeaponConfig->GetHitscanTraceQuality());
+		TestTrue(*FString::Printf(TEXT("%s: Muzzle name"), WeaponConfigClassPath),
+			RuntimeProfile.MuzzleSocketName == (WeaponConfig->GetMuzzleBoneName().IsEmpty() ? NAME_None : FName(*WeaponConfig->GetMuzzleBoneName())));
+
+		// The cool downs are computed once per cadence
+		for (int32 CadenceIndex = 0; CadenceIndex < (int32)ENWPWeaponCadenceType::COUNT; ++CadenceIndex)
+		{
+			TestTrue(*FString::Printf(TEXT("%s: Cool down of cadence %d"), WeaponConfigClassPath, CadenceIndex),
+				Weapon->GetSimulation().GetParams().CoolDowns[CadenceIndex] == WeaponConfig->GetCoolDownForCadenceType((ENWPWeaponCadenceType)CadenceIndex));
+		}
+
+		// The shot leaves from the same origin using both paths
+		FVector ConfigLocation;
+		FRotator ConfigRotation;
+		FTransform ConfigMuzzleTransform;
+		const bool bConfigMuzzleIsValid = ComputeShotOriginFromConfig(*Weapon, ConfigLocation, ConfigRotation, ConfigMuzzleTransform);
+
+		FVector ProfileLocation;
+		FRotator ProfileRotation;
+		FTransform ProfileMuzzleTransform;
+		const bool bProfileMuzzleIsValid = FNWPWeaponTestAccess::ComputeShotOrigin(*Weapon, ProfileLocation, ProfileRotation, ProfileMuzzleTransform);
+
+		TestEqual(*FString::Printf(TEXT("%s: Muzzle is valid"), WeaponConfigClassPath), bProfileMuzzleIsValid, bConfigMuzzleIsValid);
+		TestTrue(*FString::Printf(TEXT("%s: Shot location"), WeaponConfigClassPath), ProfileLocation.Equals(ConfigLocation, KINDA_SMALL_NUMBER));
+		TestTrue(*FString::Printf(TEXT("%s: Shot rotation"), WeaponConfigClassPath), ProfileRotation.Equals(ConfigRotation, KINDA_SMALL_NUMBER));
+	}
+
+	Weapon->ReleaseWeapon();
+
+	return true;
+}
+
+bool FNWPWeaponRuntimeProfileBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 NumShots = 100000;
+
+	FNWPTestWorld TestWorld;
+	ANWPWeapon* Weapon = SpawnRuntimeProfileWeapon(TestWorld.World);
+	TSubclassOf<UNWPWeaponConfig> WeaponConfigClass = LoadClass<UNWPWeaponConfig>(nullptr, RuntimeProfileWeaponConfigClassPaths[0]);
+
+	if (!TestNotNull(TEXT("The weapon is spawned"), Weapon) || !TestNotNull(TEXT("The weapon config is loaded"), WeaponConfigClass.Get()))
+	{
+		return false;
+	}
+
+	Weapon->LoadWeapon(WeaponConfigClass);
+
+	const UNWPWeaponConfig* WeaponConfig = Weapon->GetWeaponConfig();
+	const FNWPWeaponRuntimeProfile& RuntimeProfile = Weapon->GetRuntimeProfile();
+	const ENWPWeaponCadenceType CadenceType = Weapon->GetCurrentConfiguredCadenceType();
+
+	if (!TestNotNull(TEXT("The weapon is configured"), WeaponConfig))
+	{
+		return false;
+	}
+
+	// Both paths prepare the same shots: origin, cool down, end position & the way the shot is fired. Nothing is spawned
+	FVector ShotLocation;
+	FRotator ShotRotation;
+	FTransform MuzzleTransform;
+	FVector EndPositionSum = FVector::ZeroVector;
+	float CoolDownSum = 0.0f;
+	int32 ShotModeSum = 0;
+	int32 MuzzleNameSum = 0;
+
+	// Read the weapon config on every shot
+	const double ConfigStartTime = FPlatformTime::Seconds();
+
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+	{
+		ComputeShotOriginFromConfig(*Weapon, ShotLocation, ShotRotation, MuzzleTransform);
+		CoolDownSum += WeaponConfig->GetCoolDownForCadenceType(CadenceType);
+		EndPositionSum += ShotLocation + ShotRotation.Vector() * WeaponConfig->GetShootDistance();
+		ShotModeSum += WeaponConfig->ShouldUseProjectileAsAmmo() ?
+			(WeaponConfig->ShouldUseSimulatedProjectiles() && WeaponConfig->GetSimulatedProjectileMesh() ? 2 : 1) :
+			(WeaponConfig->ShouldUseAsyncHitscan() ? 3 : 4);
+		MuzzleNameSum += FName(*WeaponConfig->GetMuzzleBoneName()).IsNone() ? 0 : 1;
+	}
+
+	const double ConfigTime = FPlatformTime::Seconds() - ConfigStartTime;
+
+	// Read the runtime profile on every shot
+	const double ProfileStartTime = FPlatformTime::Seconds();
+
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+	{
+		FNWPWeaponTestAccess::ComputeShotOrigin(*Weapon, ShotLocation, ShotRotation, MuzzleTransform);
+		CoolDownSum += Weapon->GetSimulation().GetCadenceCoolDown();
+		EndPositionSum += ShotLocation + ShotRotation.Vector() * RuntimeProfile.ShootDistance;
+		ShotModeSum += RuntimeProfile.bUseProjectileAsAmmo ? (RuntimeProfile.bUseSimulatedProjectiles ? 2 : 1) : (RuntimeProfile.bUseAsyncHitscan ? 3 : 4);
+		MuzzleNameSum += RuntimeProfile.MuzzleSocketName.IsNone() ? 0 : 1;
+	}
+
+	const double ProfileTime = FPlatformTime::Seconds() - ProfileStartTime;
+
+	// The sums keep the work alive. The loops run on a single thread, so the rates are per core
+	AddInfo(FString::Printf(TEXT("Shots: %d Config: %.0f shots/s Profile: %.0f shots/s Speedup: %.2fx (%f %f %d %d)"),
+		NumShots, ConfigTime > 0.0 ? NumShots / ConfigTime : 0.0, ProfileTime > 0.0 ? NumShots / ProfileTime : 0.0,
+		ProfileTime > 0.0 ? ConfigTime / ProfileTime : 0.0, EndPositionSum.Size(), CoolDownSum, ShotModeSum, MuzzleNameSum));
+
+	Weapon->ReleaseWeapon();
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,243 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeaponSimulation.h"
+
+// UE
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The tests only use the simulation, so they run headless.
+// Usage: UE4Editor-Cmd NeuronWeaponPlayground -nullrhi -unattended -ExecCmds="Automation RunTests NWP.WeaponSimulation; Quit"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPWeaponSimulationStateTest, "NWP.WeaponSimulation.State",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPWeaponSimulationSubFrameShotsTest, "NWP.WeaponSimulation.SubFrameShots",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPWeaponSimulationCoolDownRemainderTest, "NWP.WeaponSimulation.CoolDownRemainder",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNWPWeaponSimulationBenchmarkTest, "NWP.WeaponSimulation.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNWPWeaponSimulationStateTest::RunTest(const FString& Parameters)
+{
+	FNWPWeaponSimulationParams SimulationParams;
+	SimulationParams.CoolDowns[(int32)ENWPWeaponSimulationCadenceType::Automatic] = 0.125f;
+	SimulationParams.CoolDowns[(int32)ENWPWeaponSimulationCadenceType::SemiAutomatic] = 0.25f;
+	SimulationParams.MagazineReloadTime = 1.0f;
+	SimulationParams.InitialAmmo = 4;
+	SimulationParams.MaximumAmmo = 10;
+	SimulationParams.AmmoPerMagazine = 2;
+	SimulationParams.DefaultCadenceType = ENWPWeaponSimulationCadenceType::Automatic;
+	SimulationParams.bIsAutomatic = true;
+	SimulationParams.bIsSemiAutomatic = true;
+
+	FNWPWeaponSimulation Simulation;
+	Simulation.Configure(SimulationParams);
+	Simulation.SetState(ENWPWeaponSimulationState::None);
+
+	TestEqual(TEXT("Configure restores the ammo"), Simulation.GetAmmo(), 4);
+	TestEqual(TEXT("Configure fills the magazine"), Simulation.GetAmmoInMagazine(), 2);
+	TestTrue(TEXT("An idle weapon can start shooting"), Simulation.CanStartShooting());
+
+	// Empty the magazine
+	TestTrue(TEXT("The first shot is fired"), Simulation.ConsumeShot());
+	Simulation.SetState(ENWPWeaponSimulationState::Shooting);
+	TestTrue(TEXT("The cool down is active after a shot"), Simulation.IsCoolDownActive());
+
+	Simulation.UpdateCoolDown(0.125f);
+	TestFalse(TEXT("The cool down expires after the cadence cool down"), Simulation.IsCoolDownActive());
+	TestTrue(TEXT("The second shot is fired"), Simulation.ConsumeShot());
+	TestEqual(TEXT("The magazine is empty"), Simulation.GetAmmoInMagazine(), 0);
+
+	// Start the reload
+	Simulation.UpdateCoolDown(0.125f);
+	TestFalse(TEXT("A shot without ammo in the magazine is not fired"), Simulation.ConsumeShot());
+	TestTrue(TEXT("The reload starts when the magazine is empty"), Simulation.GetState() == ENWPWeaponSimulationState::Reloading);
+
+	// Stop shooting during the reload, so the weapon goes to none when the reload finishes
+	Simulation.StopShooting();
+	Simulation.UpdateCoolDown(0.5f);
+	TestTrue(TEXT("The reload is in progress"), Simulation.GetState() == ENWPWeaponSimulationState::Reloading);
+
+	Simulation.UpdateCoolDown(0.5f);
+	TestTrue(TEXT("The reload finishes in none after stopping the shooting"), Simulation.GetState() == ENWPWeaponSimulationState::None);
+	TestEqual(TEXT("The reload fills the magazine"), Simulation.GetAmmoInMagazine(), 2);
+	TestEqual(TEXT("The reload takes the ammo"), Simulation.GetAmmo(), 2);
+
+	// Swap the cadence
+	TestTrue(TEXT("An idle weapon swaps its cadence"), Simulation.SwapCadenceType());
+	TestTrue(TEXT("The cadence is semi automatic"), Simulation.GetCadenceType() == ENWPWeaponSimulationCadenceType::SemiAutomatic);
+	TestEqual(TEXT("The cool down follows the cadence"), Simulation.GetCadenceCoolDown(), 0.25f);
+
+	return true;
+}
+
+bool FNWPWeaponSimulationSubFrameShotsTest::RunTest(const FString& Parameters)
+{
+	FNWPWeaponSimulationParams SimulationParams;
+	SimulationParams.CoolDowns[(int32)ENWPWeaponSimulationCadenceType::Automatic] = 0.125f;
+	SimulationParams.InitialAmmo = 100;
+	SimulationParams.MaximumAmmo = 100;
+	SimulationParams.AmmoPerMagazine = 100;
+	SimulationParams.DefaultCadenceType = ENWPWeaponSimulationCadenceType::Automatic;
+	SimulationParams.bIsAutomatic = true;
+	SimulationParams.bAccumulateSubFrameShots = true;
+
+	FNWPWeaponSimulation Simulation;
+	Simulation.Configure(SimulationParams);
+	Simulation.SetState(ENWPWeaponSimulationState::None);
+
+	Simulation.ConsumeShot();
+	Simulation.SetState(ENWPWeaponSimulationState::Shooting);
+
+	// A frame of four cool downs fires the three shots that are due & the one due at the end of the frame
+	float TimeOffsets[8];
+	Simulation.UpdateCoolDown(0.5f);
+
+	TestEqual(TEXT("Every shot due during the frame is fired"), Simulation.ConsumeDueShots(0.5f, ARRAY_COUNT(TimeOffsets), TimeOffsets), 4);
+	TestEqual(TEXT("The first shot was due earliest"), TimeOffsets[0], 0.375f);
+	TestEqual(TEXT("The last shot is due at the end of the frame"), TimeOffsets[3], 0.0f);
+	TestEqual(TEXT("The next shot is one cool down away"), Simulation.GetCoolDown(), 0.125f);
+
+	// The shots over the limit are dropped
+	Simulation.UpdateCoolDown(0.5f);
+
+	TestEqual(TEXT("The shots are limited"), Simulation.ConsumeDueShots(0.5f, 2, TimeOffsets), 2);
+	TestEqual(TEXT("The dropped shots do not carry over"), Simulation.GetCoolDown(), 0.0f);
+
+	return true;
+}
+
+bool FNWPWeaponSimulationCoolDownRemainderTest::RunTest(const FString& Parameters)
+{
+	FNWPWeaponSimulationParams SimulationParams;
+	SimulationParams.CoolDowns[(int32)ENWPWeaponSimulationCadenceType::Automatic] = 0.25f;
+	SimulationParams.MagazineReloadTime = 0.5f;
+	SimulationParams.InitialAmmo = 10;
+	SimulationParams.MaximumAmmo = 10;
+	SimulationParams.AmmoPerMagazine = 1;
+	SimulationParams.DefaultCadenceType = ENWPWeaponSimulationCadenceType::Automatic;
+	SimulationParams.bIsAutomatic = true;
+
+	FNWPWeaponSimulation Simulation;
+	Simulation.Configure(SimulationParams);
+	Simulation.SetState(ENWPWeaponSimulationState::None);
+
+	// An idle weapon does not owe any shot
+	Simulation.UpdateCoolDown(1.0f);
+	TestEqual(TEXT("The cool down of an idle weapon stays at zero"), Simulation.GetCoolDown(), 0.0f);
+
+	Simulation.ConsumeShot();
+	Simulation.SetState(ENWPWeaponSimulationState::Shooting);
+
+	// The reload starts a frame after the cool down expired & finishes in the middle of a frame
+	Simulation.UpdateCoolDown(0.25f);
+	TestFalse(TEXT("The reload starts when the magazine is empty"), Simulation.ConsumeShot());
+
+	Simulation.UpdateCoolDown(0.75f);
+	TestTrue(TEXT("The reload restores the shooting"), Simulation.GetState() == ENWPWeaponSimulationState::Shooting);
+	TestEqual(TEXT("The time elapsed since the reload finished is kept"), Simulation.GetCoolDown(), -0.25f);
+
+	// The next shot is scheduled from the end of the reload, not from the frame boundary
+	TestTrue(TEXT("The shot after the reload is fired"), Simulation.ConsumeShot());
+	TestEqual(TEXT("The next cool down is discounted"), Simulation.GetCoolDown(), 0.0f);
+
+	// A late frame does not owe more than one shot
+	Simulation.UpdateCoolDown(0.5f);
+	TestFalse(TEXT("The reload starts when the magazine is empty"), Simulation.ConsumeShot());
+	Simulation.UpdateCoolDown(2.0f);
+	TestTrue(TEXT("The shot after the late frame is fired"), Simulation.ConsumeShot());
+	TestEqual(TEXT("The discount is limited to one cool down"), Simulation.GetCoolDown(), 0.0f);
+
+	return true;
+}
+
+bool FNWPWeaponSimulationBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 NumWeapons = 100000;
+	const int32 NumSteps = 100;
+	const float StepTime = 1.0f / 60.0f;
+
+	FRandomStream RandomStream(NumWeapons);
+	TArray<FNWPWeaponSimulation> Simulations;
+	Simulations.SetNum(NumWeapons);
+
+	// Configure weapons with different cadences & magazines, half of them accumulating the shots
+	for (int32 Index = 0; Index < NumWeapons; ++Index)
+	{
+		FNWPWeaponSimulationParams SimulationParams;
+		SimulationParams.CoolDowns[(int32)ENWPWeaponSimulationCadenceType::Automatic] = RandomStream.FRandRange(0.002f, 0.2f);
+		SimulationParams.CoolDowns[(int32)ENWPWeaponSimulationCadenceType::SemiAutomatic] = RandomStream.FRandRange(0.1f, 0.5f);
+		SimulationParams.MagazineReloadTime = RandomStream.FRandRange(0.5f, 2.0f);
+		SimulationParams.AmmoPerMagazine = RandomStream.RandRange(5, 60);
+		SimulationParams.InitialAmmo = SimulationParams.AmmoPerMagazine * 10;
+		SimulationParams.MaximumAmmo = SimulationParams.InitialAmmo;
+		SimulationParams.bIsAutomatic = true;
+		SimulationParams.bIsSemiAutomatic = true;
+		SimulationParams.bAccumulateSubFrameShots = (Index & 1) == 0;
+		SimulationParams.DefaultCadenceType = RandomStream.FRand() < 0.75f ? ENWPWeaponSimulationCadenceType::Automatic : ENWPWeaponSimulationCadenceType::SemiAutomatic;
+
+		Simulations[Index].Configure(SimulationParams);
+		Simulations[Index].SetState(ENWPWeaponSimulationState::None);
+	}
+
+	float TimeOffsets[32];
+	int64 NumShots = 0;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Every weapon keeps the trigger pressed. The semi automatic ones shoot again as soon as they can
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		for (FNWPWeaponSimulation& Simulation : Simulations)
+		{
+			Simulation.UpdateCoolDown(StepTime);
+
+			if (Simulation.GetState() == ENWPWeaponSimulationState::Shooting)
+			{
+				if (Simulation.IsSubFrameFireAccumulatorActive())
+				{
+					NumShots += Simulation.ConsumeDueShots(StepTime, ARRAY_COUNT(TimeOffsets), TimeOffsets);
+				}
+				else if (!Simulation.IsCoolDownActive())
+				{
+					NumShots += Simulation.ConsumeShot() ? 1 : 0;
+				}
+			}
+			else if (Simulation.CanStartShooting())
+			{
+				if (Simulation.ConsumeShot())
+				{
+					++NumShots;
+
+					if (Simulation.GetCadenceType() == ENWPWeaponSimulationCadenceType::Automatic)
+					{
+						Simulation.SetState(ENWPWeaponSimulationState::Shooting);
+					}
+				}
+				// Refill the weapons without ammo, so every weapon keeps working
+				else if (Simulation.GetAmmo() == 0)
+				{
+					Simulation.Configure(Simulation.GetParams());
+				}
+			}
+		}
+	}
+
+	const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+	const double NumUpdates = (double)NumWeapons * NumSteps;
+
+	AddInfo(FString::Printf(TEXT("Weapons: %d Steps: %d StepTime: %.4f s Total: %.3f ms %.2f ns/update Shots: %lld"),
+		NumWeapons, NumSteps, StepTime, ElapsedTime * 1000.0, ElapsedTime * 1e9 / NumUpdates, NumShots));
+
+	TestTrue(TEXT("The weapons have been shooting"), NumShots > 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
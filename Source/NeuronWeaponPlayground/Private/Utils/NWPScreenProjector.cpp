@@ -0,0 +1,218 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPScreenProjector.h"
+
+// UE
+#include "ConvexVolume.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "SceneView.h"
+
+FNWPBatchedScreenProjector::FNWPBatchedScreenProjector()
+{
+	ViewProjectionMatrix = FMatrix::Identity;
+	InvViewProjectionMatrix = FMatrix::Identity;
+	ViewOrigin = FVector::ZeroVector;
+	ViewRect = FIntRect();
+	ViewRectMin = FVector2D::ZeroVector;
+	ViewRectSize = FVector2D::ZeroVector;
+	SetupFrame = 0;
+	bIsValid = false;
+}
+
+FORCEINLINE bool FNWPBatchedScreenProjector::ProjectPositionVectorized(const VectorRegister& _Row0, const VectorRegister& _Row1, const VectorRegister& _Row2,
+	const VectorRegister& _Row3, const FVector& _WorldPosition, FVector2D& _OutScreenPosition) const
+{
+	MS_ALIGN(16) float Result[4] GCC_ALIGN(16);
+
+	const VectorRegister Position = VectorLoadFloat3(&_WorldPosition);
+
+	VectorRegister Transformed = VectorMultiplyAdd(VectorReplicate(Position, 0), _Row0, _Row3);
+	Transformed = VectorMultiplyAdd(VectorReplicate(Position, 1), _Row1, Transformed);
+	Transformed = VectorMultiplyAdd(VectorReplicate(Position, 2), _Row2, Transformed);
+
+	VectorStoreAligned(Transformed, Result);
+
+	// Positions behind the view can not be projected
+	if (Result[3] <= 0.0f)
+	{
+		return false;
+	}
+
+	const float RHW = 1.0f / Result[3];
+
+	_OutScreenPosition.X = ViewRectMin.X + (Result[0] * RHW * 0.5f + 0.5f) * ViewRectSize.X;
+	_OutScreenPosition.Y = ViewRectMin.Y + (0.5f - Result[1] * RHW * 0.5f) * ViewRectSize.Y;
+
+	return true;
+}
+
+bool FNWPBatchedScreenProjector::Setup(class APlayerController* _PlayerController)
+{
+	// Early return if already built during this frame
+	if (bIsValid && SetupFrame == GFrameCounter)
+	{
+		return true;
+	}
+
+	bIsValid = false;
+	SetupFrame = GFrameCounter;
+
+	ULocalPlayer* LocalPlayer = _PlayerController ? _PlayerController->GetLocalPlayer() : nullptr;
+
+	// Early return if the player has no viewport
+	if (!LocalPlayer || !LocalPlayer->ViewportClient)
+	{
+		return false;
+	}
+
+	// Get the projection data the same way the player controller does
+	FSceneViewProjectionData ProjectionData;
+
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData))
+	{
+		return false;
+	}
+
+	SetupFromProjectionData(ProjectionData);
+
+	return true;
+}
+
+void FNWPBatchedScreenProjector::SetupFromProjectionData(const FSceneViewProjectionData& _ProjectionData)
+{
+	ViewRect = _ProjectionData.GetConstrainedViewRect();
+	ViewProjectionMatrix = _ProjectionData.ComputeViewProjectionMatrix();
+	InvViewProjectionMatrix = ViewProjectionMatrix.Inverse();
+	ViewOrigin = _ProjectionData.ViewOrigin;
+	ViewRectMin = FVector2D(ViewRect.Min.X, ViewRect.Min.Y);
+	ViewRectSize = FVector2D(ViewRect.Width(), ViewRect.Height());
+	bIsValid = true;
+}
+
+bool FNWPBatchedScreenProjector::ProjectPosition(const FVector& _WorldPosition, FVector2D& _OutScreenPosition) const
+{
+	// Early return if no view projection
+	if (!bIsValid)
+	{
+		return false;
+	}
+
+	const FPlane Result = ViewProjectionMatrix.TransformFVector4(FVector4(_WorldPosition, 1.0f));
+
+	// Early return if the position is behind the view
+	if (Result.W <= 0.0f)
+	{
+		return false;
+	}
+
+	const float RHW = 1.0f / Result.W;
+
+	_OutScreenPosition.X = ViewRectMin.X + (Result.X * RHW * 0.5f + 0.5f) * ViewRectSize.X;
+	_OutScreenPosition.Y = ViewRectMin.Y + (0.5f - Result.Y * RHW * 0.5f) * ViewRectSize.Y;
+
+	return true;
+}
+
+void FNWPBatchedScreenProjector::ProjectPositions(const TArray<FVector>& _WorldPositions, TArray<FVector2D>& _OutScreenPositions, TArray<bool>& _OutValidPositions) const
+{
+	const int32 NumPositions = _WorldPositions.Num();
+
+	_OutScreenPositions.SetNumUninitialized(NumPositions, false);
+	_OutValidPositions.SetNumUninitialized(NumPositions, false);
+
+	// Early return if no view projection
+	if (!bIsValid)
+	{
+		FMemory::Memzero(_OutValidPositions.GetData(), NumPositions * sizeof(bool));
+		return;
+	}
+
+	// Load the rows of the matrix once, every position is transformed with three multiply adds
+	const VectorRegister Row0 = VectorLoadAligned(&ViewProjectionMatrix.M[0][0]);
+	const VectorRegister Row1 = VectorLoadAligned(&ViewProjectionMatrix.M[1][0]);
+	const VectorRegister Row2 = VectorLoadAligned(&ViewProjectionMatrix.M[2][0]);
+	const VectorRegister Row3 = VectorLoadAligned(&ViewProjectionMatrix.M[3][0]);
+
+	for (int32 Index = 0; Index < NumPositions; ++Index)
+	{
+		_OutValidPositions[Index] = ProjectPositionVectorized(Row0, Row1, Row2, Row3, _WorldPositions[Index], _OutScreenPositions[Index]);
+	}
+}
+
+void FNWPBatchedScreenProjector::ProjectIndexedPositions(const TArray<FVector>& _WorldPositions, const TArray<int32>& _Indices, TArray<FVector2D>& _OutScreenPositions,
+	TArray<bool>& _OutValidPositions) const
+{
+	const int32 NumPositions = _WorldPositions.Num();
+
+	_OutScreenPositions.SetNumUninitialized(NumPositions, false);
+	_OutValidPositions.SetNumZeroed(NumPositions, false);
+
+	// Early return if no view projection
+	if (!bIsValid)
+	{
+		return;
+	}
+
+	const VectorRegister Row0 = VectorLoadAligned(&ViewProjectionMatrix.M[0][0]);
+	const VectorRegister Row1 = VectorLoadAligned(&ViewProjectionMatrix.M[1][0]);
+	const VectorRegister Row2 = VectorLoadAligned(&ViewProjectionMatrix.M[2][0]);
+	const VectorRegister Row3 = VectorLoadAligned(&ViewProjectionMatrix.M[3][0]);
+
+	for (int32 Index : _Indices)
+	{
+		_OutValidPositions[Index] = ProjectPositionVectorized(Row0, Row1, Row2, Row3, _WorldPositions[Index], _OutScreenPositions[Index]);
+	}
+}
+
+bool FNWPBatchedScreenProjector::BuildScreenRectFrustum(const FVector2D& _ScreenMin, const FVector2D& _ScreenMax, float _MaxDistance, struct FConvexVolume& _OutFrustum, 
+	FBox& _OutBounds) const
+{
+	// Early return if no view projection
+	if (!bIsValid || _MaxDistance <= 0.0f)
+	{
+		return false;
+	}
+
+	// Get the direction of the rays that go through the corners & the center of the rectangle
+	const FVector2D ScreenCorners[4] = { _ScreenMin, FVector2D(_ScreenMax.X, _ScreenMin.Y), _ScreenMax, FVector2D(_ScreenMin.X, _ScreenMax.Y) };
+	FVector CornerDirections[4];
+	FVector ViewDirection;
+	FVector RayOrigin;
+
+	FSceneView::DeprojectScreenToWorld((_ScreenMin + _ScreenMax) * 0.5f, ViewRect, InvViewProjectionMatrix, RayOrigin, ViewDirection);
+
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		FSceneView::DeprojectScreenToWorld(ScreenCorners[Index], ViewRect, InvViewProjectionMatrix, RayOrigin, CornerDirections[Index]);
+	}
+
+	_OutFrustum.Planes.Empty(6);
+	_OutBounds = FBox(ForceInit);
+	_OutBounds += ViewOrigin;
+
+	// Add a plane for each side of the rectangle. The normals point outside the frustum
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		const FVector& CornerDirection = CornerDirections[Index];
+		FVector PlaneNormal = (CornerDirection ^ CornerDirections[(Index + 1) % 4]).GetSafeNormal();
+
+		if ((PlaneNormal | ViewDirection) > 0.0f)
+		{
+			PlaneNormal = -PlaneNormal;
+		}
+
+		_OutFrustum.Planes.Add(FPlane(ViewOrigin, PlaneNormal));
+
+		// The corner rays reach the far plane further than the center ray
+		_OutBounds += ViewOrigin + CornerDirection * (_MaxDistance / FMath::Max(CornerDirection | ViewDirection, KINDA_SMALL_NUMBER));
+	}
+
+	// Close the frustum with the near & far planes
+	_OutFrustum.Planes.Add(FPlane(ViewOrigin, -ViewDirection));
+	_OutFrustum.Planes.Add(FPlane(ViewOrigin + ViewDirection * _MaxDistance, ViewDirection));
+	_OutFrustum.Init();
+
+	return true;
+}
@@ -0,0 +1,83 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPSparseSet.h"
+
+FNWPSparseSetHandle FNWPSparseSet::GetHandle(int32 _DenseIndex) const
+{
+	FNWPSparseSetHandle Handle;
+
+	// Check if the dense index is valid
+	if (!DenseToSparse.IsValidIndex(_DenseIndex))
+	{
+		return Handle;
+	}
+
+	Handle.Index = DenseToSparse[_DenseIndex];
+	Handle.Generation = SparseGenerations[Handle.Index];
+
+	return Handle;
+}
+
+FNWPSparseSetHandle FNWPSparseSet::Add()
+{
+	// Reuse a free sparse index if possible
+	int32 SparseIndex = INDEX_NONE;
+
+	if (FreeSparseIndices.Num() > 0)
+	{
+		SparseIndex = FreeSparseIndices.Pop(false);
+	}
+	else
+	{
+		SparseIndex = SparseToDense.Add(INDEX_NONE);
+		SparseGenerations.Add(0);
+	}
+
+	SparseToDense[SparseIndex] = DenseToSparse.Add(SparseIndex);
+
+	FNWPSparseSetHandle Handle;
+	Handle.Index = SparseIndex;
+	Handle.Generation = SparseGenerations[SparseIndex];
+
+	return Handle;
+}
+
+int32 FNWPSparseSet::Remove(const FNWPSparseSetHandle& _Handle)
+{
+	const int32 DenseIndex = GetDenseIndex(_Handle);
+
+	// Early return if the handle is stale
+	if (DenseIndex == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	// Move the last element to the removed slot
+	const int32 LastSparseIndex = DenseToSparse.Last();
+	DenseToSparse.RemoveAtSwap(DenseIndex, 1, false);
+
+	if (LastSparseIndex != _Handle.Index)
+	{
+		SparseToDense[LastSparseIndex] = DenseIndex;
+	}
+
+	// Free the sparse index. The new generation makes the removed handle stale
+	SparseToDense[_Handle.Index] = INDEX_NONE;
+	++SparseGenerations[_Handle.Index];
+	FreeSparseIndices.Add(_Handle.Index);
+
+	return DenseIndex;
+}
+
+void FNWPSparseSet::Empty()
+{
+	// Keep the generations, so the handles given before stay stale
+	for (int32 SparseIndex : DenseToSparse)
+	{
+		SparseToDense[SparseIndex] = INDEX_NONE;
+		++SparseGenerations[SparseIndex];
+		FreeSparseIndices.Add(SparseIndex);
+	}
+
+	DenseToSparse.Reset();
+}
@@ -0,0 +1,236 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPTargetRanking.h"
+
+FNWPTargetRanking::FNWPTargetRanking()
+{
+	Policy = ENWPTargetAllocationPolicy::BestAngle;
+	AllocationCounter = 0;
+	UpdateCounter = 0;
+}
+
+void FNWPTargetRanking::SetPolicy(ENWPTargetAllocationPolicy _Policy)
+{
+	// Early return if nothing changes
+	if (Policy == _Policy)
+	{
+		return;
+	}
+
+	Policy = _Policy;
+
+	// Rank the targets again with the new policy
+	for (int32 HeapIndex = Heap.Num() / 2 - 1; HeapIndex >= 0; --HeapIndex)
+	{
+		FixHeapIndex(HeapIndex);
+	}
+}
+
+void FNWPTargetRanking::BeginUpdate()
+{
+	++UpdateCounter;
+}
+
+void FNWPTargetRanking::RankTarget(const AActor* _Target, float _Alignment)
+{
+	int32* HeapIndex = HeapIndices.Find(_Target);
+
+	// Add the target at the end of the heap
+	if (!HeapIndex)
+	{
+		const int32* NumAssignments = Assignments.Find(_Target);
+
+		const int32 NewHeapIndex = Heap.AddDefaulted();
+		Heap[NewHeapIndex].Target = _Target;
+		Heap[NewHeapIndex].NumAssignments = NumAssignments ? *NumAssignments : 0;
+
+		HeapIndex = &HeapIndices.Add(_Target, NewHeapIndex);
+	}
+
+	FNWPTargetRankingEntry& Entry = Heap[*HeapIndex];
+	Entry.Alignment = _Alignment;
+	Entry.UpdateStamp = UpdateCounter;
+
+	FixHeapIndex(*HeapIndex);
+}
+
+void FNWPTargetRanking::EndUpdate()
+{
+	// Find the targets first, the removals move the entries of the heap
+	StaleTargets.Reset();
+
+	for (const FNWPTargetRankingEntry& Entry : Heap)
+	{
+		if (Entry.UpdateStamp != UpdateCounter)
+		{
+			StaleTargets.Add(Entry.Target);
+		}
+	}
+
+	for (const TWeakObjectPtr<const AActor>& StaleTarget : StaleTargets)
+	{
+		RemoveAtHeapIndex(HeapIndices[StaleTarget]);
+	}
+
+	// Forget the assignments to the targets that have been destroyed
+	for (auto It = Assignments.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+const AActor* FNWPTargetRanking::AllocateTarget()
+{
+	// Remove the best targets that have been destroyed since the last update
+	while (Heap.Num() > 0 && !Heap[0].Target.IsValid())
+	{
+		RemoveAtHeapIndex(0);
+	}
+
+	// Early return if there are no targets
+	if (Heap.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	FNWPTargetRankingEntry& Entry = Heap[0];
+	const AActor* Target = Entry.Target.Get();
+
+	Entry.LastAllocation = ++AllocationCounter;
+	Entry.NumAssignments = ++Assignments.FindOrAdd(Target);
+
+	// The selected target can only get worse
+	FixHeapIndex(0);
+
+	return Target;
+}
+
+void FNWPTargetRanking::ReleaseTarget(const AActor* _Target)
+{
+	int32* NumAssignments = Assignments.Find(_Target);
+
+	// Early return if the target has no assignments
+	if (!NumAssignments)
+	{
+		return;
+	}
+
+	const int32 NumAssignmentsLeft = --(*NumAssignments);
+
+	if (NumAssignmentsLeft <= 0)
+	{
+		Assignments.Remove(_Target);
+	}
+
+	// Update the ranking if the target is ranked
+	if (const int32* HeapIndex = HeapIndices.Find(_Target))
+	{
+		Heap[*HeapIndex].NumAssignments = FMath::Max(NumAssignmentsLeft, 0);
+		FixHeapIndex(*HeapIndex);
+	}
+}
+
+void FNWPTargetRanking::Empty()
+{
+	Heap.Empty();
+	HeapIndices.Empty();
+	Assignments.Empty();
+	AllocationCounter = 0;
+}
+
+bool FNWPTargetRanking::IsBetter(int32 _HeapIndexA, int32 _HeapIndexB) const
+{
+	const FNWPTargetRankingEntry& EntryA = Heap[_HeapIndexA];
+	const FNWPTargetRankingEntry& EntryB = Heap[_HeapIndexB];
+
+	switch (Policy)
+	{
+	case ENWPTargetAllocationPolicy::RoundRobin:
+		// The target selected the longest time ago. The new targets are selected first
+		if (EntryA.LastAllocation != EntryB.LastAllocation)
+		{
+			return EntryA.LastAllocation < EntryB.LastAllocation;
+		}
+		break;
+
+	case ENWPTargetAllocationPolicy::FewestAssignments:
+		// The target followed by the fewest projectiles
+		if (EntryA.NumAssignments != EntryB.NumAssignments)
+		{
+			return EntryA.NumAssignments < EntryB.NumAssignments;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	// The target with the smallest angle with respect to the weapon forward
+	return EntryA.Alignment > EntryB.Alignment;
+}
+
+void FNWPTargetRanking::FixHeapIndex(int32 _HeapIndex)
+{
+	// Move the entry up while it is better than its parent
+	while (_HeapIndex > 0 && IsBetter(_HeapIndex, (_HeapIndex - 1) / 2))
+	{
+		SwapHeapIndices(_HeapIndex, (_HeapIndex - 1) / 2);
+		_HeapIndex = (_HeapIndex - 1) / 2;
+	}
+
+	// Move the entry down while one of its children is better
+	for (;;)
+	{
+		const int32 LeftChild = _HeapIndex * 2 + 1;
+		const int32 RightChild = LeftChild + 1;
+		int32 BestHeapIndex = _HeapIndex;
+
+		if (LeftChild < Heap.Num() && IsBetter(LeftChild, BestHeapIndex))
+		{
+			BestHeapIndex = LeftChild;
+		}
+
+		if (RightChild < Heap.Num() && IsBetter(RightChild, BestHeapIndex))
+		{
+			BestHeapIndex = RightChild;
+		}
+
+		if (BestHeapIndex == _HeapIndex)
+		{
+			break;
+		}
+
+		SwapHeapIndices(_HeapIndex, BestHeapIndex);
+		_HeapIndex = BestHeapIndex;
+	}
+}
+
+void FNWPTargetRanking::SwapHeapIndices(int32 _HeapIndexA, int32 _HeapIndexB)
+{
+	Heap.Swap(_HeapIndexA, _HeapIndexB);
+	HeapIndices[Heap[_HeapIndexA].Target] = _HeapIndexA;
+	HeapIndices[Heap[_HeapIndexB].Target] = _HeapIndexB;
+}
+
+void FNWPTargetRanking::RemoveAtHeapIndex(int32 _HeapIndex)
+{
+	const int32 LastHeapIndex = Heap.Num() - 1;
+
+	HeapIndices.Remove(Heap[_HeapIndex].Target);
+
+	// Move the last entry to the removed place & fix it
+	if (_HeapIndex != LastHeapIndex)
+	{
+		Heap[_HeapIndex] = Heap[LastHeapIndex];
+		HeapIndices[Heap[_HeapIndex].Target] = _HeapIndex;
+		Heap.RemoveAt(LastHeapIndex, 1, false);
+		FixHeapIndex(_HeapIndex);
+	}
+	else
+	{
+		Heap.RemoveAt(LastHeapIndex, 1, false);
+	}
+}
@@ -0,0 +1,69 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPTimerWheel.h"
+
+FNWPTimerWheel::FNWPTimerWheel()
+{
+	SlotDuration = 1.0f;
+	CurrentTick = 0;
+	NumTimers = 0;
+}
+
+void FNWPTimerWheel::Initialize(float _SlotDuration, int32 _NumSlots)
+{
+	SlotDuration = FMath::Max(_SlotDuration, KINDA_SMALL_NUMBER);
+	CurrentTick = 0;
+	NumTimers = 0;
+
+	Slots.Empty();
+	Slots.SetNum((int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(_NumSlots, 1)));
+}
+
+void FNWPTimerWheel::Schedule(int32 _Item, uint32 _Id, double _ExpiryTime)
+{
+	// The timers that have already expired go to the current slot, so they expire in the next advance
+	const int64 Tick = FMath::Max(GetTick(_ExpiryTime), CurrentTick);
+
+	FNWPTimerWheelEntry& Entry = Slots[Tick & (Slots.Num() - 1)].AddDefaulted_GetRef();
+	Entry.Item = _Item;
+	Entry.Id = _Id;
+	Entry.ExpiryTime = _ExpiryTime;
+
+	++NumTimers;
+}
+
+void FNWPTimerWheel::Advance(double _CurrentTime, TFunctionRef<bool(int32 _Item, uint32 _Id)> _IsTimerValid, TArray<int32>& _OutExpiredItems)
+{
+	const int64 TargetTick = FMath::Max(GetTick(_CurrentTime), CurrentTick);
+
+	// Visit the slots from the current one. Each slot is visited once even if more than a full turn has elapsed
+	const int64 NumTicksToVisit = FMath::Min(TargetTick - CurrentTick + 1, (int64)Slots.Num());
+
+	for (int64 Tick = CurrentTick; Tick < CurrentTick + NumTicksToVisit; ++Tick)
+	{
+		TArray<FNWPTimerWheelEntry>& Slot = Slots[Tick & (Slots.Num() - 1)];
+
+		// Iterate backwards, so the removed timers are replaced by visited ones
+		for (int32 EntryIndex = Slot.Num() - 1; EntryIndex >= 0; --EntryIndex)
+		{
+			const FNWPTimerWheelEntry& Entry = Slot[EntryIndex];
+			const bool bIsValid = _IsTimerValid(Entry.Item, Entry.Id);
+
+			// Keep the timers of the next turns
+			if (bIsValid && Entry.ExpiryTime > _CurrentTime)
+			{
+				continue;
+			}
+
+			if (bIsValid)
+			{
+				_OutExpiredItems.Add(Entry.Item);
+			}
+
+			Slot.RemoveAtSwap(EntryIndex, 1, false);
+			--NumTimers;
+		}
+	}
+
+	CurrentTick = TargetTick;
+}
@@ -0,0 +1,267 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPTraceQuality.h"
+
+// UE
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+// Stats
+DECLARE_DWORD_COUNTER_STAT(TEXT("Trace Quality Comparisons"), STAT_NWPTraceQualityComparisons, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Trace Quality Changed Results"), STAT_NWPTraceQualityChangedResults, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Two Phase Traces"), STAT_NWPTwoPhaseTraces, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Two Phase Complex Refinements"), STAT_NWPTwoPhaseRefinements, STATGROUP_NWP);
+DECLARE_CYCLE_STAT(TEXT("Two Phase Complex Refinement"), STAT_NWPTwoPhaseRefinement, STATGROUP_NWP);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Two Phase Time Saved (us)"), STAT_NWPTwoPhaseTimeSaved, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Two Phase Mismatches"), STAT_NWPTwoPhaseMismatches, STATGROUP_NWP);
+
+// Console variables
+static TAutoConsoleVariable<int32> CVarbAuditTraceQuality(
+	TEXT("NWP.bAuditTraceQuality"),
+	0,
+	TEXT("Whether the obstacle & hitscan traces are also done against the collision their quality skips, to record how often the result changes.\n")
+	TEXT("The returned results are not changed. See NWP.ReportTraceQuality.\n"),
+	ECVF_Default);
+
+// Distance added before & after the refinement window, so the complex hit is not lost by precision
+static const float TwoPhaseWindowMargin = 1.0f;
+
+// Number of simple hits refined before tracing the rest of the segment against the complex collision
+static const int32 MaxTwoPhaseRefinements = 4;
+
+// Records of the traces done against both collisions, per map & category
+static TMap<FString, TArray<FNWPTraceQualityRecord>> TraceQualityRecords;
+
+// Console commands
+static FAutoConsoleCommandWithArgs ReportTraceQualityCommand(
+	TEXT("NWP.ReportTraceQuality"),
+	TEXT("Writes to the log, per map & kind of trace, how often the complex collision changes the result of the simple collision.\n")
+	TEXT("Only the traces done against both collisions are recorded. Enable NWP.bAuditTraceQuality to record every trace.\n")
+	TEXT("Usage: NWP.ReportTraceQuality [Reset]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FNWPTraceQuality::LogRecords();
+
+		if (Args.Num() > 0 && Args[0].Equals(TEXT("Reset"), ESearchCase::IgnoreCase))
+		{
+			FNWPTraceQuality::ResetRecords();
+		}
+	}));
+
+bool FNWPTraceQuality::IsFirstTraceComplex(ENWPTraceQuality _Quality)
+{
+	// The audit needs the simple result of every trace
+	return _Quality == ENWPTraceQuality::Complex && !CVarbAuditTraceQuality.GetValueOnGameThread();
+}
+
+bool FNWPTraceQuality::IsAuditEnabled()
+{
+	return CVarbAuditTraceQuality.GetValueOnGameThread() != 0;
+}
+
+bool FNWPTraceQuality::LineTraceSingleByChannel(UWorld* _World, FHitResult& _OutHit, const FVector& _Start, const FVector& _End, ECollisionChannel _Channel, 
+	const FCollisionQueryParams& _QueryParams, ENWPTraceQuality _Quality, ENWPTraceCategory _Category)
+{
+	FCollisionQueryParams FirstQueryParams = _QueryParams;
+	FirstQueryParams.bTraceComplex = IsFirstTraceComplex(_Quality);
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+	const bool bFirstHit = _World->LineTraceSingleByChannel(_OutHit, _Start, _End, _Channel, FirstQueryParams);
+
+	return RefineFirstTrace(_World, bFirstHit, _OutHit, _Start, _End, _Channel, _QueryParams, _Quality, _Category, FPlatformTime::Cycles() - StartCycles);
+}
+
+bool FNWPTraceQuality::RefineFirstTrace(UWorld* _World, bool _bFirstHit, FHitResult& _InOutHit, const FVector& _Start, const FVector& _End, ECollisionChannel _Channel, 
+	const FCollisionQueryParams& _QueryParams, ENWPTraceQuality _Quality, ENWPTraceCategory _Category, uint32 _FirstTraceCycles)
+{
+	// Early return if the first trace was already complex
+	if (IsFirstTraceComplex(_Quality))
+	{
+		return _bFirstHit;
+	}
+
+	const bool bAudit = IsAuditEnabled();
+	const bool bTwoPhase = _Quality == ENWPTraceQuality::SimpleThenComplex;
+	const bool bUseComplexResult = _Quality == ENWPTraceQuality::Complex || (bTwoPhase && _bFirstHit);
+
+	INC_DWORD_STAT_BY(STAT_NWPTwoPhaseTraces, bTwoPhase ? 1 : 0);
+
+	// Early return if the simple result is enough and the traces are not audited
+	if (!bUseComplexResult && !bAudit)
+	{
+		return _bFirstHit;
+	}
+
+	FCollisionQueryParams ComplexQueryParams = _QueryParams;
+	ComplexQueryParams.bTraceComplex = true;
+
+	FHitResult ComplexHit;
+	bool bComplexHit = false;
+	uint32 RefinementCycles = 0;
+
+	// Refine the simple hit with short complex traces around it
+	if (bTwoPhase && _bFirstHit)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NWPTwoPhaseRefinement);
+
+		const uint32 StartCycles = FPlatformTime::Cycles();
+		bComplexHit = TraceComplexAroundSimpleHit(_World, _InOutHit, ComplexHit, _Start, _End, _Channel, _QueryParams);
+		RefinementCycles = FPlatformTime::Cycles() - StartCycles;
+	}
+
+	// Trace the complex collision over the whole segment if there is no simple hit to refine or the traces are audited
+	if (!bTwoPhase || !_bFirstHit || bAudit)
+	{
+		const uint32 StartCycles = FPlatformTime::Cycles();
+
+		FHitResult FullComplexHit;
+		const bool bFullComplexHit = _World->LineTraceSingleByChannel(FullComplexHit, _Start, _End, _Channel, ComplexQueryParams);
+
+		const uint32 FullComplexCycles = FPlatformTime::Cycles() - StartCycles;
+
+		if (bTwoPhase && _bFirstHit)
+		{
+			// Measure the two phases against tracing the whole segment against the complex collision
+			const double TimeSaved = FPlatformTime::ToMilliseconds(FullComplexCycles) - FPlatformTime::ToMilliseconds(_FirstTraceCycles + RefinementCycles);
+			const bool bMismatch = bComplexHit != bFullComplexHit || (bComplexHit && ComplexHit.GetActor() != FullComplexHit.GetActor());
+
+			INC_FLOAT_STAT_BY(STAT_NWPTwoPhaseTimeSaved, (float)(TimeSaved * 1000.0));
+			INC_DWORD_STAT_BY(STAT_NWPTwoPhaseMismatches, bMismatch ? 1 : 0);
+		}
+		else
+		{
+			ComplexHit = FullComplexHit;
+			bComplexHit = bFullComplexHit;
+		}
+	}
+
+	RecordComparison(_World, _Category, _bFirstHit, _InOutHit, bComplexHit, ComplexHit);
+
+	// Keep the simple result if the quality does not use the complex one
+	if (!bUseComplexResult)
+	{
+		return _bFirstHit;
+	}
+
+	_InOutHit = ComplexHit;
+	return bComplexHit;
+}
+
+bool FNWPTraceQuality::TraceComplexAroundSimpleHit(UWorld* _World, const FHitResult& _SimpleHit, FHitResult& _OutHit, const FVector& _Start, const FVector& _End, 
+	ECollisionChannel _Channel, const FCollisionQueryParams& _QueryParams)
+{
+	FCollisionQueryParams SimpleQueryParams = _QueryParams;
+	SimpleQueryParams.bTraceComplex = false;
+
+	FCollisionQueryParams ComplexQueryParams = _QueryParams;
+	ComplexQueryParams.bTraceComplex = true;
+
+	const float SegmentLength = FVector::Dist(_Start, _End);
+	const FVector Direction = (_End - _Start).GetSafeNormal();
+	FHitResult SimpleHit = _SimpleHit;
+	float WindowEnd = 0.0f;
+
+	for (int32 Refinement = 0; Refinement < MaxTwoPhaseRefinements; ++Refinement)
+	{
+		INC_DWORD_STAT(STAT_NWPTwoPhaseRefinements);
+
+		float WindowBegin;
+		ComputeRefinementWindow(SimpleHit, _Start, _End, WindowEnd, WindowBegin, WindowEnd);
+
+		// Trace the complex collision inside the window
+		if (_World->LineTraceSingleByChannel(_OutHit, _Start + Direction * WindowBegin, _Start + Direction * WindowEnd, _Channel, ComplexQueryParams))
+		{
+			MakeHitRelativeToSegment(_OutHit, WindowBegin, _Start, _End);
+			return true;
+		}
+
+		// Look for the next simple hit after the window. The complex collision has a hole where the simple one has been hit
+		if (WindowEnd >= SegmentLength || !_World->LineTraceSingleByChannel(SimpleHit, _Start + Direction * WindowEnd, _End, _Channel, SimpleQueryParams))
+		{
+			return false;
+		}
+	}
+
+	// Too many simple hits without complex hit, trace the rest of the segment against the complex collision
+	if (_World->LineTraceSingleByChannel(_OutHit, _Start + Direction * WindowEnd, _End, _Channel, ComplexQueryParams))
+	{
+		MakeHitRelativeToSegment(_OutHit, WindowEnd, _Start, _End);
+		return true;
+	}
+
+	return false;
+}
+
+void FNWPTraceQuality::ComputeRefinementWindow(const FHitResult& _SimpleHit, const FVector& _Start, const FVector& _End, float _MinDistance, float& _OutWindowBegin,
+	float& _OutWindowEnd)
+{
+	const float SegmentLength = FVector::Dist(_Start, _End);
+	const FVector Direction = (_End - _Start).GetSafeNormal();
+
+	// The complex collision of the hit component is inside its bounds, so the window ends after crossing them
+	const float HitDistance = (_SimpleHit.Location - _Start) | Direction;
+	const float HitComponentSize = _SimpleHit.Component.IsValid() ? _SimpleHit.Component->Bounds.SphereRadius * 2.0f : SegmentLength;
+	_OutWindowBegin = FMath::Clamp(HitDistance - TwoPhaseWindowMargin, _MinDistance, SegmentLength);
+	_OutWindowEnd = FMath::Clamp(HitDistance + HitComponentSize + TwoPhaseWindowMargin, _OutWindowBegin, SegmentLength);
+}
+
+void FNWPTraceQuality::MakeHitRelativeToSegment(FHitResult& _InOutHit, float _TraceBeginDistance, const FVector& _Start, const FVector& _End)
+{
+	const float SegmentLength = FVector::Dist(_Start, _End);
+
+	_InOutHit.Distance += _TraceBeginDistance;
+	_InOutHit.Time = SegmentLength > 0.0f ? _InOutHit.Distance / SegmentLength : 0.0f;
+	_InOutHit.TraceStart = _Start;
+	_InOutHit.TraceEnd = _End;
+}
+
+void FNWPTraceQuality::RecordComparison(UWorld* _World, ENWPTraceCategory _Category, bool _bSimpleHit, const FHitResult& _SimpleHit, bool _bComplexHit, 
+	const FHitResult& _ComplexHit)
+{
+	const bool bChanged = _bSimpleHit != _bComplexHit || (_bComplexHit && _SimpleHit.GetActor() != _ComplexHit.GetActor());
+
+	// Record the comparison for the map
+	TArray<FNWPTraceQualityRecord>& MapRecords = TraceQualityRecords.FindOrAdd(UWorld::RemovePIEPrefix(_World->GetMapName()));
+	MapRecords.SetNum((int32)ENWPTraceCategory::COUNT);
+
+	FNWPTraceQualityRecord& Record = MapRecords[(int32)_Category];
+	++Record.NumCompared;
+	Record.NumSimpleHits += _bSimpleHit ? 1 : 0;
+	Record.NumComplexHits += _bComplexHit ? 1 : 0;
+	Record.NumChanged += bChanged ? 1 : 0;
+
+	INC_DWORD_STAT(STAT_NWPTraceQualityComparisons);
+	INC_DWORD_STAT_BY(STAT_NWPTraceQualityChangedResults, bChanged ? 1 : 0);
+}
+
+void FNWPTraceQuality::LogRecords()
+{
+	if (TraceQualityRecords.Num() == 0)
+	{
+		UE_LOG(LogNWP, Log, TEXT("FNWPTraceQuality: No traces have been done against both collisions"));
+		return;
+	}
+
+	for (const TPair<FString, TArray<FNWPTraceQualityRecord>>& MapRecords : TraceQualityRecords)
+	{
+		for (int32 CategoryIndex = 0; CategoryIndex < MapRecords.Value.Num(); ++CategoryIndex)
+		{
+			const FNWPTraceQualityRecord& Record = MapRecords.Value[CategoryIndex];
+
+			// Skip the kinds of traces that have not been compared
+			if (Record.NumCompared == 0)
+			{
+				continue;
+			}
+
+			UE_LOG(LogNWP, Log, TEXT("FNWPTraceQuality: Map: %s Trace: %s Compared: %d Simple hits: %d Complex hits: %d Changed: %d (%.2f%%)"),
+				*MapRecords.Key, CategoryIndex == (int32)ENWPTraceCategory::Obstacle ? TEXT("Obstacle") : TEXT("Hitscan"), Record.NumCompared,
+				Record.NumSimpleHits, Record.NumComplexHits, Record.NumChanged, Record.NumChanged * 100.0f / Record.NumCompared);
+		}
+	}
+}
+
+void FNWPTraceQuality::ResetRecords()
+{
+	TraceQualityRecords.Empty();
+}
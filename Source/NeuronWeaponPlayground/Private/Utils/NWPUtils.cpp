@@ -1,3 +1,3 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPUtils.h"
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPUtils.h"
@@ -1,429 +1,904 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPSmartWeapon.h"
-
-// UE
-#include "GameFramework/PlayerController.h"
-#include "Engine/UserInterfaceSettings.h"
-#include "Kismet/KismetMathLibrary.h"
-#include "DrawDebugHelpers.h"
-
-// NWP
-#include "NWPTarget.h"
-#include "NWPUtils.h"
-
-ANWPSmartWeapon::ANWPSmartWeapon(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
-{
-	TargetAreaBeginPosition = FVector2D::ZeroVector;
-	TargetArea = FVector2D::ZeroVector;
-	CurrentUpdateProjectilesTime = 0.0f;
-}
-
-void ANWPSmartWeapon::Tick(float DeltaSeconds)
-{
-	Super::Tick(DeltaSeconds);
-
-	// Calculate the viewport target positions
-	CalculateViewportTargetPositions();
-
-	// Execute the update methods 
-	UpdateTargets();
-
-	UpdateSmartProjectiles(DeltaSeconds);
-}
-
-void ANWPSmartWeapon::OnWeaponLoaded()
-{
-	Super::OnWeaponLoaded();
-
-	// Calculate the viewport target positions
-	CalculateViewportTargetPositions();
-}
-
-bool ANWPSmartWeapon::HasTargetToShoot()
-{
-	return CurrentTargets.Num() != 0;
-}
-
-const AActor* ANWPSmartWeapon::GetTargetToShoot()
-{
-	// Check if there is any target
-	if (CurrentTargets.Num() == 0)
-	{
-		return nullptr;
-	}
-
-	//// Simple heuristic, random between the current targets
-	//return CurrentTargets[FMath::RandRange(0, CurrentTargets.Num() - 1)];
-
-	// Better heuristic: Select the target which, from its position, has the smallest angle with respect to the weapon forward
-	int32 SelectedTargetIndex = -1;
-	float BestAngle = MAX_flt;
-
-	for (int32 Index = 0; Index < CurrentTargets.Num(); ++Index)
-	{
-		FVector TargetToFromWeaponToTarget = (CurrentTargets[Index]->GetActorLocation() - GetActorLocation()).GetSafeNormal();
-		float AngleToProcess = FMath::RadiansToDegrees(FMath::Acos(GetActorForwardVector() | TargetToFromWeaponToTarget));
-
-		if (AngleToProcess < BestAngle)
-		{
-			BestAngle = AngleToProcess;
-			SelectedTargetIndex = Index;
-		}
-	}
-
-	return CurrentTargets[SelectedTargetIndex];
-}
-
-void ANWPSmartWeapon::CalculateViewportTargetPositions()
-{
-	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
-
-	// Early return if invalid weapon config
-	if (!SmartWeaponConfig)
-	{
-		return;
-	}
-
-	// Evaluate if the potential targets are inside the target area
-	if (OwnerCharacter)
-	{
-		APlayerController* OwnerPlayerController = Cast<APlayerController>(OwnerCharacter->GetController());
-
-		if (OwnerPlayerController)
-		{
-			int32 ViewportSizeX = -1.0f;
-			int32 ViewportSizeY = -1.0f;
-
-			OwnerPlayerController->GetViewportSize(ViewportSizeX, ViewportSizeY);
-
-			// TODO: [NWP-REVIEW] Use values that are independent from resolution or develop some scale system
-
-			// Check if valid viewport size
-			if (ViewportSizeX > 0 && ViewportSizeY > 0)
-			{
-				// Calculate the target area positions
-				TargetAreaBeginPosition.X = (ViewportSizeX - SmartWeaponConfig->GetHorizontalTargetArea()) / 2;
-				TargetAreaBeginPosition.Y = (ViewportSizeY - SmartWeaponConfig->GetVerticalTargetArea()) / 2;
-				TargetArea.X = SmartWeaponConfig->GetHorizontalTargetArea();
-				TargetArea.Y = SmartWeaponConfig->GetVerticalTargetArea();
-			}
-		}
-	}
-}
-
-void ANWPSmartWeapon::UpdateTargets()
-{
-	UWorld* World = GetWorld();
-	TArray<AActor*> PotentialTargets;
-	TArray<AActor*> TargetsToRemoveFromCache;
-
-	// Evaluate rendered actors
-	// TODO: [NWP-REVIEW] ANWPTarget should be a component and not an actor due to potential deadly diamond of death problems
-	for (TObjectIterator<class ANWPTarget> It; It; ++It)
-	{
-		if (It->GetWorld() == World)
-		{
-			PotentialTargets.Add(*It);
-		}
-	}
-
-	// Evaluate if the potential targets are inside the target area
-	for (int32 Index = 0; Index < PotentialTargets.Num(); ++Index)
-	{
-		// TODO: [NWP-REVIEW] Consider checking bounding box projection onto the viewport
-		if (IsActorInsideTargetArea(PotentialTargets[Index]))
-		{
-			CurrentTargets.AddUnique(PotentialTargets[Index]);
-		}
-		else if(CurrentTargets.Contains(PotentialTargets[Index]))
-		{
-			TargetsToRemoveFromCache.AddUnique(PotentialTargets[Index]);
-		}
-	}
-
-	// Remove the targets that left the target area
-	for (int32 Index = 0; Index < TargetsToRemoveFromCache.Num(); ++Index)
-	{
-		CurrentTargets.RemoveSingle(TargetsToRemoveFromCache[Index]);
-	}
-	TargetsToRemoveFromCache.Empty();
-}
-
-bool ANWPSmartWeapon::IsActorInsideTargetArea(class AActor* ActorToEvaluate)
-{
-	APlayerController* OwnerPlayerController = Cast<APlayerController>(OwnerCharacter->GetController());
-	FVector2D TargetScreenLocation;
-
-	// Transform world coordinates to screen coordinates
-	OwnerPlayerController->ProjectWorldLocationToScreen(ActorToEvaluate->GetActorLocation(), TargetScreenLocation);
-
-	return (TargetScreenLocation.X > TargetAreaBeginPosition.X  && TargetScreenLocation.X < TargetAreaBeginPosition.X + TargetArea.X) &&
-		(TargetScreenLocation.Y > TargetAreaBeginPosition.Y && TargetScreenLocation.Y < TargetAreaBeginPosition.Y + TargetArea.Y);
-}
-
-void ANWPSmartWeapon::SpawProjectile()
-{
-	Super::SpawProjectile();
-
-	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
-
-	// Early return if invalid weapon config or no projectile configured
-	if (!SmartWeaponConfig || !SmartWeaponConfig->GetDefaultProjectileClass().Get())
-	{
-		return;
-	}
-
-	checkf(SmartWeaponConfig->ShouldUseProjectileAsAmmo(), TEXT("ANWPSmartWeapon::SpawProjectile: Smart Weapons should always use projectiles"));
-
-	// Add the last spawned actor to the map if there is at least one target
-	if (HasTargetToShoot())
-	{
-		SmartProjectiles.Add(CurrentSpawnedProjectiles[CurrentSpawnedProjectiles.Num() - 1], FNWPSmartProjectileData(GetTargetToShoot()));
-	}
-}
-
-FVector ANWPSmartWeapon::GetAvoidObstaclePoint(class ANWPProjectile* _ProjectileToProcess, class AActor* TargetObstacle)
-{
-	// TODO: [NWP-REVIEW] This heuristic is simple and work most of the times
-	// In order to have a better heuristic, i will need more time and iterate more on the Gameplay mechanic
-	// Consider to add some noise to the selected point
-
-	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
-
-	// Early return if no projectile, smart weapon config or the projectile is not in the map
-	if (!_ProjectileToProcess || !SmartWeaponConfig || !SmartProjectiles.Contains(_ProjectileToProcess))
-	{
-		return FVector::ZeroVector;
-	}
-
-	// Get the bounding box
-	FBox HitActorBoundingBox = TargetObstacle->GetComponentsBoundingBox();
-	TArray<FVector> BoundsPoints;
-
-	// Calculate the diagonal of the bounding box in XY
-	FVector BoundingBoxSize = HitActorBoundingBox.GetSize();
-	float HalfBoundingBoxXYDiagonal = FMath::Sqrt(BoundingBoxSize.X * BoundingBoxSize.X + BoundingBoxSize.Y * BoundingBoxSize.Y) / 2.0f;
-
-	// Calculate relevant points
-	FVector RightPoint = TargetObstacle->GetActorLocation() + (_ProjectileToProcess->GetActorRightVector() * (HalfBoundingBoxXYDiagonal + SmartWeaponConfig->GetAvoidObstacleHorizontalOffset()));
-	FVector LeftPoint = TargetObstacle->GetActorLocation() - (_ProjectileToProcess->GetActorRightVector() * (HalfBoundingBoxXYDiagonal + SmartWeaponConfig->GetAvoidObstacleHorizontalOffset()));
-	FVector UpPoint = TargetObstacle->GetActorLocation() + (TargetObstacle->GetActorUpVector() * (BoundingBoxSize.Z / 2.0f + SmartWeaponConfig->GetAvoidObstacleVerticalOffset()));
-
-	// Get the closest relevant point to the projectile
-	TArray<FVector> RelevantPoints;
-	int32 SelectedPoint = -1.0f;
-	float CurrentBestSquareDistance = -1.0f;
-
-	// Create a list of relevant points
-	RelevantPoints.Add(RightPoint);
-	RelevantPoints.Add(LeftPoint);
-	RelevantPoints.Add(UpPoint);
-
-	// Loop the relevant points list and found the closest one
-	for (int32 Index = 0; Index < RelevantPoints.Num(); ++Index)
-	{
-		float DistanceToCheck = (RelevantPoints[Index] - _ProjectileToProcess->GetActorLocation()).SizeSquared();
-
-		if (SelectedPoint < 0)
-		{
-			SelectedPoint = Index;
-			CurrentBestSquareDistance = DistanceToCheck;
-		}
-		else
-		{
-			// Evaluate if the point is closer than the current one
-			if (DistanceToCheck < CurrentBestSquareDistance)
-			{
-				SelectedPoint = Index;
-				CurrentBestSquareDistance = DistanceToCheck;
-			}
-		}
-	}
-
-	// Draw some debug data
-#if !UE_BUILD_SHIPPING 
-	if (CVarbDebugWeapon.GetValueOnGameThread())
-	{
-		// Obstacle bounding box
-		DrawDebugBox(GetWorld(), HitActorBoundingBox.GetCenter(), HitActorBoundingBox.GetExtent(), FColor::Red, true, 1.0f);
-
-		// Relevant points
-		DrawDebugSphere(GetWorld(), RightPoint, 20.0f, 10, FColor::Blue, false, 1.0f, 0, 3.0f);
-		DrawDebugSphere(GetWorld(), LeftPoint, 20.0f, 10, FColor::Blue, false, 1.0f, 0, 3.0f);
-		DrawDebugSphere(GetWorld(), UpPoint, 20.0f, 10, FColor::Blue, false, 1.0f, 0, 3.0f);
-
-		// Selected point
-		DrawDebugSphere(GetWorld(), RelevantPoints[SelectedPoint], 20.0f, 10, FColor::Green, false, 1.0f, 0, 3.0f);
-	}
-#endif
-
-	// Return the selected point
-	return RelevantPoints[SelectedPoint];
-}
-
-void ANWPSmartWeapon::UpdateSmartProjectiles(float DeltaTime)
-{
-	// Check if we can update the projectiles
-	if (CurrentUpdateProjectilesTime != 0.0f)
-	{
-		return;
-	}
-
-	// Update each projectile
-	for (auto It = SmartProjectiles.CreateConstIterator(); It; ++It)
-	{
-		UpdateSmartProjectile(It.Key(), DeltaTime);
-	}
-
-	// Recalculate the projectile update time
-	CurrentUpdateProjectilesTime = FMath::Max(0.0f, --CurrentUpdateProjectilesTime);
-}
-
-void ANWPSmartWeapon::UpdateSmartProjectile(ANWPProjectile* _ProjectileToProcess, float DeltaTime)
-{
-	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
-
-	// Early return if no projectile, smart weapon config or the projectile is not in the map
-	if (!_ProjectileToProcess || !SmartWeaponConfig || !SmartProjectiles.Contains(_ProjectileToProcess))
-	{
-		return;
-	}
-
-	UWorld* World = GetWorld();
-	FNWPSmartProjectileData SmartProjectileData = SmartProjectiles[_ProjectileToProcess];
-
-	// Return if the projectile has hit with something
-	if (SmartProjectileData.HasHitWithSomthing())
-	{
-		return;
-	}
-
-	// Evaluate if there is an obstacle in front of the projectile
-	FCollisionQueryParams QueryParams;
-
-	// Ignore the projectile, character & weapon
-	QueryParams.AddIgnoredActor(_ProjectileToProcess);
-	QueryParams.AddIgnoredActor(OwnerCharacter);
-	QueryParams.AddIgnoredActor(OwnerCharacter->GetWeapon());
-
-	// Ignore all the spawned projectiles
-	for (int32 Index = 0; Index < CurrentSpawnedProjectiles.Num(); ++Index)
-	{
-		QueryParams.AddIgnoredActor(CurrentSpawnedProjectiles[Index]);
-	}
-	QueryParams.bTraceComplex = true;
-
-	FHitResult Hit;
-
-	FVector TargetToFromProjectileToTargetActor = (SmartProjectileData.GetTargetActor()->GetActorLocation() - 
-		_ProjectileToProcess->GetActorLocation()).GetSafeNormal();
-	FVector ProjectilePosition = _ProjectileToProcess->GetActorLocation();
-	FVector EndPosition = _ProjectileToProcess->GetActorLocation() + TargetToFromProjectileToTargetActor * SmartWeaponConfig->GetAvoidObstacleProjectileDistance();
-
-	// Shoot a ray from the projectile to the target
-	if (World->LineTraceSingleByChannel(Hit, ProjectilePosition, EndPosition, COLLISION_WEAPON, QueryParams))
-	{
-		AActor* HitActor = Hit.GetActor();
-
-		// Evaluate the hit actor
-		if (HitActor == SmartProjectileData.GetTargetActor())
-		{
-			// Orientate the projectile to the target
-			SmartProjectileData.SetCurrentState(ENWPSmartProjectileState::OrientatingToTarget);
-		}
-		// Recalculate the avoid point if the obstacle changed
-		else if (HitActor != SmartProjectileData.GetTargetObstacle())
-		{
-			// Set the target obstacle
-			SmartProjectileData.SetTargetObstacle(Hit.GetActor());
-
-			// Select the avoid obstacle point
-			FVector AvoidObstaclePoint = GetAvoidObstaclePoint(_ProjectileToProcess, HitActor);
-
-			// Set the avoid obstacle point
-			SmartProjectileData.SetAvoidObstaclePoint(AvoidObstaclePoint);
-
-			// Orientate the projectile to the avoid obstacle point
-			SmartProjectileData.SetCurrentState(ENWPSmartProjectileState::OrientatingToAvoidObstacle);	
-		}
-	}
-
-	// Apply the smart projectile data to the map
-	SmartProjectiles[_ProjectileToProcess] = SmartProjectileData;
-}
-
-void ANWPSmartWeapon::OnProjectileVelocityComputed(ANWPProjectile* _ProjectileToProcess, FVector& _ComputedVelocity, float DeltaTime)
-{
-	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
-
-	// Early return if invalid weapon config or not smart projectile data
-	if (!SmartWeaponConfig || !SmartProjectiles.Contains(_ProjectileToProcess))
-	{
-		return;
-	}
-
-	// Get the projectile velocity & speed
-	FVector ProjectileVelocity = _ComputedVelocity;
-	float ProjectileSpeed = ProjectileVelocity.Size();
-
-	// Normalize velocity
-	ProjectileVelocity = ProjectileVelocity.GetSafeNormal();
-
-	// Get the smart projectile data from the map
-	FNWPSmartProjectileData SmartProjectileData = SmartProjectiles[_ProjectileToProcess];
-
-	// Calculate target point & orientation velocity
-	FVector TargetPoint = FVector::ZeroVector;
-	float OrientationVelocity = -1.0f;
-
-	if (SmartProjectileData.IsOrientatingToAvoidObstacles())
-	{
-		TargetPoint = SmartProjectileData.GetAvoidObstaclePoint();
-		OrientationVelocity = SmartWeaponConfig->GetOrientProjectileToAvoidObstacleVelocity();
-	}
-	else if (SmartProjectileData.IsOrientatingToTarget())
-	{
-		TargetPoint = SmartProjectileData.GetTargetActor()->GetActorLocation();
-		OrientationVelocity = SmartWeaponConfig->GetOrientProjectileToTargetVelocity();
-	}
-	else
-	{
-		return;
-	}
-
-	// Recalculate the velocity direction using the target
-	FVector TargetToFromProjectileToTargetPoint = (TargetPoint - _ProjectileToProcess->GetActorLocation()).GetSafeNormal();
-
-	// Perform the calculation only if the projectile moves towards the target
-	if ((ProjectileVelocity | TargetToFromProjectileToTargetPoint) >= 0.0f)
-	{
-		_ComputedVelocity = FMath::VInterpConstantTo(ProjectileVelocity, TargetToFromProjectileToTargetPoint,
-			DeltaTime, OrientationVelocity) * ProjectileSpeed;
-	}
-}
-
-void ANWPSmartWeapon::OnProjectileHit(class ANWPProjectile* _ProjectileToProcess, class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, 
-	FVector NormalImpulse, const FHitResult& Hit)
-{
-	// Early return if no smart projectile data
-	if (!SmartProjectiles.Contains(_ProjectileToProcess))
-	{
-		return;
-	}
-
-	// Get the smart projectile data from the map
-	FNWPSmartProjectileData SmartProjectileData = SmartProjectiles[_ProjectileToProcess];
-
-	// Change the state to hit with something
-	SmartProjectileData.SetCurrentState(ENWPSmartProjectileState::HitWithSomething);
-
-	// Apply the smart projectile data to the map
-	SmartProjectiles[_ProjectileToProcess] = SmartProjectileData;
-}
-
-void ANWPSmartWeapon::OnProjectileIsGoingToBeDestroyed(ANWPProjectile* _ProjectileToProcess)
-{
-	// Remove the projectile from the smart projectiles map
-	SmartProjectiles.Remove(_ProjectileToProcess);
-}
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPSmartWeapon.h"
+
+// UE
+#include "ConvexVolume.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/UserInterfaceSettings.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/PlatformTime.h"
+
+// NWP
+#include "NWPObstacleCache.h"
+#include "NWPTarget.h"
+#include "NWPTargetRegistry.h"
+#include "NWPTraceQuality.h"
+#include "NWPUtils.h"
+
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Smart Weapon Update Targets"), STAT_NWPUpdateTargets, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Weapon Target Candidates"), STAT_NWPTargetCandidates, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Weapon Targets Acquired"), STAT_NWPTargetsAcquired, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Weapon Targets Lost"), STAT_NWPTargetsLost, STATGROUP_NWP);
+DECLARE_CYCLE_STAT(TEXT("Smart Weapon Update Projectiles"), STAT_NWPUpdateSmartProjectiles, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Projectile Obstacle Traces"), STAT_NWPObstacleTraces, STATGROUP_NWP);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Smart Projectile Update Cost (us per projectile)"), STAT_NWPObstacleTraceCostPerProjectile, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Projectiles Updated"), STAT_NWPSmartProjectilesUpdated, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Projectile Queue Depth"), STAT_NWPSmartProjectileQueueDepth, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Projectile Async Obstacle Probes"), STAT_NWPAsyncObstacleProbes, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Projectile Obstacle Probe Mismatches"), STAT_NWPObstacleProbeMismatches, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smart Projectile Async Obstacle Refinement Traces"), STAT_NWPAsyncObstacleRefinementTraces, STATGROUP_NWP);
+
+// Console variables
+static TAutoConsoleVariable<int32> CVarSmartProjectileTraceBudget(
+	TEXT("NWP.SmartProjectileTraceBudget"),
+	32,
+	TEXT("Maximum number of smart projectiles that trace for obstacles per frame. The remaining projectiles wait in the queue and keep their last steering.\n")
+	TEXT("0: Unlimited. \n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSmartProjectileNearDistance(
+	TEXT("NWP.SmartProjectileNearDistance"),
+	1500.0f,
+	TEXT("Distance to the target or to the obstacle avoid point under which a smart projectile is updated more often.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSmartProjectileNearIntervalScale(
+	TEXT("NWP.SmartProjectileNearIntervalScale"),
+	0.25f,
+	TEXT("Scale applied to the update interval of the smart projectiles that are close to the target or to an obstacle.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSmartProjectileObstacleProbeMode(
+	TEXT("NWP.SmartProjectileObstacleProbeMode"),
+	1,
+	TEXT("How the smart projectiles probe for obstacles in front of them.\n")
+	TEXT("0: Synchronous trace from the game thread, applied immediately.\n")
+	TEXT("1: Asynchronous trace submitted with the frame & applied at the start of the next frame.\n")
+	TEXT("2: Asynchronous trace compared against a synchronous trace when it is applied. See NWP.ReportObstacleProbeComparison.\n"),
+	ECVF_Default);
+
+// Results of the asynchronous obstacle probes compared against a synchronous trace when they are consumed
+struct FNWPObstacleProbeComparison
+{
+	// Number of compared probes
+	int32 NumProbes = 0;
+
+	// Number of asynchronous probes that have hit something
+	int32 NumAsyncHits = 0;
+
+	// Number of synchronous traces that have hit something
+	int32 NumSyncHits = 0;
+
+	// Number of probes whose asynchronous & synchronous hit actor are different
+	int32 NumMismatches = 0;
+};
+
+// Comparison of the obstacle probes of all the smart weapons
+static FNWPObstacleProbeComparison ObstacleProbeComparison;
+
+// Console commands
+static FAutoConsoleCommandWithArgs ReportObstacleProbeComparisonCommand(
+	TEXT("NWP.ReportObstacleProbeComparison"),
+	TEXT("Writes to the log the hit rate of the asynchronous obstacle probes against the synchronous traces. Requires NWP.SmartProjectileObstacleProbeMode 2.\n")
+	TEXT("Usage: NWP.ReportObstacleProbeComparison [Reset]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FNWPObstacleProbeComparison& Comparison = ObstacleProbeComparison;
+		const float ProbesPercent = Comparison.NumProbes > 0 ? 100.0f / Comparison.NumProbes : 0.0f;
+
+		UE_LOG(LogNWP, Log, TEXT("NWP.ReportObstacleProbeComparison: Probes: %d Async hit rate: %.2f%% Sync hit rate: %.2f%% Mismatches: %d (%.2f%%)"),
+			Comparison.NumProbes, Comparison.NumAsyncHits * ProbesPercent, Comparison.NumSyncHits * ProbesPercent, 
+			Comparison.NumMismatches, Comparison.NumMismatches * ProbesPercent);
+
+		if (Args.Num() > 0 && Args[0].Equals(TEXT("Reset"), ESearchCase::IgnoreCase))
+		{
+			ObstacleProbeComparison = FNWPObstacleProbeComparison();
+		}
+	}));
+
+// Budget of the obstacle traces shared by all the smart weapons
+static FNWPFrameBudget SmartProjectileTraceBudget;
+
+int32 FNWPSmartProjectileSteering::Add()
+{
+	TargetActors.Add(nullptr);
+	TargetObstacles.Add(nullptr);
+	AvoidObstaclePoints.Add(FVector::ZeroVector);
+	TimesUntilUpdate.Add(0.0f);
+	QueuedFlags.Add(false);
+
+	return States.Add(ENWPSmartProjectileState::OrientatingToTarget);
+}
+
+void FNWPSmartProjectileSteering::SetTarget(int32 _Index, const AActor* _TargetActor)
+{
+	TargetActors[_Index] = const_cast<AActor*>(_TargetActor);
+	TargetObstacles[_Index] = nullptr;
+	AvoidObstaclePoints[_Index] = FVector::ZeroVector;
+	States[_Index] = ENWPSmartProjectileState::OrientatingToTarget;
+	TimesUntilUpdate[_Index] = 0.0f;
+	QueuedFlags[_Index] = false;
+}
+
+void FNWPSmartProjectileSteering::RemoveAtSwap(int32 _Index)
+{
+	TargetActors.RemoveAtSwap(_Index, 1, false);
+	TargetObstacles.RemoveAtSwap(_Index, 1, false);
+	AvoidObstaclePoints.RemoveAtSwap(_Index, 1, false);
+	States.RemoveAtSwap(_Index, 1, false);
+	TimesUntilUpdate.RemoveAtSwap(_Index, 1, false);
+	QueuedFlags.RemoveAtSwap(_Index, 1, false);
+}
+
+ANWPSmartWeapon::ANWPSmartWeapon(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	TargetAreaBeginPosition = FVector2D::ZeroVector;
+	TargetArea = FVector2D::ZeroVector;
+	CurrentTargetRegistry = nullptr;
+	CurrentObstacleCache = nullptr;
+	NextObstacleProbeId = 0;
+
+	ObstacleProbeDelegate.BindUObject(this, &ANWPSmartWeapon::OnObstacleProbeCompleted);
+	ObstacleRefinementDelegate.BindUObject(this, &ANWPSmartWeapon::OnObstacleRefinementCompleted);
+}
+
+void ANWPSmartWeapon::UpdateWeapon(float DeltaSeconds)
+{
+	Super::UpdateWeapon(DeltaSeconds);
+
+	// Only the equipped weapon looks for targets. The projectiles in flight keep the targets they had
+	if (IsWeaponActive())
+	{
+		// Calculate the viewport target positions
+		CalculateViewportTargetPositions();
+
+		// Execute the update methods 
+		UpdateTargets();
+	}
+
+	UpdateSmartProjectiles(DeltaSeconds);
+}
+
+bool ANWPSmartWeapon::NeedsWeaponUpdate() const
+{
+	return Super::NeedsWeaponUpdate() || IsWeaponActive() || SmartProjectiles.Num() > 0;
+}
+
+void ANWPSmartWeapon::ConfigureWeapon()
+{
+	Super::ConfigureWeapon();
+
+	// Calculate the viewport target positions
+	CalculateViewportTargetPositions();
+
+	// Rank the targets with the policy of the config
+	if (const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig())
+	{
+		TargetRanking.SetPolicy(SmartWeaponConfig->GetTargetAllocationPolicy());
+	}
+}
+
+bool ANWPSmartWeapon::HasTargetToShoot()
+{
+	return CurrentTargets.Num() != 0;
+}
+
+const AActor* ANWPSmartWeapon::GetTargetToShoot()
+{
+	// Check if there is any target
+	if (CurrentTargets.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	// Select the best ranked target according to the allocation policy. The ranking is updated with the targets
+	return TargetRanking.AllocateTarget();
+}
+
+void ANWPSmartWeapon::CalculateViewportTargetPositions()
+{
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+
+	// Early return if invalid weapon config
+	if (!SmartWeaponConfig)
+	{
+		return;
+	}
+
+	// Evaluate if the potential targets are inside the target area
+	if (OwnerCharacter)
+	{
+		APlayerController* OwnerPlayerController = Cast<APlayerController>(OwnerCharacter->GetController());
+
+		if (OwnerPlayerController)
+		{
+			int32 ViewportSizeX = -1.0f;
+			int32 ViewportSizeY = -1.0f;
+
+			OwnerPlayerController->GetViewportSize(ViewportSizeX, ViewportSizeY);
+
+			// TODO: [NWP-REVIEW] Use values that are independent from resolution or develop some scale system
+
+			// Check if valid viewport size
+			if (ViewportSizeX > 0 && ViewportSizeY > 0)
+			{
+				// Calculate the target area positions
+				TargetAreaBeginPosition.X = (ViewportSizeX - SmartWeaponConfig->GetHorizontalTargetArea()) / 2;
+				TargetAreaBeginPosition.Y = (ViewportSizeY - SmartWeaponConfig->GetVerticalTargetArea()) / 2;
+				TargetArea.X = SmartWeaponConfig->GetHorizontalTargetArea();
+				TargetArea.Y = SmartWeaponConfig->GetVerticalTargetArea();
+			}
+		}
+	}
+}
+
+void ANWPSmartWeapon::UpdateTargets()
+{
+	SCOPE_CYCLE_COUNTER(STAT_NWPUpdateTargets);
+
+	// Get the registry that contains the targets of the world
+	if (!CurrentTargetRegistry)
+	{
+		CurrentTargetRegistry = ANWPTargetRegistry::GetTargetRegistry(GetWorld());
+	}
+
+	// Early return if no registry
+	if (!CurrentTargetRegistry)
+	{
+		return;
+	}
+
+	const TArray<ANWPTarget*>& RegisteredTargets = CurrentTargetRegistry->GetTargets();
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+	APlayerController* OwnerPlayerController = OwnerCharacter ? Cast<APlayerController>(OwnerCharacter->GetController()) : nullptr;
+	int32 NumLostTargets = 0;
+
+	// Mark the targets acquired during the previous update. The targets that have left the registry are lost
+	PreviousTargetsMask.Init(false, RegisteredTargets.Num());
+
+	for (const AActor* Target : CurrentTargets)
+	{
+		const ANWPTarget* RegisteredTarget = Cast<ANWPTarget>(Target);
+
+		if (RegisteredTarget && RegisteredTargets.IsValidIndex(RegisteredTarget->GetRegistryIndex()))
+		{
+			PreviousTargetsMask[RegisteredTarget->GetRegistryIndex()] = true;
+		}
+		else
+		{
+			++NumLostTargets;
+		}
+	}
+
+	// Query the targets inside the part of the view frustum that goes through the target area
+	FConvexVolume TargetAreaFrustum;
+	FBox TargetAreaBounds;
+
+	CandidateTargetIndices.Reset();
+
+	if (SmartWeaponConfig && TargetProjector.Setup(OwnerPlayerController) && 
+		TargetProjector.BuildScreenRectFrustum(TargetAreaBeginPosition, TargetAreaBeginPosition + TargetArea, SmartWeaponConfig->GetMaxTargetDistance(), TargetAreaFrustum, TargetAreaBounds))
+	{
+		CurrentTargetRegistry->QueryTargets(TargetAreaFrustum, TargetAreaBounds, CandidateTargetIndices);
+	}
+
+	// Project only the candidates. The screen positions are shared with the HUD
+	TargetProjector.ProjectIndexedPositions(CurrentTargetRegistry->GetTargetPositions(), CandidateTargetIndices, TargetScreenPositions, TargetScreenPositionsValid);
+
+	// Rebuild the targets. Each registered target is queried once, so there are no duplicates to check
+	const TArray<FVector>& TargetPositions = CurrentTargetRegistry->GetTargetPositions();
+	const FVector WeaponLocation = GetActorLocation();
+	const FVector WeaponForward = GetActorForwardVector();
+	int32 NumAcquiredTargets = 0;
+
+	CurrentTargets.Reset();
+	TargetRanking.BeginUpdate();
+
+	for (int32 TargetIndex : CandidateTargetIndices)
+	{
+		// TODO: [NWP-REVIEW] Consider checking bounding box projection onto the viewport
+		if (!TargetScreenPositionsValid[TargetIndex] || !IsScreenLocationInsideTargetArea(TargetScreenPositions[TargetIndex]))
+		{
+			continue;
+		}
+
+		CurrentTargets.Add(RegisteredTargets[TargetIndex]);
+
+		// Rank the target by the dot product with the weapon forward, it keeps the order of the angles
+		TargetRanking.RankTarget(RegisteredTargets[TargetIndex], WeaponForward | (TargetPositions[TargetIndex] - WeaponLocation).GetSafeNormal());
+
+		if (PreviousTargetsMask[TargetIndex])
+		{
+			PreviousTargetsMask[TargetIndex] = false;
+		}
+		else
+		{
+			++NumAcquiredTargets;
+		}
+	}
+
+	// Remove the targets that have left the target area from the ranking
+	TargetRanking.EndUpdate();
+
+	// The targets that are still marked have left the target area
+	for (TConstSetBitIterator<> It(PreviousTargetsMask); It; ++It)
+	{
+		++NumLostTargets;
+	}
+
+	INC_DWORD_STAT_BY(STAT_NWPTargetCandidates, CandidateTargetIndices.Num());
+	INC_DWORD_STAT_BY(STAT_NWPTargetsAcquired, NumAcquiredTargets);
+	INC_DWORD_STAT_BY(STAT_NWPTargetsLost, NumLostTargets);
+}
+
+bool ANWPSmartWeapon::IsActorInsideTargetArea(class AActor* ActorToEvaluate)
+{
+	APlayerController* OwnerPlayerController = Cast<APlayerController>(OwnerCharacter->GetController());
+	FVector2D TargetScreenLocation;
+
+	// Transform world coordinates to screen coordinates
+	TargetProjector.Setup(OwnerPlayerController);
+
+	return TargetProjector.ProjectPosition(ActorToEvaluate->GetActorLocation(), TargetScreenLocation) && IsScreenLocationInsideTargetArea(TargetScreenLocation);
+}
+
+bool ANWPSmartWeapon::IsScreenLocationInsideTargetArea(const FVector2D& TargetScreenLocation) const
+{
+	return (TargetScreenLocation.X > TargetAreaBeginPosition.X  && TargetScreenLocation.X < TargetAreaBeginPosition.X + TargetArea.X) &&
+		(TargetScreenLocation.Y > TargetAreaBeginPosition.Y && TargetScreenLocation.Y < TargetAreaBeginPosition.Y + TargetArea.Y);
+}
+
+bool ANWPSmartWeapon::GetTargetScreenPosition(const AActor* _Target, FVector2D& _OutScreenPosition) const
+{
+	const ANWPTarget* RegisteredTarget = Cast<ANWPTarget>(_Target);
+
+	// Early return if the target has not been projected
+	if (!RegisteredTarget || !TargetScreenPositionsValid.IsValidIndex(RegisteredTarget->GetRegistryIndex()) || 
+		!TargetScreenPositionsValid[RegisteredTarget->GetRegistryIndex()])
+	{
+		return false;
+	}
+
+	_OutScreenPosition = TargetScreenPositions[RegisteredTarget->GetRegistryIndex()];
+	return true;
+}
+
+void ANWPSmartWeapon::OnShotFired(const FNWPShotData& _ShotData, ANWPProjectile* _SpawnedProjectile)
+{
+	Super::OnShotFired(_ShotData, _SpawnedProjectile);
+
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+
+	// Early return if invalid weapon config or no projectile configured
+	if (!SmartWeaponConfig || !SmartWeaponConfig->GetDefaultProjectileClass().Get())
+	{
+		return;
+	}
+
+	checkf(SmartWeaponConfig->ShouldUseProjectileAsAmmo(), TEXT("ANWPSmartWeapon::OnShotFired: Smart Weapons should always use projectiles"));
+
+	// Steer the spawned projectile if there is at least one target
+	const int32 ProjectileIndex = FindSpawnedProjectileIndex(_SpawnedProjectile);
+
+	if (ProjectileIndex != INDEX_NONE && HasTargetToShoot())
+	{
+		SmartProjectiles.SetTarget(ProjectileIndex, GetTargetToShoot());
+	}
+}
+
+void ANWPSmartWeapon::OnSpawnedProjectileAdded(int32 _ProjectileIndex)
+{
+	Super::OnSpawnedProjectileAdded(_ProjectileIndex);
+
+	// The projectile is not steered until it gets a target
+	const int32 SteeringIndex = SmartProjectiles.Add();
+	check(SteeringIndex == _ProjectileIndex);
+}
+
+void ANWPSmartWeapon::OnSpawnedProjectileRemoved(int32 _ProjectileIndex)
+{
+	Super::OnSpawnedProjectileRemoved(_ProjectileIndex);
+
+	// The projectile no longer follows its target
+	TargetRanking.ReleaseTarget(SmartProjectiles.TargetActors[_ProjectileIndex]);
+
+	// Mirror the removal of the spawned projectiles
+	SmartProjectiles.RemoveAtSwap(_ProjectileIndex);
+}
+
+FVector ANWPSmartWeapon::GetAvoidObstaclePoint(class ANWPProjectile* _ProjectileToProcess, class AActor* TargetObstacle)
+{
+	// TODO: [NWP-REVIEW] This heuristic is simple and work most of the times
+	// In order to have a better heuristic, i will need more time and iterate more on the Gameplay mechanic
+	// Consider to add some noise to the selected point
+
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+
+	// Early return if no projectile, smart weapon config or the projectile is not spawned by this weapon
+	if (!_ProjectileToProcess || !SmartWeaponConfig || FindSpawnedProjectileIndex(_ProjectileToProcess) == INDEX_NONE)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Get the cached data of the obstacle, it is only computed again if the obstacle has moved
+	if (!CurrentObstacleCache)
+	{
+		CurrentObstacleCache = ANWPObstacleCache::GetObstacleCache(GetWorld());
+	}
+
+	FNWPObstacleCacheEntry UncachedObstacle;
+
+	if (!CurrentObstacleCache)
+	{
+		ANWPObstacleCache::ComputeObstacle(TargetObstacle, UncachedObstacle);
+	}
+
+	const FNWPObstacleCacheEntry& Obstacle = CurrentObstacleCache ? CurrentObstacleCache->GetObstacle(TargetObstacle) : UncachedObstacle;
+
+	// Calculate relevant points
+	const FVector ObstacleLocation = Obstacle.Transform.GetLocation();
+	const FVector HorizontalOffset = _ProjectileToProcess->GetActorRightVector() * (Obstacle.HalfXYDiagonal + SmartWeaponConfig->GetAvoidObstacleHorizontalOffset());
+	const FVector RelevantPoints[] = 
+	{
+		ObstacleLocation + HorizontalOffset,
+		ObstacleLocation - HorizontalOffset,
+		ObstacleLocation + Obstacle.Transform.GetRotation().GetUpVector() * (Obstacle.HalfHeight + SmartWeaponConfig->GetAvoidObstacleVerticalOffset())
+	};
+
+	// Loop the relevant points and find the closest one to the projectile
+	const FVector ProjectileLocation = _ProjectileToProcess->GetActorLocation();
+	int32 SelectedPoint = 0;
+	float CurrentBestSquareDistance = FVector::DistSquared(RelevantPoints[0], ProjectileLocation);
+
+	for (int32 Index = 1; Index < (int32)ARRAY_COUNT(RelevantPoints); ++Index)
+	{
+		const float DistanceToCheck = FVector::DistSquared(RelevantPoints[Index], ProjectileLocation);
+
+		// Evaluate if the point is closer than the current one
+		if (DistanceToCheck < CurrentBestSquareDistance)
+		{
+			SelectedPoint = Index;
+			CurrentBestSquareDistance = DistanceToCheck;
+		}
+	}
+
+	// Draw some debug data
+#if !UE_BUILD_SHIPPING 
+	if (CVarbDebugWeapon.GetValueOnGameThread())
+	{
+		// Obstacle bounding box
+		DrawDebugBox(GetWorld(), Obstacle.Bounds.GetCenter(), Obstacle.Bounds.GetExtent(), FColor::Red, true, 1.0f);
+
+		// Relevant points
+		for (const FVector& RelevantPoint : RelevantPoints)
+		{
+			DrawDebugSphere(GetWorld(), RelevantPoint, 20.0f, 10, FColor::Blue, false, 1.0f, 0, 3.0f);
+		}
+
+		// Selected point
+		DrawDebugSphere(GetWorld(), RelevantPoints[SelectedPoint], 20.0f, 10, FColor::Green, false, 1.0f, 0, 3.0f);
+	}
+#endif
+
+	// Return the selected point
+	return RelevantPoints[SelectedPoint];
+}
+
+void ANWPSmartWeapon::UpdateSmartProjectiles(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NWPUpdateSmartProjectiles);
+
+	// Early return if nothing to update
+	if (SmartProjectiles.Num() == 0)
+	{
+		ProjectileUpdateQueue.Reset();
+		return;
+	}
+
+	// Queue the projectiles whose update is due
+	for (int32 ProjectileIndex = 0; ProjectileIndex < SmartProjectiles.Num(); ++ProjectileIndex)
+	{
+		// Skip the projectiles that are not steered
+		if (!SmartProjectiles.IsSmart(ProjectileIndex))
+		{
+			continue;
+		}
+
+		float& TimeUntilUpdate = SmartProjectiles.TimesUntilUpdate[ProjectileIndex];
+		TimeUntilUpdate -= DeltaTime;
+
+		if (TimeUntilUpdate <= 0.0f && !SmartProjectiles.QueuedFlags[ProjectileIndex] && !SmartProjectiles.HasHitWithSomthing(ProjectileIndex))
+		{
+			SmartProjectiles.QueuedFlags[ProjectileIndex] = true;
+			ProjectileUpdateQueue.Add(SpawnedProjectileSet.GetHandle(ProjectileIndex));
+		}
+	}
+
+	// Build the query params once, they are shared by every obstacle trace of this update
+	BuildObstacleQueryParams();
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+	const int32 TraceBudget = CVarSmartProjectileTraceBudget.GetValueOnGameThread();
+	int32 NumProcessed = 0;
+	int32 NumUpdated = 0;
+
+	// Update the projectiles in queue order until the budget is spent. The rest keep their last steering decision
+	for (; NumProcessed < ProjectileUpdateQueue.Num(); ++NumProcessed)
+	{
+		const int32 ProjectileIndex = SpawnedProjectileSet.GetDenseIndex(ProjectileUpdateQueue[NumProcessed]);
+
+		// Skip the projectiles that have been destroyed while waiting, their handle is stale
+		if (ProjectileIndex == INDEX_NONE || !SmartProjectiles.QueuedFlags[ProjectileIndex])
+		{
+			continue;
+		}
+
+		if (!SmartProjectileTraceBudget.TryToConsume(TraceBudget))
+		{
+			break;
+		}
+
+		SmartProjectiles.QueuedFlags[ProjectileIndex] = false;
+		UpdateSmartProjectile(ProjectileIndex, DeltaTime);
+
+		// Schedule the next update
+		SmartProjectiles.TimesUntilUpdate[ProjectileIndex] = GetSmartProjectileUpdateInterval(ProjectileIndex);
+		++NumUpdated;
+	}
+
+	ProjectileUpdateQueue.RemoveAt(0, NumProcessed, false);
+
+	// Report the average cost of the update of a projectile
+	if (NumUpdated > 0)
+	{
+		SET_FLOAT_STAT(STAT_NWPObstacleTraceCostPerProjectile, FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles) * 1000.0f / NumUpdated);
+	}
+
+	INC_DWORD_STAT_BY(STAT_NWPSmartProjectileQueueDepth, ProjectileUpdateQueue.Num());
+	INC_DWORD_STAT_BY(STAT_NWPSmartProjectilesUpdated, NumUpdated);
+}
+
+FVector ANWPSmartWeapon::SteerVelocity(const FVector& _Velocity, const FVector& _ProjectileLocation, const FVector& _TargetPoint, float _DeltaTime, 
+	float _OrientationVelocity)
+{
+	// Get the projectile direction & speed
+	const FVector ProjectileDirection = _Velocity.GetSafeNormal();
+	const float ProjectileSpeed = _Velocity.Size();
+
+	// Recalculate the velocity direction using the target
+	const FVector FromProjectileToTargetPoint = (_TargetPoint - _ProjectileLocation).GetSafeNormal();
+
+	// Early return if the projectile moves away from the target
+	if ((ProjectileDirection | FromProjectileToTargetPoint) < 0.0f)
+	{
+		return _Velocity;
+	}
+
+	// Normalize the interpolated direction, as it moves along the chord between both directions and would lose speed otherwise
+	return FMath::VInterpConstantTo(ProjectileDirection, FromProjectileToTargetPoint, _DeltaTime, _OrientationVelocity).GetSafeNormal() * ProjectileSpeed;
+}
+
+float ANWPSmartWeapon::GetSmartProjectileUpdateInterval(int32 _ProjectileIndex) const
+{
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+	const float UpdateInterval = SmartWeaponConfig ? SmartWeaponConfig->GetUpdateProjectileDeltaTime() : 0.0f;
+	const float NearDistanceSquared = FMath::Square(CVarSmartProjectileNearDistance.GetValueOnGameThread());
+	const FVector ProjectileLocation = CurrentSpawnedProjectiles[_ProjectileIndex]->GetActorLocation();
+	const AActor* TargetActor = SmartProjectiles.TargetActors[_ProjectileIndex];
+
+	// Check if the projectile is close to where it is steering
+	const bool bIsNearTarget = TargetActor && FVector::DistSquared(ProjectileLocation, TargetActor->GetActorLocation()) < NearDistanceSquared;
+	const bool bIsNearObstacle = SmartProjectiles.IsOrientatingToAvoidObstacles(_ProjectileIndex) && 
+		FVector::DistSquared(ProjectileLocation, SmartProjectiles.AvoidObstaclePoints[_ProjectileIndex]) < NearDistanceSquared;
+
+	return (bIsNearTarget || bIsNearObstacle) ? UpdateInterval * CVarSmartProjectileNearIntervalScale.GetValueOnGameThread() : UpdateInterval;
+}
+
+void ANWPSmartWeapon::BuildObstacleQueryParams()
+{
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+
+	// Only the first trace of the quality is done with these params
+	ObstacleQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(NWPSmartProjectileObstacle), 
+		!SmartWeaponConfig || FNWPTraceQuality::IsFirstTraceComplex(SmartWeaponConfig->GetObstacleTraceQuality()));
+
+	// Ignore the character & weapon
+	ObstacleQueryParams.AddIgnoredActor(this);
+	ObstacleQueryParams.AddIgnoredActor(OwnerCharacter);
+
+	// The refinement traces of the asynchronous probes ignore the same actors against the complex collision
+	ObstacleRefinementQueryParams = ObstacleQueryParams;
+	ObstacleRefinementQueryParams.bTraceComplex = true;
+}
+
+void ANWPSmartWeapon::UpdateSmartProjectile(int32 _ProjectileIndex, float DeltaTime)
+{
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+
+	// Early return if no smart weapon config or the projectile is not spawned
+	if (!SmartWeaponConfig || !CurrentSpawnedProjectiles.IsValidIndex(_ProjectileIndex) || !CurrentSpawnedProjectiles[_ProjectileIndex])
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+
+	// Return if the projectile has hit with something or it is not steered
+	if (SmartProjectiles.HasHitWithSomthing(_ProjectileIndex) || !SmartProjectiles.IsSmart(_ProjectileIndex))
+	{
+		return;
+	}
+
+	// Submit the probe, the projectile keeps steering with its last obstacle state until the probe finishes during the next frame
+	if (CVarSmartProjectileObstacleProbeMode.GetValueOnGameThread() != 0)
+	{
+		FVector ProbeStart;
+		FVector ProbeEnd;
+		ComputeObstacleProbe(_ProjectileIndex, ProbeStart, ProbeEnd);
+
+		// Remember the projectile, so the probe can be applied when it finishes
+		const uint32 ProbeId = NextObstacleProbeId++;
+		InFlightObstacleProbes.Add(ProbeId, SpawnedProjectileSet.GetHandle(_ProjectileIndex));
+
+		INC_DWORD_STAT(STAT_NWPAsyncObstacleProbes);
+
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, ProbeStart, ProbeEnd, COLLISION_PROJECTILE_OBSTACLE, ObstacleQueryParams, 
+			FCollisionResponseParams::DefaultResponseParam, &ObstacleProbeDelegate, ProbeId);
+		return;
+	}
+
+	// Evaluate if there is an obstacle in front of the projectile
+	FHitResult Hit;
+
+	if (TraceObstacleProbe(_ProjectileIndex, Hit))
+	{
+		ApplyObstacleProbe(_ProjectileIndex, Hit);
+	}
+}
+
+void ANWPSmartWeapon::ComputeObstacleProbe(int32 _ProjectileIndex, FVector& _OutStart, FVector& _OutEnd) const
+{
+	const FVector TargetLocation = SmartProjectiles.TargetActors[_ProjectileIndex]->GetActorLocation();
+
+	_OutStart = CurrentSpawnedProjectiles[_ProjectileIndex]->GetActorLocation();
+	_OutEnd = _OutStart + (TargetLocation - _OutStart).GetSafeNormal() * GetSmartWeaponConfig()->GetAvoidObstacleProjectileDistance();
+}
+
+bool ANWPSmartWeapon::TraceObstacleProbe(int32 _ProjectileIndex, FHitResult& _OutHit) const
+{
+	FVector ProbeStart;
+	FVector ProbeEnd;
+	ComputeObstacleProbe(_ProjectileIndex, ProbeStart, ProbeEnd);
+
+	INC_DWORD_STAT(STAT_NWPObstacleTraces);
+
+	// Shoot a ray from the projectile to the target. The projectiles ignore the obstacle channel, so they do not have to be ignored one by one
+	return FNWPTraceQuality::LineTraceSingleByChannel(GetWorld(), _OutHit, ProbeStart, ProbeEnd, COLLISION_PROJECTILE_OBSTACLE, ObstacleQueryParams, 
+		GetSmartWeaponConfig()->GetObstacleTraceQuality(), ENWPTraceCategory::Obstacle);
+}
+
+void ANWPSmartWeapon::ApplyObstacleProbe(int32 _ProjectileIndex, const FHitResult& _Hit)
+{
+	AActor* HitActor = _Hit.GetActor();
+
+	// Evaluate the hit actor
+	if (HitActor == SmartProjectiles.TargetActors[_ProjectileIndex])
+	{
+		// Orientate the projectile to the target
+		SmartProjectiles.States[_ProjectileIndex] = ENWPSmartProjectileState::OrientatingToTarget;
+	}
+	// Recalculate the avoid point if the obstacle changed
+	else if (HitActor != SmartProjectiles.TargetObstacles[_ProjectileIndex])
+	{
+		// Set the target obstacle
+		SmartProjectiles.TargetObstacles[_ProjectileIndex] = HitActor;
+
+		// Select the avoid obstacle point
+		SmartProjectiles.AvoidObstaclePoints[_ProjectileIndex] = GetAvoidObstaclePoint(CurrentSpawnedProjectiles[_ProjectileIndex], HitActor);
+
+		// Orientate the projectile to the avoid obstacle point
+		SmartProjectiles.States[_ProjectileIndex] = ENWPSmartProjectileState::OrientatingToAvoidObstacle;
+	}
+}
+
+int32 ANWPSmartWeapon::GetProbedProjectileIndex(const FNWPSparseSetHandle& _ProjectileHandle) const
+{
+	const int32 ProjectileIndex = SpawnedProjectileSet.GetDenseIndex(_ProjectileHandle);
+
+	// The projectile may have been destroyed, have hit with something or be no longer steered while the probe was in flight
+	if (ProjectileIndex == INDEX_NONE || !GetSmartWeaponConfig() || !CurrentSpawnedProjectiles[ProjectileIndex] || 
+		!SmartProjectiles.IsSmart(ProjectileIndex) || SmartProjectiles.HasHitWithSomthing(ProjectileIndex))
+	{
+		return INDEX_NONE;
+	}
+
+	return ProjectileIndex;
+}
+
+void ANWPSmartWeapon::OnObstacleProbeCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData)
+{
+	FNWPSparseSetHandle ProjectileHandle;
+
+	// Early return if the probe is unknown
+	if (!InFlightObstacleProbes.RemoveAndCopyValue(_TraceData.UserData, ProjectileHandle))
+	{
+		return;
+	}
+
+	const int32 ProjectileIndex = GetProbedProjectileIndex(ProjectileHandle);
+
+	// Early return if the projectile is no longer probed
+	if (ProjectileIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Single traces return at most one blocking hit
+	FHitResult Hit = _TraceData.OutHits.Num() > 0 ? _TraceData.OutHits[0] : FHitResult();
+	bool bHit = Hit.bBlockingHit;
+	const ENWPTraceQuality ObstacleTraceQuality = GetSmartWeaponConfig()->GetObstacleTraceQuality();
+
+	// Refine the simple hit with a follow up asynchronous trace, so the complex collision is not traced on the game thread
+	if (bHit && ObstacleTraceQuality == ENWPTraceQuality::SimpleThenComplex && !FNWPTraceQuality::IsAuditEnabled())
+	{
+		FNWPObstacleProbeRefinement Refinement;
+		Refinement.ProjectileHandle = ProjectileHandle;
+		Refinement.SimpleHit = Hit;
+		Refinement.Start = _TraceData.Start;
+		Refinement.End = _TraceData.End;
+		Refinement.bIsWindow = true;
+		FNWPTraceQuality::ComputeRefinementWindow(Hit, _TraceData.Start, _TraceData.End, 0.0f, Refinement.TraceBeginDistance, Refinement.TraceEndDistance);
+
+		SubmitObstacleRefinementTrace(Refinement);
+		return;
+	}
+
+	// Only traces if the traces are audited, the first trace is enough otherwise. The query params are the ones the probe has been submitted with
+	bHit = FNWPTraceQuality::RefineFirstTrace(GetWorld(), bHit, Hit, _TraceData.Start, _TraceData.End, COLLISION_PROJECTILE_OBSTACLE, ObstacleQueryParams, 
+		ObstacleTraceQuality, ENWPTraceCategory::Obstacle);
+
+	ResolveObstacleProbe(ProjectileIndex, Hit, bHit);
+}
+
+void ANWPSmartWeapon::SubmitObstacleRefinementTrace(const FNWPObstacleProbeRefinement& _Refinement)
+{
+	UWorld* World = GetWorld();
+
+	// Early return if no world
+	if (!World)
+	{
+		return;
+	}
+
+	const FVector Direction = (_Refinement.End - _Refinement.Start).GetSafeNormal();
+
+	// Remember the refinement, so the probe can be applied when the trace finishes
+	const uint32 ProbeId = NextObstacleProbeId++;
+	InFlightObstacleRefinements.Add(ProbeId, _Refinement);
+
+	World->AsyncLineTraceByChannel(EAsyncTraceType::Single, _Refinement.Start + Direction * _Refinement.TraceBeginDistance, 
+		_Refinement.Start + Direction * _Refinement.TraceEndDistance, COLLISION_PROJECTILE_OBSTACLE, ObstacleRefinementQueryParams, 
+		FCollisionResponseParams::DefaultResponseParam, &ObstacleRefinementDelegate, ProbeId);
+
+	INC_DWORD_STAT(STAT_NWPAsyncObstacleRefinementTraces);
+}
+
+void ANWPSmartWeapon::OnObstacleRefinementCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData)
+{
+	FNWPObstacleProbeRefinement Refinement;
+
+	// Early return if the refinement is unknown
+	if (!InFlightObstacleRefinements.RemoveAndCopyValue(_TraceData.UserData, Refinement))
+	{
+		return;
+	}
+
+	const int32 ProjectileIndex = GetProbedProjectileIndex(Refinement.ProjectileHandle);
+
+	// Early return if the projectile is no longer probed
+	if (ProjectileIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Single traces return at most one blocking hit
+	FHitResult Hit = _TraceData.OutHits.Num() > 0 ? _TraceData.OutHits[0] : FHitResult();
+	const bool bHit = Hit.bBlockingHit;
+
+	if (bHit)
+	{
+		FNWPTraceQuality::MakeHitRelativeToSegment(Hit, Refinement.TraceBeginDistance, Refinement.Start, Refinement.End);
+	}
+	// The complex collision has a hole where the simple one has been hit, trace the rest of the segment against the complex collision
+	else if (Refinement.bIsWindow && Refinement.TraceEndDistance < FVector::Dist(Refinement.Start, Refinement.End))
+	{
+		Refinement.TraceBeginDistance = Refinement.TraceEndDistance;
+		Refinement.TraceEndDistance = FVector::Dist(Refinement.Start, Refinement.End);
+		Refinement.bIsWindow = false;
+
+		SubmitObstacleRefinementTrace(Refinement);
+		return;
+	}
+
+	if (UWorld* World = GetWorld())
+	{
+		FNWPTraceQuality::RecordComparison(World, ENWPTraceCategory::Obstacle, true, Refinement.SimpleHit, bHit, Hit);
+	}
+
+	ResolveObstacleProbe(ProjectileIndex, Hit, bHit);
+}
+
+void ANWPSmartWeapon::ResolveObstacleProbe(int32 _ProjectileIndex, const FHitResult& _Hit, bool _bHit)
+{
+	// Compare the latent probe against a trace from the current location of the projectile
+	if (CVarSmartProjectileObstacleProbeMode.GetValueOnGameThread() == 2)
+	{
+		FHitResult SyncHit;
+		const bool bSyncHit = TraceObstacleProbe(_ProjectileIndex, SyncHit);
+		const bool bMismatch = _bHit != bSyncHit || (_bHit && _Hit.GetActor() != SyncHit.GetActor());
+
+		++ObstacleProbeComparison.NumProbes;
+		ObstacleProbeComparison.NumAsyncHits += _bHit ? 1 : 0;
+		ObstacleProbeComparison.NumSyncHits += bSyncHit ? 1 : 0;
+		ObstacleProbeComparison.NumMismatches += bMismatch ? 1 : 0;
+
+		INC_DWORD_STAT_BY(STAT_NWPObstacleProbeMismatches, bMismatch ? 1 : 0);
+	}
+
+	if (_bHit)
+	{
+		ApplyObstacleProbe(_ProjectileIndex, _Hit);
+	}
+}
+
+void ANWPSmartWeapon::OnProjectileVelocityComputed(ANWPProjectile* _ProjectileToProcess, FVector& _ComputedVelocity, float DeltaTime)
+{
+	const UNWPSmartWeaponConfig* SmartWeaponConfig = GetSmartWeaponConfig();
+
+	const int32 ProjectileIndex = FindSpawnedProjectileIndex(_ProjectileToProcess);
+
+	// Early return if invalid weapon config or not smart projectile
+	if (!SmartWeaponConfig || ProjectileIndex == INDEX_NONE || !SmartProjectiles.IsSmart(ProjectileIndex))
+	{
+		return;
+	}
+
+	// Calculate target point & orientation velocity
+	FVector TargetPoint = FVector::ZeroVector;
+	float OrientationVelocity = -1.0f;
+
+	if (SmartProjectiles.IsOrientatingToAvoidObstacles(ProjectileIndex))
+	{
+		TargetPoint = SmartProjectiles.AvoidObstaclePoints[ProjectileIndex];
+		OrientationVelocity = SmartWeaponConfig->GetOrientProjectileToAvoidObstacleVelocity();
+	}
+	else if (SmartProjectiles.IsOrientatingToTarget(ProjectileIndex))
+	{
+		TargetPoint = SmartProjectiles.TargetActors[ProjectileIndex]->GetActorLocation();
+		OrientationVelocity = SmartWeaponConfig->GetOrientProjectileToTargetVelocity();
+	}
+	else
+	{
+		return;
+	}
+
+	_ComputedVelocity = SteerVelocity(_ComputedVelocity, _ProjectileToProcess->GetActorLocation(), TargetPoint, DeltaTime, OrientationVelocity);
+}
+
+void ANWPSmartWeapon::OnProjectileHit(class ANWPProjectile* _ProjectileToProcess, class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, 
+	FVector NormalImpulse, const FHitResult& Hit)
+{
+	const int32 ProjectileIndex = FindSpawnedProjectileIndex(_ProjectileToProcess);
+
+	// Early return if no smart projectile data
+	if (ProjectileIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Change the state to hit with something
+	SmartProjectiles.States[ProjectileIndex] = ENWPSmartProjectileState::HitWithSomething;
+}
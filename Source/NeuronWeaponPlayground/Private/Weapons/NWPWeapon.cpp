@@ -1,446 +1,1208 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "NWPWeapon.h"
-
-// UE
-#include "Kismet/GameplayStatics.h"
-#include "Math/UnrealMathUtility.h"
-#include "DrawDebugHelpers.h"
-
-// NWP
-#include "NeuronTestCharacter.h"
-
-ANWPWeapon::ANWPWeapon(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
-{
-	PrimaryActorTick.bCanEverTick = true;
-
-	// Create a gun mesh component
-	FirstPersonGun = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("FirstPersonGun"));
-	//FirstPersonGun->SetOnlyOwnerSee(true);			// only the owning player will see this mesh
-	FirstPersonGun->bCastDynamicShadow = false;
-	FirstPersonGun->CastShadow = false;
-	// FP_Gun->SetupAttachment(Mesh1P, TEXT("GripPoint"));
-	FirstPersonGun->SetupAttachment(RootComponent);
-
-	// Initialize members
-	CurrentWeaponConfig = nullptr;
-	CurrentWeaponState = ENWPWeaponState::Invalid;
-	CurrentCoolDown = 0.0f;
-	CurrentAmmo = 0;
-	CurrentAmmoInMagazine = 0;
-	WeaponStateBeforeReload = ENWPWeaponState::Invalid;
-}
-
-void ANWPWeapon::BeginPlay()
-{
-	Super::BeginPlay();
-
-	// Set the state to none
-	SetWeaponState(ENWPWeaponState::None);
-}
-
-void ANWPWeapon::Tick(float DeltaSeconds)
-{
-	Super::Tick(DeltaSeconds);
-
-	// Execute the update methods 
-	UpdateCoolDown(DeltaSeconds);
-
-	UpdateShootingState(DeltaSeconds);
-}
-
-void ANWPWeapon::LoadWeapon(TSubclassOf<class UNWPWeaponConfig> _WeaponConfig)
-{
-	// Check if the weapon is currently configured
-	if (CurrentWeaponConfig)
-	{
-		// Release if configured
-		ReleaseWeapon();
-	}
-
-	// TODO: Revise this
-	CurrentWeaponConfig = NewObject<UNWPWeaponConfig>(GetWorld(), _WeaponConfig.Get() ? _WeaponConfig : DefaultWeaponConfigClass);
-
-	// Load the weapon config
-	FNWPOnWaponConfigLoaded WeaponCofigLoadedDelegate = FNWPOnWaponConfigLoaded::CreateUObject(this, &ANWPWeapon::OnWeaponLoaded);
-	CurrentWeaponConfig->LoadWeaponConfig(true, WeaponCofigLoadedDelegate);
-}
-
-void ANWPWeapon::ReleaseWeapon()
-{
-	// Check if the weapon is currently configured
-	if (CurrentWeaponConfig)
-	{
-		CurrentWeaponConfig->ReleaseWeaponConfig();
-		CurrentWeaponConfig = nullptr;
-	}
-}
-
-void ANWPWeapon::SwapCadenceType()
-{
-	// Early return if weapon busy or cooling down
-	if (CurrentWeaponState != ENWPWeaponState::None || IsCoolDownActive())
-	{
-		return;
-	}
-
-	// Swap between automatic / semi automatic
-	if (CurrentWeaponConfig && CurrentWeaponState != ENWPWeaponState::Reloading)
-	{
-		if (CurrentConfiguredCadenceType == ENWPWeaponCadenceType::Automatic && CurrentWeaponConfig->IsSemiAutomatic())
-		{
-			CurrentConfiguredCadenceType = ENWPWeaponCadenceType::SemiAutomatic;
-		}
-		else if (CurrentConfiguredCadenceType == ENWPWeaponCadenceType::SemiAutomatic && CurrentWeaponConfig->IsAutomatic())
-		{
-			CurrentConfiguredCadenceType = ENWPWeaponCadenceType::Automatic;
-		}
-	}
-}
-
-void ANWPWeapon::SetOwnerCharacter(class ANeuronTestCharacter* _NewOwnerCharacter, bool _bAttachToOwner)
-{
-	// Set the new value
-	OwnerCharacter = _NewOwnerCharacter;
-
-	// Attach to the owner if required
-	if (_bAttachToOwner)
-	{
-		AttachToOwner();
-	}
-}
-
-void ANWPWeapon::AttachToOwner()
-{
-	USkeletalMeshComponent* OwnerSkelletalMesh = OwnerCharacter->GetNWPSkelletalMeshComponent();
-	check(OwnerSkelletalMesh);
-
-	// Attach gun actor to owner skelleton
-	AttachToComponent(OwnerSkelletalMesh, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
-}
-
-void ANWPWeapon::DetachFromOwner()
-{
-	// Detach the root component from his parent
-	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-}
-
-void ANWPWeapon::StartShooting()
-{
-	// Return if weapon busy, cooling down or invalid weapon config
-	if (CurrentWeaponState != ENWPWeaponState::None || IsCoolDownActive())
-	{
-		return;
-	}
-
-	// Evaluate if the weapon is automatic / semi automatic
-	if (CurrentWeaponConfig)
-	{
-		// Always execute a shoot step
-		if (!InternalShootStep() && CurrentWeaponConfig->IsAutomatic())
-		{
-			// Set the shooting state
-			SetWeaponState(ENWPWeaponState::Shooting);
-		}
-	}
-}
-
-void ANWPWeapon::StopShooting()
-{
-	// Set to force the none state if reloading
-	if (CurrentWeaponState == ENWPWeaponState::Reloading)
-	{
-		bForceReloadToNone = true;
-		return;
-	}
-
-	// Check if the state is shooting
-	if (CurrentWeaponState != ENWPWeaponState::Shooting)
-	{
-		return;
-	}
-
-	// Set the none state
-	SetWeaponState(ENWPWeaponState::None);
-}
-
-void ANWPWeapon::OnWeaponLoaded()
-{
-	// Check if the weapon is configured
-	if (CurrentWeaponConfig)
-	{
-		// Configure the components
-		FirstPersonGun->SetSkeletalMesh(CurrentWeaponConfig->GetWeaponMesh());
-
-		// Cache some variables
-		CurrentConfiguredCadenceType = CurrentWeaponConfig->GetCadenceType();
-		CurrentAmmo = FMath::Min(CurrentWeaponConfig->GetInitialAmmo(), CurrentWeaponConfig->GetMaximumAmmo());
-		CurrentAmmoInMagazine = CurrentWeaponConfig->GetAmmoPerMagazine();
-	}
-}
-
-void ANWPWeapon::SetWeaponState(ENWPWeaponState _WeaponStateToSet)
-{
-	// Check if the state to set is different
-	if (CurrentWeaponState == _WeaponStateToSet)
-	{
-		return;
-	}
-
-	// Change the weapon state & execute the callback
-	CurrentWeaponState = _WeaponStateToSet;
-	OnWeaponStateChanged();
-}
-
-void ANWPWeapon::OnWeaponStateChanged()
-{
-	// Check the weapon state
-	switch (CurrentWeaponState)
-	{
-	case ENWPWeaponState::Shooting:
-
-		if (OwnerCharacter)
-		{
-			OwnerCharacter->OnStartShoot();
-		}
-
-		break;
-	}
-}
-
-void ANWPWeapon::UpdateShootingState(float DeltaSeconds)
-{
-	// Check if the state is shooting
-	if (CurrentWeaponState != ENWPWeaponState::Shooting || IsCoolDownActive())
-	{
-		return;
-	}
-
-	// Execute a shoot step
-	InternalShootStep();
-}
-
-bool ANWPWeapon::InternalShootStep()
-{
-	// Try to consume the ammo
-	if (TryToConsumeAmmo())
-	{
-		// Spawn the projectile
-		SpawProjectile();
-
-		// Reset cool down
-		ResetCoolDown();
-
-		return false;
-	}
-	else
-	{
-		// Otherwise, try to reload
-		CheckMagazineHasToReload();
-
-		return true;
-	}
-}
-
-bool ANWPWeapon::IsCoolDownActive()
-{
-	return CurrentCoolDown > 0.0f;
-}
-
-void ANWPWeapon::ResetCoolDown()
-{
-	// Evaluate the wapon config
-	if (CurrentWeaponConfig)
-	{
-		SetCoolDown(CurrentWeaponConfig->GetCoolDownForCadenceType(CurrentConfiguredCadenceType));
-	}
-}
-
-void ANWPWeapon::SetCoolDown(float Value, bool bAdditive /*= false*/)
-{
-	CurrentCoolDown = !bAdditive ? Value : (CurrentCoolDown + bAdditive);
-}
-
-void ANWPWeapon::UpdateCoolDown(float DeltaTime)
-{
-	CurrentCoolDown -= DeltaTime;
-	CurrentCoolDown = FMath::Max(CurrentCoolDown, 0.0f);
-
-	// Set the state to none if required
-	if (CurrentCoolDown == 0)
-	{
-		// Check if reloading
-		if (CurrentWeaponState == ENWPWeaponState::Reloading)
-		{
-			// Perform the reload
-			ReloadMagazine();
-
-			// Check if the state should be none
-			if (!bForceReloadToNone)
-			{
-				// Restore the state before reloading
-				SetWeaponState(WeaponStateBeforeReload);
-			}
-			else
-			{
-				SetWeaponState(ENWPWeaponState::None);
-			}
-		}
-	}
-}
-
-bool ANWPWeapon::TryToConsumeAmmo()
-{
-	// Returns if there is enough ammo in the magazine
-	if (CurrentAmmoInMagazine > 0)
-	{
-		CurrentAmmoInMagazine = FMath::Max(0, --CurrentAmmoInMagazine);
-		return true;
-	}
-
-	return false;
-}
-
-void ANWPWeapon::CheckMagazineHasToReload()
-{
-	// Return if no ammo or no weapon config
-	if (CurrentAmmo == 0 || !CurrentWeaponConfig)
-	{
-		return;
-	}
-
-	// Set the cool down to the reload time
-	if (CurrentWeaponConfig)
-	{
-		SetCoolDown(CurrentWeaponConfig->GetMagazineReloadTime());
-	}
-
-	// Cache current state
-	WeaponStateBeforeReload = CurrentWeaponState;
-
-	// Reset the force to reload flag
-	bForceReloadToNone = false;
-
-	// Set the reload state
-	SetWeaponState(ENWPWeaponState::Reloading);
-}
-
-void ANWPWeapon::ReloadMagazine()
-{
-	// Calculate the ammo to reload
-	float AmmoDelta = CurrentWeaponConfig->GetAmmoPerMagazine() - CurrentAmmoInMagazine;
-	float AmmoToReload = CurrentAmmo >= AmmoDelta ? AmmoDelta : CurrentAmmo;
-
-	CurrentAmmo -= AmmoToReload;
-	CurrentAmmoInMagazine += AmmoToReload;
-}
-	
-void ANWPWeapon::SpawProjectile()
-{
-	// Spawn projectile if configured
-	if (OwnerCharacter && CurrentWeaponConfig)
-	{
-		UWorld* World = GetWorld();
-
-		if (World)
-		{
-			// Calculate the spawn position / rotation
-			FVector SpawnLocation;
-			FRotator SpawnRotation;
-			bool bMuzzleSocketIsValid = FirstPersonGun->DoesSocketExist(FName(*CurrentWeaponConfig->GetMuzzleBoneName()));
-			FTransform MuzzleTransform;
-
-			// Calculate muzzle transform
-			if(bMuzzleSocketIsValid)
-			{
-				// Add the offsets to the socket transform
-				MuzzleTransform = FirstPersonGun->GetSocketTransform(FName(*CurrentWeaponConfig->GetMuzzleBoneName()));
-				FVector TransformedOffset = MuzzleTransform.TransformVector(CurrentWeaponConfig->GetMuzzleBoneOffsetLocation());
-				MuzzleTransform.SetLocation(MuzzleTransform.GetLocation() + TransformedOffset);
-				MuzzleTransform.SetRotation((MuzzleTransform.GetRotation().Rotator() + CurrentWeaponConfig->GetMuzzleBoneOffsetRotation()).Quaternion());
-			}
-
-			// Check if the socket exists & the shot is from the muzzle
-			if (bMuzzleSocketIsValid && !CurrentWeaponConfig->ShouldUseEyesAsShootOrigin())
-			{
-				SpawnLocation = MuzzleTransform.GetLocation();
-				SpawnRotation = MuzzleTransform.GetRotation().Rotator();
-			}
-			else
-			{
-				// Get the eyes location / rotation
-				OwnerCharacter->GetActorEyesViewPoint(SpawnLocation, SpawnRotation);
-				const FTransform EyesTransform = FTransform(SpawnRotation, SpawnLocation);
-				SpawnLocation += EyesTransform.TransformVector(CurrentWeaponConfig->GetEyesOffsetLocation());
-				SpawnRotation += CurrentWeaponConfig->GetEyesOffsetRotation();
-			}
-
-			// Calculate end position
-			FVector EndPosition = SpawnLocation + SpawnRotation.Vector() * CurrentWeaponConfig->GetShootDistance();
-
-#if !UE_BUILD_SHIPPING 
-			// Draw the expected trajectory
-			if (CVarbDebugWeapon.GetValueOnGameThread())
-			{
-				DrawDebugLine(World, SpawnLocation, EndPosition, FColor::Green, false, 1.0f, 0.0f, 3.0f);
-			}	
-#endif
-
-			// Check if a projectile has to be spawned
-			if (CurrentWeaponConfig->ShouldUseProjectileAsAmmo())
-			{
-				// Spawn the projectile
-				FActorSpawnParameters ActorSpawnParams;
-				ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
-
-				// TODO: [NWP-REVIEW] Implement a projectile pool
-				ANWPProjectile* SpawnedProjectile = World->SpawnActor<ANWPProjectile>(CurrentWeaponConfig->GetDefaultProjectileClass(), SpawnLocation, SpawnRotation, ActorSpawnParams);
-
-				// Set the owner weapon
-				SpawnedProjectile->SetOwnerWeapon(this);
-
-				// Add the projectile to the projectiles list
-				CurrentSpawnedProjectiles.Add(SpawnedProjectile);
-			}
-			else
-			{
-				// Shoot a ray
-				FCollisionQueryParams QueryParams;
-
-				// Ignore the weapon & character
-				QueryParams.AddIgnoredActor(this);
-				QueryParams.AddIgnoredActor(OwnerCharacter);
-
-				QueryParams.bTraceComplex = true;
-
-				FHitResult Hit;
-
-				// Shoot a ray from the projectile to the target
-				if (World->LineTraceSingleByChannel(Hit, SpawnLocation, EndPosition, COLLISION_WEAPON, QueryParams))
-				{
-					UE_LOG(LogNWP, Log, TEXT("Shot has hit: HitActor: %s HitComponent: %s "), *Hit.GetActor()->GetName(), *Hit.GetComponent()->GetName());
-				}
-			}
-
-			// Spawn the shot effect & muzzle sound at the muzzle if possible
-			if (bMuzzleSocketIsValid)
-			{
-				if (CurrentWeaponConfig->GetMuzzleEffect() != nullptr)
-				{
-					UGameplayStatics::SpawnEmitterAttached(CurrentWeaponConfig->GetMuzzleEffect(), FirstPersonGun, FName(*CurrentWeaponConfig->GetMuzzleBoneName()));
-				}
-
-				if (CurrentWeaponConfig->GetShootSound() != nullptr)
-				{
-					UGameplayStatics::PlaySoundAtLocation(World, CurrentWeaponConfig->GetShootSound(), MuzzleTransform.GetLocation());
-				}
-			}
-		}
-	}
-}
-
-void ANWPWeapon::OnProjectileIsGoingToBeDestroyed(ANWPProjectile* _ProjectileToProcess)
-{
-	// Remove the projectile from the list
-	CurrentSpawnedProjectiles.Remove(_ProjectileToProcess);
-}
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeapon.h"
+
+// UE
+#include "Kismet/GameplayStatics.h"
+#include "Math/UnrealMathUtility.h"
+#include "DrawDebugHelpers.h"
+#include "EngineUtils.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+// NWP
+#include "NeuronTestCharacter.h"
+#include "NWPProjectilePool.h"
+#include "NWPProjectileSimulation.h"
+#include "NWPTraceQuality.h"
+#include "NWPUtils.h"
+#include "NWPWeaponConfigCache.h"
+
+// The simulation uses plain mirrors of the weapon enums, so they are converted by casting
+static_assert((uint8)ENWPWeaponSimulationState::Invalid == (uint8)ENWPWeaponState::Invalid && (uint8)ENWPWeaponSimulationState::None == (uint8)ENWPWeaponState::None
+	&& (uint8)ENWPWeaponSimulationState::Shooting == (uint8)ENWPWeaponState::Shooting && (uint8)ENWPWeaponSimulationState::Reloading == (uint8)ENWPWeaponState::Reloading,
+	"ENWPWeaponSimulationState must mirror ENWPWeaponState");
+static_assert((uint8)ENWPWeaponSimulationCadenceType::Automatic == (uint8)ENWPWeaponCadenceType::Automatic
+	&& (uint8)ENWPWeaponSimulationCadenceType::SemiAutomatic == (uint8)ENWPWeaponCadenceType::SemiAutomatic
+	&& (uint8)ENWPWeaponSimulationCadenceType::COUNT == (uint8)ENWPWeaponCadenceType::COUNT,
+	"ENWPWeaponSimulationCadenceType must mirror ENWPWeaponCadenceType");
+
+// Stats
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Async Traces Submitted"), STAT_NWPHitscanAsyncTraces, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Async Traces Deferred"), STAT_NWPHitscanAsyncTracesDeferred, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Async Refinement Traces"), STAT_NWPHitscanAsyncRefinementTraces, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stale Projectile Handles"), STAT_NWPStaleProjectileHandles, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leaked Projectiles"), STAT_NWPLeakedProjectiles, STATGROUP_NWP);
+
+// Console variables
+TAutoConsoleVariable<int32> CVarbDebugWeapon(
+	TEXT("NWP.bDebugWeapon"),
+	0,
+	TEXT("Shows the debug information of the weapon.\n")
+	TEXT("0: Disables display of weapon debug information. \n")
+	TEXT("1: Enables display of weapon debug information. \n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarbUseProjectilePool(
+	TEXT("NWP.bUseProjectilePool"),
+	1,
+	TEXT("Recycles the projectiles using the projectile pool instead of spawning / destroying them.\n")
+	TEXT("0: Projectiles are spawned and destroyed for each shot. \n")
+	TEXT("1: Projectiles are acquired from / released to the projectile pool. \n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMaxShotsPerTick(
+	TEXT("NWP.MaxShotsPerTick"),
+	32,
+	TEXT("Maximum number of shots that a weapon accumulating sub frame shots can fire in a single frame.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarHitscanTraceBudget(
+	TEXT("NWP.HitscanTraceBudget"),
+	64,
+	TEXT("Maximum number of asynchronous hitscan traces submitted per frame. The remaining shots wait for the next frame.\n")
+	TEXT("0: Unlimited. \n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarbUseWeaponManager(
+	TEXT("NWP.bUseWeaponManager"),
+	1,
+	TEXT("Whether the weapons are updated by the weapon manager of the world instead of ticking by themselves.\n")
+	TEXT("Only applied to the weapons that begin play after changing it.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarProjectileLeakCheckInterval(
+	TEXT("NWP.ProjectileLeakCheckInterval"),
+	0.0f,
+	TEXT("Seconds between the checks of the spawned projectiles of the weapons against the projectiles in flight. Not available in shipping.\n")
+	TEXT("Reports the leaked projectiles & warns when they keep growing during a soak run. 0 disables the checks.\n"),
+	ECVF_Default);
+
+// Budget of the asynchronous hitscan traces shared by all the weapons
+static FNWPFrameBudget HitscanTraceBudget;
+
+// Console commands
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorld ReportProjectileLifecycleCommand(
+	TEXT("NWP.ReportProjectileLifecycle"),
+	TEXT("Compares the spawned projectiles of every weapon with the projectiles in flight & writes the result to the log."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const FNWPProjectileLifecycleReport Report = ANWPWeapon::BuildProjectileLifecycleReport(World);
+
+		if (Report.GetNumLeakedProjectiles() > 0)
+		{
+			UE_LOG(LogNWP, Warning, TEXT("NWP.ReportProjectileLifecycle: Weapons: %d Spawned: %d Live: %d Stale: %d Leaked: %d"),
+				Report.NumWeapons, Report.NumSpawnedProjectiles, Report.NumLiveProjectiles, Report.NumStaleProjectiles, Report.GetNumLeakedProjectiles());
+		}
+		else
+		{
+			UE_LOG(LogNWP, Log, TEXT("NWP.ReportProjectileLifecycle: Weapons: %d Spawned: %d Live: %d No leaks"),
+				Report.NumWeapons, Report.NumSpawnedProjectiles, Report.NumLiveProjectiles);
+		}
+	}));
+#endif
+
+#if !UE_BUILD_SHIPPING
+// Number of consecutive checks with more leaked projectiles after which the leak is reported as growing
+static const int32 NumLeakGrowthChecksToWarn = 3;
+
+// State of the projectile leak check of a world
+struct FNWPProjectileLeakCheck
+{
+	// Time until the next check
+	float TimeUntilCheck = 0.0f;
+
+	// Leaked projectiles found by the last check
+	int32 LastLeakedProjectiles = 0;
+
+	// Number of consecutive checks in which the leaked projectiles have grown
+	int32 NumLeakGrowthChecks = 0;
+};
+
+// Projectile leak check of each world. Hooked to the world ticks, so it runs whether the weapons are managed or not
+static TMap<TWeakObjectPtr<UWorld>, FNWPProjectileLeakCheck> ProjectileLeakChecks;
+
+// Compares the spawned projectiles of the weapons of a world with the projectiles in flight every check interval
+static void UpdateProjectileLeakCheck(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	const float CheckInterval = CVarProjectileLeakCheckInterval.GetValueOnGameThread();
+
+	// Early return if disabled or not a game world
+	if (CheckInterval <= 0.0f || !World || !World->IsGameWorld())
+	{
+		return;
+	}
+
+	FNWPProjectileLeakCheck& LeakCheck = ProjectileLeakChecks.FindOrAdd(World);
+
+	// Early return if not the time yet
+	LeakCheck.TimeUntilCheck -= DeltaSeconds;
+
+	if (LeakCheck.TimeUntilCheck > 0.0f)
+	{
+		return;
+	}
+
+	LeakCheck.TimeUntilCheck = CheckInterval;
+
+	const FNWPProjectileLifecycleReport Report = ANWPWeapon::BuildProjectileLifecycleReport(World);
+	const int32 NumLeakedProjectiles = Report.GetNumLeakedProjectiles();
+
+	SET_DWORD_STAT(STAT_NWPLeakedProjectiles, NumLeakedProjectiles);
+
+	// Count the consecutive checks in which the leak grows
+	LeakCheck.NumLeakGrowthChecks = NumLeakedProjectiles > LeakCheck.LastLeakedProjectiles ? LeakCheck.NumLeakGrowthChecks + 1 : 0;
+	LeakCheck.LastLeakedProjectiles = NumLeakedProjectiles;
+
+	if (NumLeakedProjectiles > 0)
+	{
+		UE_LOG(LogNWP, Warning, TEXT("UpdateProjectileLeakCheck: Leaked projectiles: %d Spawned: %d Live: %d Stale: %d Weapons: %d"),
+			NumLeakedProjectiles, Report.NumSpawnedProjectiles, Report.NumLiveProjectiles, Report.NumStaleProjectiles, Report.NumWeapons);
+	}
+
+	if (LeakCheck.NumLeakGrowthChecks >= NumLeakGrowthChecksToWarn)
+	{
+		UE_LOG(LogNWP, Error, TEXT("UpdateProjectileLeakCheck: The leaked projectiles have grown during the last %d checks"), LeakCheck.NumLeakGrowthChecks);
+	}
+}
+
+// Forgets the projectile leak check of a world that is cleaned up
+static void RemoveProjectileLeakCheck(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	ProjectileLeakChecks.Remove(World);
+}
+
+// Hooks the projectile leak check to the world ticks. Only the first call hooks it
+static void HookProjectileLeakCheck()
+{
+	static bool bIsHooked = false;
+
+	// Early return if already hooked
+	if (bIsHooked)
+	{
+		return;
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.AddStatic(&UpdateProjectileLeakCheck);
+	FWorldDelegates::OnWorldCleanup.AddStatic(&RemoveProjectileLeakCheck);
+	bIsHooked = true;
+}
+#endif
+
+ANWPWeapon::ANWPWeapon(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Create a gun mesh component
+	FirstPersonGun = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("FirstPersonGun"));
+	//FirstPersonGun->SetOnlyOwnerSee(true);			// only the owning player will see this mesh
+	FirstPersonGun->bCastDynamicShadow = false;
+	FirstPersonGun->CastShadow = false;
+	// FP_Gun->SetupAttachment(Mesh1P, TEXT("GripPoint"));
+	FirstPersonGun->SetupAttachment(RootComponent);
+
+	// Initialize members
+	CurrentWeaponConfig = nullptr;
+	CurrentWeaponConfigCache = nullptr;
+	LastStateChangeCounter = 0;
+	OwnerWeaponManager = nullptr;
+	WeaponManagerIndex = INDEX_NONE;
+	bIsWeaponActive = true;
+	CurrentProjectilePool = nullptr;
+	CurrentProjectileSimulation = nullptr;
+	PreviousShotLocation = FVector::ZeroVector;
+	PreviousShotRotation = FRotator::ZeroRotator;
+	bHasPreviousShotOrigin = false;
+	NextHitscanTraceId = 0;
+	bLoadWeaponConfigAsync = true;
+	WeaponConfigLoadPriority = FStreamableManager::AsyncLoadHighPriority;
+	PlaceholderWeaponMesh = nullptr;
+
+	// Bind the asynchronous hitscan callbacks
+	HitscanTraceDelegate.BindUObject(this, &ANWPWeapon::OnHitscanTraceCompleted);
+	HitscanRefinementDelegate.BindUObject(this, &ANWPWeapon::OnHitscanRefinementCompleted);
+}
+
+void ANWPWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+
+#if !UE_BUILD_SHIPPING
+	HookProjectileLeakCheck();
+#endif
+
+	// Let the weapon manager update the weapon instead of ticking
+	if (CVarbUseWeaponManager.GetValueOnGameThread())
+	{
+		ANWPWeaponManager* WeaponManager = ANWPWeaponManager::GetWeaponManager(GetWorld());
+
+		if (WeaponManager)
+		{
+			WeaponManager->RegisterWeapon(this);
+			SetActorTickEnabled(false);
+		}
+	}
+
+	// Set the state to none
+	SetWeaponState(ENWPWeaponState::None);
+}
+
+void ANWPWeapon::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Execute the update methods 
+	GetMutableSimulation().UpdateCoolDown(DeltaSeconds);
+	SyncWeaponState();
+
+	UpdateWeapon(DeltaSeconds);
+
+	// Stop ticking once a holstered weapon has resolved all its shots
+	if (!bIsWeaponActive && !HasShotsInFlight())
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void ANWPWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leave the weapon manager, the simulation is moved back to the weapon
+	if (OwnerWeaponManager)
+	{
+		OwnerWeaponManager->UnregisterWeapon(this);
+	}
+
+	// Forget the hitscan shots that are waiting
+	PendingHitscanShots.Empty();
+	InFlightHitscanShots.Empty();
+	InFlightHitscanRefinements.Empty();
+
+	// The projectiles in flight can not tell this weapon anymore
+	ReleaseSpawnedProjectiles();
+
+	// Remove the simulated projectiles, they can not tell this weapon anymore
+	if (CurrentProjectileSimulation)
+	{
+		CurrentProjectileSimulation->RemoveProjectilesOfWeapon(this);
+		CurrentProjectileSimulation = nullptr;
+	}
+
+	// Release the assets & stop the load in progress
+	ReleaseWeapon();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANWPWeapon::LoadWeapon(TSubclassOf<class UNWPWeaponConfig> _WeaponConfig)
+{
+	// Check if the weapon is currently configured
+	if (CurrentWeaponConfig)
+	{
+		// Release if configured
+		ReleaseWeapon();
+	}
+
+	// Cache the weapon config cache
+	if (!CurrentWeaponConfigCache)
+	{
+		CurrentWeaponConfigCache = ANWPWeaponConfigCache::GetWeaponConfigCache(GetWorld());
+	}
+
+	// Early return if there is no cache to acquire the weapon config from
+	if (!CurrentWeaponConfigCache)
+	{
+		return;
+	}
+
+	// Acquire the weapon config shared by every weapon of the same config class
+	CurrentWeaponConfig = CurrentWeaponConfigCache->AcquireWeaponConfig(_WeaponConfig.Get() ? _WeaponConfig : DefaultWeaponConfigClass);
+
+	// Show the placeholder until the weapon mesh is loaded
+	FirstPersonGun->SetSkeletalMesh(PlaceholderWeaponMesh);
+
+	// Configure the weapon, so it can be used while the assets are loaded
+	ConfigureWeapon();
+
+	// Load the weapon config. If another weapon has already loaded it, the callback is executed immediately
+	FNWPOnWaponConfigLoaded WeaponCofigLoadedDelegate = FNWPOnWaponConfigLoaded::CreateUObject(this, &ANWPWeapon::OnWeaponLoaded);
+	CurrentWeaponConfigCache->LoadWeaponConfig(CurrentWeaponConfig, !bLoadWeaponConfigAsync, WeaponCofigLoadedDelegate, WeaponConfigLoadPriority);
+}
+
+bool ANWPWeapon::IsWeaponLoaded() const
+{
+	return CurrentWeaponConfig && CurrentWeaponConfig->IsLoaded();
+}
+
+void ANWPWeapon::ReleaseWeapon()
+{
+	// Check if the weapon is currently configured
+	if (CurrentWeaponConfig)
+	{
+		// The cache may have been removed before the weapon when the world is torn down
+		if (IsValid(CurrentWeaponConfigCache))
+		{
+			CurrentWeaponConfigCache->ReleaseWeaponConfig(CurrentWeaponConfig, this);
+		}
+
+		CurrentWeaponConfig = nullptr;
+	}
+
+	RuntimeProfile.Reset();
+}
+
+void ANWPWeapon::SwapCadenceType()
+{
+	// Swap between automatic / semi automatic if the weapon is not busy or cooling down
+	if (CurrentWeaponConfig)
+	{
+		GetMutableSimulation().SwapCadenceType();
+	}
+}
+
+int32 ANWPWeapon::CountStaleSpawnedProjectiles() const
+{
+	int32 NumStaleProjectiles = 0;
+
+	for (int32 ProjectileIndex = 0; ProjectileIndex < CurrentSpawnedProjectiles.Num(); ++ProjectileIndex)
+	{
+		const ANWPProjectile* Projectile = CurrentSpawnedProjectiles[ProjectileIndex];
+
+		// A spawned projectile has to be in flight, fired by this weapon & reachable by its handle
+		if (!Projectile || Projectile->IsPendingKill() || Projectile->IsInPool() || Projectile->GetOwnerWeapon() != this || 
+			FindSpawnedProjectileIndex(Projectile) != ProjectileIndex)
+		{
+			++NumStaleProjectiles;
+		}
+	}
+
+	return NumStaleProjectiles;
+}
+
+FNWPProjectileLifecycleReport ANWPWeapon::BuildProjectileLifecycleReport(UWorld* _World)
+{
+	FNWPProjectileLifecycleReport Report;
+
+	// Early return if no world
+	if (!_World)
+	{
+		return Report;
+	}
+
+	// Gather the spawned projectiles of the weapons
+	for (TActorIterator<ANWPWeapon> It(_World); It; ++It)
+	{
+		++Report.NumWeapons;
+		Report.NumSpawnedProjectiles += It->GetNumSpawnedProjectiles();
+		Report.NumStaleProjectiles += It->CountStaleSpawnedProjectiles();
+	}
+
+	// Count the projectiles in flight that belong to a weapon
+	for (TActorIterator<ANWPProjectile> It(_World); It; ++It)
+	{
+		if (!It->IsPendingKill() && !It->IsInPool() && It->GetOwnerWeapon())
+		{
+			++Report.NumLiveProjectiles;
+		}
+	}
+
+	return Report;
+}
+
+void ANWPWeapon::SetOwnerCharacter(class ANeuronTestCharacter* _NewOwnerCharacter, bool _bAttachToOwner)
+{
+	// Set the new value
+	OwnerCharacter = _NewOwnerCharacter;
+
+	// Attach to the owner if required
+	if (_bAttachToOwner)
+	{
+		AttachToOwner();
+	}
+}
+
+void ANWPWeapon::AttachToOwner()
+{
+	USkeletalMeshComponent* OwnerSkelletalMesh = OwnerCharacter->GetNWPSkelletalMeshComponent();
+	check(OwnerSkelletalMesh);
+
+	// Attach gun actor to owner skelleton
+	AttachToComponent(OwnerSkelletalMesh, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
+}
+
+void ANWPWeapon::DetachFromOwner()
+{
+	// Detach the root component from his parent
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+}
+
+void ANWPWeapon::ActivateWeapon()
+{
+	bIsWeaponActive = true;
+
+	// Attach to the owner hand
+	if (HasOwner())
+	{
+		AttachToOwner();
+	}
+
+	// Show the weapon, restore its collision & resume the updates. The weapon manager updates the managed weapons
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(!IsManagedByWeaponManager());
+
+	if (OwnerWeaponManager)
+	{
+		OwnerWeaponManager->WakeWeapon(WeaponManagerIndex);
+	}
+}
+
+void ANWPWeapon::DeactivateWeapon()
+{
+	bIsWeaponActive = false;
+
+	// Stop the shooting, the shots already fired are still resolved
+	StopShooting();
+
+	// The shot origin is not valid anymore, so the accumulated shots are not interpolated from it
+	bHasPreviousShotOrigin = false;
+
+	// Hide the weapon, disable its collision & detach it from the owner hand, so the holstered weapons are not hit by the traces
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	DetachFromOwner();
+}
+
+void ANWPWeapon::AdvanceSimulation()
+{
+	// Early return if the weapon is not managed
+	if (!OwnerWeaponManager)
+	{
+		return;
+	}
+
+	// The reload may finish while advancing
+	OwnerWeaponManager->AdvanceSimulation(WeaponManagerIndex);
+	SyncWeaponState();
+}
+
+void ANWPWeapon::StartShooting()
+{
+	// The cool down may have expired since the weapon was last updated by the weapon manager
+	AdvanceSimulation();
+
+	// Return if weapon busy, cooling down or invalid weapon config
+	if (!GetSimulation().CanStartShooting())
+	{
+		return;
+	}
+
+	// Evaluate if the weapon is automatic / semi automatic
+	if (CurrentWeaponConfig)
+	{
+		// Always execute a shoot step
+		if (!InternalShootStep() && GetSimulation().GetParams().bIsAutomatic)
+		{
+			// Set the shooting state
+			SetWeaponState(ENWPWeaponState::Shooting);
+		}
+	}
+}
+
+void ANWPWeapon::StopShooting()
+{
+	// Stop the shooting. If reloading, the weapon goes to none when the reload finishes
+	GetMutableSimulation().StopShooting();
+	SyncWeaponState();
+}
+
+void ANWPWeapon::ConfigureWeapon()
+{
+	// Bake the profile used by the fire path
+	BakeRuntimeProfile();
+
+	// Check if the weapon is configured
+	if (CurrentWeaponConfig)
+	{
+		// Configure the simulation, restoring the cadence & the ammo
+		FNWPWeaponSimulationParams SimulationParams;
+
+		for (int32 CadenceIndex = 0; CadenceIndex < (int32)ENWPWeaponSimulationCadenceType::COUNT; ++CadenceIndex)
+		{
+			SimulationParams.CoolDowns[CadenceIndex] = CurrentWeaponConfig->GetCoolDownForCadenceType((ENWPWeaponCadenceType)CadenceIndex);
+		}
+
+		SimulationParams.MagazineReloadTime = CurrentWeaponConfig->GetMagazineReloadTime();
+		SimulationParams.InitialAmmo = CurrentWeaponConfig->GetInitialAmmo();
+		SimulationParams.MaximumAmmo = CurrentWeaponConfig->GetMaximumAmmo();
+		SimulationParams.AmmoPerMagazine = CurrentWeaponConfig->GetAmmoPerMagazine();
+		SimulationParams.DefaultCadenceType = (ENWPWeaponSimulationCadenceType)CurrentWeaponConfig->GetCadenceType();
+		SimulationParams.bIsAutomatic = CurrentWeaponConfig->IsAutomatic();
+		SimulationParams.bIsSemiAutomatic = CurrentWeaponConfig->IsSemiAutomatic();
+		SimulationParams.bAccumulateSubFrameShots = CurrentWeaponConfig->ShouldAccumulateSubFrameShots();
+
+		GetMutableSimulation().Configure(SimulationParams);
+
+		// Prewarm the projectile pool
+		if (CurrentWeaponConfig->ShouldUseProjectileAsAmmo() && CVarbUseProjectilePool.GetValueOnGameThread())
+		{
+			CurrentProjectilePool = ANWPProjectilePool::GetProjectilePool(GetWorld());
+
+			if (CurrentProjectilePool)
+			{
+				CurrentProjectilePool->PrewarmProjectiles(CurrentWeaponConfig->GetDefaultProjectileClass(), CurrentWeaponConfig->GetProjectilePoolPrewarmSize());
+			}
+		}
+	}
+}
+
+void ANWPWeapon::OnWeaponLoaded()
+{
+	// Check if the weapon is configured
+	if (CurrentWeaponConfig)
+	{
+		// Configure the components
+		FirstPersonGun->SetSkeletalMesh(CurrentWeaponConfig->GetWeaponMesh());
+	}
+
+	// Bake the profile again, the muzzle has to be resolved in the loaded mesh & the effects are resident now
+	BakeRuntimeProfile();
+}
+
+void ANWPWeapon::BakeRuntimeProfile()
+{
+	RuntimeProfile.Reset();
+
+	// Early return if not configured
+	if (!CurrentWeaponConfig)
+	{
+		return;
+	}
+
+	RuntimeProfile.ShootDistance = CurrentWeaponConfig->GetShootDistance();
+
+	// Copy the offsets & remember if they have to be added
+	RuntimeProfile.MuzzleOffsetLocation = CurrentWeaponConfig->GetMuzzleBoneOffsetLocation();
+	RuntimeProfile.MuzzleOffsetRotation = CurrentWeaponConfig->GetMuzzleBoneOffsetRotation();
+	RuntimeProfile.EyesOffsetLocation = CurrentWeaponConfig->GetEyesOffsetLocation();
+	RuntimeProfile.EyesOffsetRotation = CurrentWeaponConfig->GetEyesOffsetRotation();
+	RuntimeProfile.bHasMuzzleOffset = !RuntimeProfile.MuzzleOffsetLocation.IsZero() || !RuntimeProfile.MuzzleOffsetRotation.IsZero();
+	RuntimeProfile.bHasEyesOffset = !RuntimeProfile.EyesOffsetLocation.IsZero() || !RuntimeProfile.EyesOffsetRotation.IsZero();
+
+	// Copy the assets. The config keeps them referenced
+	RuntimeProfile.ProjectileClass = CurrentWeaponConfig->GetDefaultProjectileClass();
+	RuntimeProfile.SimulatedProjectileMesh = CurrentWeaponConfig->GetSimulatedProjectileMesh();
+	RuntimeProfile.MuzzleEffect = CurrentWeaponConfig->GetMuzzleEffect();
+	RuntimeProfile.ShootSound = CurrentWeaponConfig->GetShootSound();
+
+	// Pack the flags
+	RuntimeProfile.bUseProjectileAsAmmo = CurrentWeaponConfig->ShouldUseProjectileAsAmmo();
+	RuntimeProfile.bUseSimulatedProjectiles = CurrentWeaponConfig->ShouldUseSimulatedProjectiles() && RuntimeProfile.SimulatedProjectileMesh;
+	RuntimeProfile.bUseAsyncHitscan = CurrentWeaponConfig->ShouldUseAsyncHitscan();
+	RuntimeProfile.HitscanTraceQuality = CurrentWeaponConfig->GetHitscanTraceQuality();
+	RuntimeProfile.bUseEyesAsShootOrigin = CurrentWeaponConfig->ShouldUseEyesAsShootOrigin();
+
+	// Resolve the muzzle in the current weapon mesh. It can be a socket or a bone
+	const FString& MuzzleBoneName = CurrentWeaponConfig->GetMuzzleBoneName();
+	RuntimeProfile.MuzzleSocketName = MuzzleBoneName.IsEmpty() ? NAME_None : FName(*MuzzleBoneName);
+
+	if (RuntimeProfile.MuzzleSocketName != NAME_None && FirstPersonGun->SkeletalMesh)
+	{
+		RuntimeProfile.MuzzleSocket = FirstPersonGun->SkeletalMesh->FindSocket(RuntimeProfile.MuzzleSocketName);
+
+		if (!RuntimeProfile.MuzzleSocket)
+		{
+			RuntimeProfile.MuzzleBoneIndex = FirstPersonGun->GetBoneIndex(RuntimeProfile.MuzzleSocketName);
+		}
+	}
+
+	RuntimeProfile.bMuzzleSocketIsValid = RuntimeProfile.MuzzleSocket || RuntimeProfile.MuzzleBoneIndex != INDEX_NONE;
+}
+
+void ANWPWeapon::SetWeaponState(ENWPWeaponState _WeaponStateToSet)
+{
+	// Change the weapon state & execute the callback
+	GetMutableSimulation().SetState((ENWPWeaponSimulationState)_WeaponStateToSet);
+	SyncWeaponState();
+}
+
+void ANWPWeapon::SyncWeaponState()
+{
+	// Check if the state has changed
+	if (GetSimulation().GetStateChangeCounter() == LastStateChangeCounter)
+	{
+		return;
+	}
+
+	LastStateChangeCounter = GetSimulation().GetStateChangeCounter();
+	OnWeaponStateChanged();
+}
+
+void ANWPWeapon::UpdateWeapon(float DeltaSeconds)
+{
+	UpdateShootingState(DeltaSeconds);
+
+	SubmitPendingHitscanTraces();
+}
+
+bool ANWPWeapon::NeedsWeaponUpdate() const
+{
+	// While the cool down is active, the shooting waits for its timer. The accumulated shots interpolate the origin of every frame
+	const FNWPWeaponSimulation& CurrentSimulation = GetSimulation();
+	const bool bShootingNeedsUpdate = IsShooting() && (CurrentSimulation.IsSubFrameFireAccumulatorActive() || !CurrentSimulation.IsCoolDownActive());
+
+	return bShootingNeedsUpdate || PendingHitscanShots.Num() > 0;
+}
+
+void ANWPWeapon::OnWeaponStateChanged()
+{
+	// Check the weapon state
+	switch (GetSimulation().GetState())
+	{
+	case ENWPWeaponSimulationState::Shooting:
+
+		if (OwnerCharacter)
+		{
+			OwnerCharacter->OnStartShoot();
+		}
+
+		break;
+	}
+}
+
+void ANWPWeapon::UpdateShootingState(float DeltaSeconds)
+{
+	// Check if the state is shooting
+	if (GetSimulation().GetState() != ENWPWeaponSimulationState::Shooting)
+	{
+		bHasPreviousShotOrigin = false;
+		return;
+	}
+
+	// Emit every shot that is due during this frame
+	if (GetSimulation().IsSubFrameFireAccumulatorActive())
+	{
+		UpdateAccumulatedShots(DeltaSeconds);
+		return;
+	}
+
+	// Check if the cool down is active
+	if (GetSimulation().IsCoolDownActive())
+	{
+		return;
+	}
+
+	// Execute a shoot step
+	InternalShootStep();
+}
+
+void ANWPWeapon::UpdateAccumulatedShots(float DeltaSeconds)
+{
+	UWorld* World = GetWorld();
+
+	// Early return if not configured
+	if (!OwnerCharacter || !CurrentWeaponConfig || !World)
+	{
+		return;
+	}
+
+	// Calculate the origin at the end of the frame
+	FVector CurrentShotLocation;
+	FRotator CurrentShotRotation;
+	FTransform MuzzleTransform;
+
+	bool bMuzzleSocketIsValid = ComputeShotOrigin(CurrentShotLocation, CurrentShotRotation, MuzzleTransform);
+
+	// The first accumulated frame has no previous origin to interpolate from
+	if (!bHasPreviousShotOrigin)
+	{
+		PreviousShotLocation = CurrentShotLocation;
+		PreviousShotRotation = CurrentShotRotation;
+		bHasPreviousShotOrigin = true;
+	}
+
+	const int32 MaxShotsPerTick = FMath::Max(1, CVarMaxShotsPerTick.GetValueOnGameThread());
+	const FQuat PreviousShotQuat = PreviousShotRotation.Quaternion();
+	const FQuat CurrentShotQuat = CurrentShotRotation.Quaternion();
+
+	// Consume every shot that is due. The simulation starts the reload if the magazine runs out
+	ShotTimeOffsets.SetNumUninitialized(MaxShotsPerTick, false);
+	const int32 NumShots = GetMutableSimulation().ConsumeDueShots(DeltaSeconds, MaxShotsPerTick, ShotTimeOffsets.GetData());
+	SyncWeaponState();
+
+	CurrentShotBatch.Reset();
+
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+	{
+		// Interpolate the origin to the moment in which the shot was due
+		FNWPShotData ShotData;
+		ShotData.TimeOffset = ShotTimeOffsets[ShotIndex];
+		ShotData.TimeStamp = World->GetTimeSeconds() - ShotData.TimeOffset;
+
+		float Alpha = DeltaSeconds > 0.0f ? 1.0f - ShotData.TimeOffset / DeltaSeconds : 1.0f;
+		ShotData.Location = FMath::Lerp(PreviousShotLocation, CurrentShotLocation, Alpha);
+		ShotData.Rotation = FQuat::Slerp(PreviousShotQuat, CurrentShotQuat, Alpha).Rotator();
+
+		CurrentShotBatch.Add(ShotData);
+	}
+
+	// Fire all the shots of this frame as a single batch
+	SpawProjectiles(CurrentShotBatch, bMuzzleSocketIsValid, MuzzleTransform);
+
+	// Cache the origin for the next frame
+	PreviousShotLocation = CurrentShotLocation;
+	PreviousShotRotation = CurrentShotRotation;
+}
+
+bool ANWPWeapon::HasShotsInFlight() const
+{
+	return CurrentSpawnedProjectiles.Num() > 0 || PendingHitscanShots.Num() > 0 || InFlightHitscanShots.Num() > 0 || InFlightHitscanRefinements.Num() > 0;
+}
+
+bool ANWPWeapon::InternalShootStep()
+{
+	// Consume the ammo & reset the cool down. Otherwise, the reload has started
+	const bool bShotConsumed = GetMutableSimulation().ConsumeShot();
+	SyncWeaponState();
+
+	// Spawn the projectile
+	if (bShotConsumed)
+	{
+		SpawProjectile();
+	}
+
+	return !bShotConsumed;
+}
+
+bool ANWPWeapon::ComputeShotOrigin(FVector& _OutLocation, FRotator& _OutRotation, FTransform& _OutMuzzleTransform) const
+{
+	const bool bMuzzleSocketIsValid = RuntimeProfile.bMuzzleSocketIsValid;
+
+	// Calculate muzzle transform using the resolved socket or bone
+	if (bMuzzleSocketIsValid)
+	{
+		_OutMuzzleTransform = RuntimeProfile.MuzzleSocket ? RuntimeProfile.MuzzleSocket->GetSocketTransform(FirstPersonGun) : 
+			FirstPersonGun->GetBoneTransform(RuntimeProfile.MuzzleBoneIndex);
+
+		// Add the offsets to the socket transform
+		if (RuntimeProfile.bHasMuzzleOffset)
+		{
+			FVector TransformedOffset = _OutMuzzleTransform.TransformVector(RuntimeProfile.MuzzleOffsetLocation);
+			_OutMuzzleTransform.SetLocation(_OutMuzzleTransform.GetLocation() + TransformedOffset);
+			_OutMuzzleTransform.SetRotation((_OutMuzzleTransform.GetRotation().Rotator() + RuntimeProfile.MuzzleOffsetRotation).Quaternion());
+		}
+	}
+
+	// Check if the socket exists & the shot is from the muzzle
+	if (bMuzzleSocketIsValid && !RuntimeProfile.bUseEyesAsShootOrigin)
+	{
+		_OutLocation = _OutMuzzleTransform.GetLocation();
+		_OutRotation = _OutMuzzleTransform.GetRotation().Rotator();
+	}
+	else
+	{
+		// Get the eyes location / rotation
+		OwnerCharacter->GetActorEyesViewPoint(_OutLocation, _OutRotation);
+
+		if (RuntimeProfile.bHasEyesOffset)
+		{
+			const FTransform EyesTransform = FTransform(_OutRotation, _OutLocation);
+			_OutLocation += EyesTransform.TransformVector(RuntimeProfile.EyesOffsetLocation);
+			_OutRotation += RuntimeProfile.EyesOffsetRotation;
+		}
+	}
+
+	return bMuzzleSocketIsValid;
+}
+
+void ANWPWeapon::SpawProjectile()
+{
+	// Spawn projectile if configured
+	if (!OwnerCharacter || !CurrentWeaponConfig || !GetWorld())
+	{
+		return;
+	}
+
+	FNWPShotData ShotData;
+	FTransform MuzzleTransform;
+
+	// The shot is emitted right now from the current origin
+	bool bMuzzleSocketIsValid = ComputeShotOrigin(ShotData.Location, ShotData.Rotation, MuzzleTransform);
+	ShotData.TimeStamp = GetWorld()->GetTimeSeconds();
+
+	CurrentShotBatch.Reset();
+	CurrentShotBatch.Add(ShotData);
+
+	SpawProjectiles(CurrentShotBatch, bMuzzleSocketIsValid, MuzzleTransform);
+}
+
+void ANWPWeapon::SpawProjectiles(const TArray<FNWPShotData>& _Shots, bool _bMuzzleSocketIsValid, const FTransform& _MuzzleTransform)
+{
+	UWorld* World = GetWorld();
+
+	// Early return if not configured or nothing to shoot
+	if (!OwnerCharacter || !CurrentWeaponConfig || !World || _Shots.Num() == 0)
+	{
+		return;
+	}
+
+	// Fire every shot of the batch
+	for (int32 Index = 0; Index < _Shots.Num(); ++Index)
+	{
+		FireShot(_Shots[Index]);
+	}
+
+	// Spawn the shot effect & muzzle sound at the muzzle if possible. Only once per batch
+	if (_bMuzzleSocketIsValid)
+	{
+		if (RuntimeProfile.MuzzleEffect != nullptr)
+		{
+			UGameplayStatics::SpawnEmitterAttached(RuntimeProfile.MuzzleEffect, FirstPersonGun, RuntimeProfile.MuzzleSocketName);
+		}
+
+		if (RuntimeProfile.ShootSound != nullptr)
+		{
+			UGameplayStatics::PlaySoundAtLocation(World, RuntimeProfile.ShootSound, _MuzzleTransform.GetLocation());
+		}
+	}
+}
+
+void ANWPWeapon::FireShot(const FNWPShotData& _ShotData)
+{
+	UWorld* World = GetWorld();
+	ANWPProjectile* SpawnedProjectile = nullptr;
+
+	// Calculate end position
+	FVector EndPosition = _ShotData.Location + _ShotData.Rotation.Vector() * RuntimeProfile.ShootDistance;
+
+#if !UE_BUILD_SHIPPING 
+	// Draw the expected trajectory
+	if (CVarbDebugWeapon.GetValueOnGameThread())
+	{
+		DrawDebugLine(World, _ShotData.Location, EndPosition, FColor::Green, false, 1.0f, 0.0f, 3.0f);
+	}	
+#endif
+
+	// Check if a projectile has to be spawned
+	if (RuntimeProfile.bUseProjectileAsAmmo)
+	{
+		// Add the projectile to the simulation if the projectiles are data only
+		if (ShouldUseSimulatedProjectiles())
+		{
+			if (!CurrentProjectileSimulation)
+			{
+				CurrentProjectileSimulation = ANWPProjectileSimulation::GetProjectileSimulation(World);
+			}
+
+			if (CurrentProjectileSimulation)
+			{
+				CurrentProjectileSimulation->SpawnProjectile(this, RuntimeProfile.ProjectileClass, RuntimeProfile.SimulatedProjectileMesh,
+					_ShotData.Location, _ShotData.Rotation, _ShotData.TimeOffset);
+			}
+		}
+		// Acquire the projectile from the pool if enabled
+		else if (CVarbUseProjectilePool.GetValueOnGameThread())
+		{
+			if (!CurrentProjectilePool)
+			{
+				CurrentProjectilePool = ANWPProjectilePool::GetProjectilePool(World);
+			}
+
+			if (CurrentProjectilePool)
+			{
+				SpawnedProjectile = CurrentProjectilePool->AcquireProjectile(RuntimeProfile.ProjectileClass, _ShotData.Location, _ShotData.Rotation, this);
+			}
+		}
+		else
+		{
+			// Spawn the projectile
+			FActorSpawnParameters ActorSpawnParams;
+			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+
+			SpawnedProjectile = World->SpawnActor<ANWPProjectile>(RuntimeProfile.ProjectileClass, _ShotData.Location, _ShotData.Rotation, ActorSpawnParams);
+
+			// Set the owner weapon
+			if (SpawnedProjectile)
+			{
+				SpawnedProjectile->SetOwnerWeapon(this);
+			}
+		}
+
+		if (SpawnedProjectile)
+		{
+			// Add the projectile to the spawned projectiles
+			AddSpawnedProjectile(SpawnedProjectile);
+
+			// Move the projectile to where it should be if it was shot earlier in the frame
+			if (_ShotData.TimeOffset > 0.0f)
+			{
+				SpawnedProjectile->AdvanceSimulation(_ShotData.TimeOffset);
+			}
+		}
+	}
+	else if (RuntimeProfile.bUseAsyncHitscan)
+	{
+		// Queue the shot, the trace is submitted at the end of the tick
+		PendingHitscanShots.Add(_ShotData);
+	}
+	else
+	{
+		// Shoot a ray
+		FCollisionQueryParams QueryParams;
+		BuildHitscanQueryParams(QueryParams);
+
+		FHitResult Hit;
+
+		// Shoot a ray from the projectile to the target
+		bool bHit = FNWPTraceQuality::LineTraceSingleByChannel(World, Hit, _ShotData.Location, EndPosition, COLLISION_WEAPON, QueryParams, 
+			RuntimeProfile.HitscanTraceQuality, ENWPTraceCategory::Hitscan);
+
+		OnHitscanResolved(_ShotData, Hit, bHit);
+	}
+
+	// Tell the child classes that the shot has been fired
+	OnShotFired(_ShotData, SpawnedProjectile);
+}
+
+bool ANWPWeapon::ShouldUseSimulatedProjectiles() const
+{
+	return RuntimeProfile.bUseSimulatedProjectiles;
+}
+
+void ANWPWeapon::OnProjectileIsGoingToBeDestroyed(ANWPProjectile* _ProjectileToProcess)
+{
+	// Remove the projectile from the spawned projectiles
+	RemoveSpawnedProjectile(_ProjectileToProcess);
+}
+
+void ANWPWeapon::AddSpawnedProjectile(ANWPProjectile* _Projectile)
+{
+	const FNWPSparseSetHandle Handle = SpawnedProjectileSet.Add();
+	const int32 ProjectileIndex = CurrentSpawnedProjectiles.Add(_Projectile);
+	check(SpawnedProjectileSet.GetDenseIndex(Handle) == ProjectileIndex);
+
+	_Projectile->SetOwnerWeaponHandle(Handle);
+
+	OnSpawnedProjectileAdded(ProjectileIndex);
+}
+
+bool ANWPWeapon::RemoveSpawnedProjectile(ANWPProjectile* _Projectile)
+{
+	const int32 ProjectileIndex = FindSpawnedProjectileIndex(_Projectile);
+
+	// Early return if the projectile has already been removed
+	if (ProjectileIndex == INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_NWPStaleProjectileHandles);
+		return false;
+	}
+
+	OnSpawnedProjectileRemoved(ProjectileIndex);
+
+	// The set moves the last projectile to the removed index, so the dense arrays do the same
+	SpawnedProjectileSet.Remove(_Projectile->GetOwnerWeaponHandle());
+	CurrentSpawnedProjectiles.RemoveAtSwap(ProjectileIndex, 1, false);
+
+	_Projectile->SetOwnerWeaponHandle(FNWPSparseSetHandle());
+
+	return true;
+}
+
+void ANWPWeapon::ReleaseSpawnedProjectiles()
+{
+	// Remove from the last one, so no projectile is moved
+	for (int32 ProjectileIndex = CurrentSpawnedProjectiles.Num() - 1; ProjectileIndex >= 0; --ProjectileIndex)
+	{
+		ANWPProjectile* Projectile = CurrentSpawnedProjectiles[ProjectileIndex];
+
+		OnSpawnedProjectileRemoved(ProjectileIndex);
+
+		SpawnedProjectileSet.Remove(SpawnedProjectileSet.GetHandle(ProjectileIndex));
+		CurrentSpawnedProjectiles.RemoveAt(ProjectileIndex, 1, false);
+
+		if (Projectile && Projectile->GetOwnerWeapon() == this)
+		{
+			Projectile->SetOwnerWeapon(nullptr);
+		}
+	}
+}
+
+int32 ANWPWeapon::FindSpawnedProjectileIndex(const ANWPProjectile* _Projectile) const
+{
+	// Early return if no projectile
+	if (!_Projectile)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ProjectileIndex = SpawnedProjectileSet.GetDenseIndex(_Projectile->GetOwnerWeaponHandle());
+
+	// The handle is only valid for the weapon that gave it
+	return ProjectileIndex != INDEX_NONE && CurrentSpawnedProjectiles[ProjectileIndex] == _Projectile ? ProjectileIndex : INDEX_NONE;
+}
+
+void ANWPWeapon::BuildHitscanQueryParams(FCollisionQueryParams& _OutQueryParams) const
+{
+	// Ignore the weapon & character
+	_OutQueryParams.AddIgnoredActor(this);
+	_OutQueryParams.AddIgnoredActor(OwnerCharacter);
+
+	// Only the first trace of the quality is done with these params
+	_OutQueryParams.bTraceComplex = FNWPTraceQuality::IsFirstTraceComplex(RuntimeProfile.HitscanTraceQuality);
+	_OutQueryParams.bReturnPhysicalMaterial = true;
+}
+
+void ANWPWeapon::SubmitPendingHitscanTraces()
+{
+	UWorld* World = GetWorld();
+
+	// Early return if nothing to submit
+	if (PendingHitscanShots.Num() == 0 || !World || !CurrentWeaponConfig)
+	{
+		return;
+	}
+
+	FCollisionQueryParams QueryParams;
+	BuildHitscanQueryParams(QueryParams);
+
+	const int32 TraceBudget = CVarHitscanTraceBudget.GetValueOnGameThread();
+	int32 SubmittedShots = 0;
+
+	// Submit the shots in order while there is budget left in this frame
+	for (; SubmittedShots < PendingHitscanShots.Num(); ++SubmittedShots)
+	{
+		if (!HitscanTraceBudget.TryToConsume(TraceBudget))
+		{
+			break;
+		}
+
+		const FNWPShotData& ShotData = PendingHitscanShots[SubmittedShots];
+		FVector EndPosition = ShotData.Location + ShotData.Rotation.Vector() * RuntimeProfile.ShootDistance;
+
+		// Remember the shot, so it can be resolved when the trace finishes
+		uint32 TraceId = NextHitscanTraceId++;
+		InFlightHitscanShots.Add(TraceId, ShotData);
+
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, ShotData.Location, EndPosition, COLLISION_WEAPON, QueryParams, 
+			FCollisionResponseParams::DefaultResponseParam, &HitscanTraceDelegate, TraceId);
+	}
+
+	INC_DWORD_STAT_BY(STAT_NWPHitscanAsyncTraces, SubmittedShots);
+	INC_DWORD_STAT_BY(STAT_NWPHitscanAsyncTracesDeferred, PendingHitscanShots.Num() - SubmittedShots);
+
+	// Keep the shots that did not fit in the budget for the next frame
+	PendingHitscanShots.RemoveAt(0, SubmittedShots, false);
+}
+
+void ANWPWeapon::OnHitscanTraceCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData)
+{
+	FNWPShotData ShotData;
+
+	// Early return if the shot is unknown
+	if (!InFlightHitscanShots.RemoveAndCopyValue(_TraceData.UserData, ShotData))
+	{
+		return;
+	}
+
+	// Single traces return at most one blocking hit
+	FHitResult Hit = _TraceData.OutHits.Num() > 0 ? _TraceData.OutHits[0] : FHitResult();
+	bool bHit = Hit.bBlockingHit;
+
+	// Refine the simple hit with a follow up asynchronous trace, so the complex collision is not traced on the game thread
+	if (bHit && RuntimeProfile.HitscanTraceQuality == ENWPTraceQuality::SimpleThenComplex && !FNWPTraceQuality::IsAuditEnabled())
+	{
+		FNWPHitscanRefinement Refinement;
+		Refinement.ShotData = ShotData;
+		Refinement.SimpleHit = Hit;
+		Refinement.Start = _TraceData.Start;
+		Refinement.End = _TraceData.End;
+		Refinement.bIsWindow = true;
+		FNWPTraceQuality::ComputeRefinementWindow(Hit, _TraceData.Start, _TraceData.End, 0.0f, Refinement.TraceBeginDistance, Refinement.TraceEndDistance);
+
+		SubmitHitscanRefinementTrace(Refinement);
+		return;
+	}
+
+	// Only traces if the traces are audited, the first trace is enough otherwise
+	if (UWorld* World = GetWorld())
+	{
+		FCollisionQueryParams QueryParams;
+		BuildHitscanQueryParams(QueryParams);
+
+		bHit = FNWPTraceQuality::RefineFirstTrace(World, bHit, Hit, _TraceData.Start, _TraceData.End, COLLISION_WEAPON, QueryParams, 
+			RuntimeProfile.HitscanTraceQuality, ENWPTraceCategory::Hitscan);
+	}
+
+	OnHitscanResolved(ShotData, bHit ? Hit : FHitResult(), bHit);
+}
+
+void ANWPWeapon::SubmitHitscanRefinementTrace(const FNWPHitscanRefinement& _Refinement)
+{
+	UWorld* World = GetWorld();
+
+	// Early return if no world
+	if (!World)
+	{
+		return;
+	}
+
+	FCollisionQueryParams QueryParams;
+	BuildHitscanQueryParams(QueryParams);
+	QueryParams.bTraceComplex = true;
+
+	const FVector Direction = (_Refinement.End - _Refinement.Start).GetSafeNormal();
+
+	// Remember the refinement, so the shot can be resolved when the trace finishes
+	uint32 TraceId = NextHitscanTraceId++;
+	InFlightHitscanRefinements.Add(TraceId, _Refinement);
+
+	World->AsyncLineTraceByChannel(EAsyncTraceType::Single, _Refinement.Start + Direction * _Refinement.TraceBeginDistance, 
+		_Refinement.Start + Direction * _Refinement.TraceEndDistance, COLLISION_WEAPON, QueryParams, FCollisionResponseParams::DefaultResponseParam, 
+		&HitscanRefinementDelegate, TraceId);
+
+	INC_DWORD_STAT(STAT_NWPHitscanAsyncRefinementTraces);
+}
+
+void ANWPWeapon::OnHitscanRefinementCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData)
+{
+	FNWPHitscanRefinement Refinement;
+
+	// Early return if the refinement is unknown
+	if (!InFlightHitscanRefinements.RemoveAndCopyValue(_TraceData.UserData, Refinement))
+	{
+		return;
+	}
+
+	// Single traces return at most one blocking hit
+	FHitResult Hit = _TraceData.OutHits.Num() > 0 ? _TraceData.OutHits[0] : FHitResult();
+	const bool bHit = Hit.bBlockingHit;
+
+	if (bHit)
+	{
+		FNWPTraceQuality::MakeHitRelativeToSegment(Hit, Refinement.TraceBeginDistance, Refinement.Start, Refinement.End);
+	}
+	// The complex collision has a hole where the simple one has been hit, trace the rest of the segment against the complex collision
+	else if (Refinement.bIsWindow && Refinement.TraceEndDistance < FVector::Dist(Refinement.Start, Refinement.End))
+	{
+		Refinement.TraceBeginDistance = Refinement.TraceEndDistance;
+		Refinement.TraceEndDistance = FVector::Dist(Refinement.Start, Refinement.End);
+		Refinement.bIsWindow = false;
+
+		SubmitHitscanRefinementTrace(Refinement);
+		return;
+	}
+
+	if (UWorld* World = GetWorld())
+	{
+		FNWPTraceQuality::RecordComparison(World, ENWPTraceCategory::Hitscan, true, Refinement.SimpleHit, bHit, Hit);
+	}
+
+	OnHitscanResolved(Refinement.ShotData, bHit ? Hit : FHitResult(), bHit);
+}
+
+void ANWPWeapon::OnHitscanResolved(const FNWPShotData& _ShotData, const FHitResult& _Hit, bool _bHit)
+{
+	if (_bHit)
+	{
+		UE_LOG(LogNWP, Log, TEXT("Shot has hit: HitActor: %s HitComponent: %s TimeStamp: %.4f"), *GetNameSafe(_Hit.GetActor()), *GetNameSafe(_Hit.GetComponent()), _ShotData.TimeStamp);
+	}
+}
@@ -0,0 +1,335 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeaponManager.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+#include "NWPUtils.h"
+#include "NWPWeapon.h"
+
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Weapon Manager Tick"), STAT_NWPWeaponManagerTick, STATGROUP_NWP);
+DECLARE_CYCLE_STAT(TEXT("Weapon Manager Simulation"), STAT_NWPWeaponManagerSimulation, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Managed Weapons"), STAT_NWPManagedWeapons, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Weapons"), STAT_NWPActiveWeapons, STATGROUP_NWP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Timers"), STAT_NWPWeaponTimers, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Timers Scheduled"), STAT_NWPWeaponTimersScheduled, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Timers Expired"), STAT_NWPWeaponTimersExpired, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon State Callbacks"), STAT_NWPWeaponStateCallbacks, STATGROUP_NWP);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapons Updated"), STAT_NWPWeaponsUpdated, STATGROUP_NWP);
+
+// Console variables
+static TAutoConsoleVariable<int32> CVarWeaponManagerParallelThreshold(
+	TEXT("NWP.WeaponManagerParallelThreshold"),
+	256,
+	TEXT("Number of active managed weapons from which their simulations are advanced in parallel.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWeaponTimerSlotDuration(
+	TEXT("NWP.WeaponTimerSlotDuration"),
+	0.01f,
+	TEXT("Duration in seconds of each slot of the timer wheel that wakes the managed weapons when their cool down or reload expires.\n")
+	TEXT("Only applied to the weapon managers spawned after changing it.\n"),
+	ECVF_Default);
+
+// Number of slots of the timer wheel. A full turn covers the slot duration multiplied by it
+static const int32 NumTimerWheelSlots = 256;
+
+ANWPWeaponManager::ANWPWeaponManager(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+
+	// Initialize members
+	ManagerTime = 0.0;
+	LastTimerId = 0;
+	UpdatingWeaponIndex = INDEX_NONE;
+	TimerWheel.Initialize(CVarWeaponTimerSlotDuration.GetValueOnGameThread(), NumTimerWheelSlots);
+}
+
+void ANWPWeaponManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Give the simulations back to the weapons, so they do not read a manager that no longer exists
+	for (int32 Index = 0; Index < Weapons.Num(); ++Index)
+	{
+		if (Weapons[Index])
+		{
+			AdvanceSimulation(Index);
+
+			Weapons[Index]->Simulation = Simulations[Index];
+			Weapons[Index]->WeaponManagerIndex = INDEX_NONE;
+			Weapons[Index]->OwnerWeaponManager = nullptr;
+		}
+	}
+
+	Weapons.Empty();
+	Simulations.Empty();
+	SimulationTimes.Empty();
+	TimerIds.Empty();
+	TimerExpiryTimes.Empty();
+	ActiveFlags.Empty();
+	ActiveIndices.Empty();
+	UpdatedWeapons.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANWPWeaponManager::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NWPWeaponManagerTick);
+
+	Super::Tick(DeltaSeconds);
+
+	ManagerTime += DeltaSeconds;
+
+	// Wake the weapons whose timer has expired. Only the slots of the elapsed time are visited
+	ExpiredIndices.Reset();
+
+	TimerWheel.Advance(ManagerTime, [this](int32 _Index, uint32 _Id)
+	{
+		return TimerIds.IsValidIndex(_Index) && TimerIds[_Index] == _Id;
+	}, ExpiredIndices);
+
+	for (int32 ExpiredIndex : ExpiredIndices)
+	{
+		TimerIds[ExpiredIndex] = 0;
+		WakeWeapon(ExpiredIndex);
+	}
+
+	INC_DWORD_STAT_BY(STAT_NWPWeaponTimersExpired, ExpiredIndices.Num());
+	SET_DWORD_STAT(STAT_NWPActiveWeapons, ActiveIndices.Num());
+
+	// Take the active weapons. The ones that keep having work are added again
+	UpdatedWeapons.Reset(ActiveIndices.Num());
+
+	for (int32 ActiveIndex : ActiveIndices)
+	{
+		UpdatedWeapons.Add(Weapons[ActiveIndex]);
+		ActiveFlags[ActiveIndex] = false;
+	}
+
+	ActiveIndices.Reset();
+
+	const int32 NumUpdatedWeapons = UpdatedWeapons.Num();
+	StateChangedFlags.SetNumUninitialized(NumUpdatedWeapons, false);
+
+	// Advance the simulations to the manager time. The simulations only touch their own data, so they can be advanced in parallel
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NWPWeaponManagerSimulation);
+
+		const bool bForceSingleThread = NumUpdatedWeapons < CVarWeaponManagerParallelThreshold.GetValueOnGameThread();
+
+		ParallelFor(NumUpdatedWeapons, [this](int32 UpdatedIndex)
+		{
+			const ANWPWeapon* Weapon = UpdatedWeapons[UpdatedIndex];
+
+			// Skip if the weapon is not valid
+			if (!Weapon)
+			{
+				StateChangedFlags[UpdatedIndex] = false;
+				return;
+			}
+
+			const int32 Index = Weapon->WeaponManagerIndex;
+
+			AdvanceSimulation(Index);
+
+			StateChangedFlags[UpdatedIndex] = Simulations[Index].GetStateChangeCounter() != Weapon->LastStateChangeCounter;
+		}, bForceSingleThread);
+	}
+
+	// Tell the weapons whose state has changed & update the weapons with pending work. The weapons may leave the manager meanwhile
+	for (int32 UpdatedIndex = 0; UpdatedIndex < NumUpdatedWeapons; ++UpdatedIndex)
+	{
+		ANWPWeapon* Weapon = UpdatedWeapons[UpdatedIndex];
+
+		if (!Weapon || Weapon->IsPendingKill() || Weapon->OwnerWeaponManager != this)
+		{
+			continue;
+		}
+
+		UpdatingWeaponIndex = Weapon->WeaponManagerIndex;
+
+		if (StateChangedFlags[UpdatedIndex])
+		{
+			Weapon->SyncWeaponState();
+			INC_DWORD_STAT(STAT_NWPWeaponStateCallbacks);
+		}
+
+		if (Weapon->NeedsWeaponUpdate())
+		{
+			Weapon->UpdateWeapon(DeltaSeconds);
+			INC_DWORD_STAT(STAT_NWPWeaponsUpdated);
+		}
+
+		UpdatingWeaponIndex = INDEX_NONE;
+
+		// Skip if the weapon has left the manager during the update
+		if (Weapon->OwnerWeaponManager != this)
+		{
+			continue;
+		}
+
+		// Wait for the timer unless there is more work to do
+		ScheduleWeaponTimer(Weapon->WeaponManagerIndex);
+
+		if (Weapon->NeedsWeaponUpdate())
+		{
+			WakeWeapon(Weapon->WeaponManagerIndex);
+		}
+	}
+
+	UpdatedWeapons.Reset();
+
+	SET_DWORD_STAT(STAT_NWPManagedWeapons, Weapons.Num());
+	SET_DWORD_STAT(STAT_NWPWeaponTimers, TimerWheel.GetNumTimers());
+}
+
+ANWPWeaponManager* ANWPWeaponManager::GetWeaponManager(UWorld* World, bool _bSpawnIfMissing)
+{
+	return UNWPUtils::GetWorldManager<ANWPWeaponManager>(World, _bSpawnIfMissing);
+}
+
+FNWPWeaponSimulation& ANWPWeaponManager::GetMutableSimulation(int32 _Index)
+{
+	AdvanceSimulation(_Index);
+
+	// The weapon being updated is checked after its update
+	if (_Index != UpdatingWeaponIndex)
+	{
+		WakeWeapon(_Index);
+	}
+
+	return Simulations[_Index];
+}
+
+void ANWPWeaponManager::RegisterWeapon(ANWPWeapon* _Weapon)
+{
+	// Early return if invalid or already registered
+	if (!_Weapon || _Weapon->OwnerWeaponManager)
+	{
+		return;
+	}
+
+	// Move the simulation of the weapon to the manager
+	const int32 Index = Weapons.Add(_Weapon);
+	Simulations.Add(_Weapon->Simulation);
+	SimulationTimes.Add(ManagerTime);
+	TimerIds.Add(0);
+	TimerExpiryTimes.Add(0.0);
+	ActiveFlags.Add(false);
+
+	_Weapon->WeaponManagerIndex = Index;
+	_Weapon->OwnerWeaponManager = this;
+
+	WakeWeapon(Index);
+}
+
+void ANWPWeaponManager::UnregisterWeapon(ANWPWeapon* _Weapon)
+{
+	// Early return if the weapon is not registered here
+	if (!_Weapon || _Weapon->OwnerWeaponManager != this || !Weapons.IsValidIndex(_Weapon->WeaponManagerIndex))
+	{
+		return;
+	}
+
+	const int32 Index = _Weapon->WeaponManagerIndex;
+	const int32 LastIndex = Weapons.Num() - 1;
+	check(Weapons[Index] == _Weapon);
+
+	// Give the simulation back to the weapon
+	AdvanceSimulation(Index);
+
+	_Weapon->Simulation = Simulations[Index];
+	_Weapon->WeaponManagerIndex = INDEX_NONE;
+	_Weapon->OwnerWeaponManager = nullptr;
+
+	// Leave the active weapons. The last weapon is moved to the removed slot
+	if (ActiveFlags[Index])
+	{
+		ActiveIndices.RemoveSingleSwap(Index, false);
+	}
+
+	if (Index != LastIndex && ActiveFlags[LastIndex])
+	{
+		ActiveIndices[ActiveIndices.Find(LastIndex)] = Index;
+	}
+
+	Weapons.RemoveAtSwap(Index, 1, false);
+	Simulations.RemoveAtSwap(Index, 1, false);
+	SimulationTimes.RemoveAtSwap(Index, 1, false);
+	TimerIds.RemoveAtSwap(Index, 1, false);
+	TimerExpiryTimes.RemoveAtSwap(Index, 1, false);
+	ActiveFlags.RemoveAtSwap(Index, 1, false);
+
+	// The timer of the moved weapon points to its old index, so it is scheduled again
+	if (Weapons.IsValidIndex(Index))
+	{
+		Weapons[Index]->WeaponManagerIndex = Index;
+
+		if (TimerIds[Index] != 0)
+		{
+			TimerIds[Index] = 0;
+			ScheduleWeaponTimer(Index);
+		}
+	}
+}
+
+void ANWPWeaponManager::WakeWeapon(int32 _Index)
+{
+	// Check if it is already active
+	if (ActiveFlags[_Index])
+	{
+		return;
+	}
+
+	ActiveFlags[_Index] = true;
+	ActiveIndices.Add(_Index);
+}
+
+void ANWPWeaponManager::AdvanceSimulation(int32 _Index)
+{
+	const double ElapsedTime = ManagerTime - SimulationTimes[_Index];
+
+	// Check if the simulation is behind
+	if (ElapsedTime <= 0.0)
+	{
+		return;
+	}
+
+	Simulations[_Index].UpdateCoolDown((float)ElapsedTime);
+	SimulationTimes[_Index] = ManagerTime;
+}
+
+void ANWPWeaponManager::ScheduleWeaponTimer(int32 _Index)
+{
+	const FNWPWeaponSimulation& Simulation = Simulations[_Index];
+
+	// Cancel the timer if there is nothing to wait for. A reload always waits, even without reload time
+	if (!Simulation.IsCoolDownActive() && Simulation.GetState() != ENWPWeaponSimulationState::Reloading)
+	{
+		TimerIds[_Index] = 0;
+		return;
+	}
+
+	const double ExpiryTime = SimulationTimes[_Index] + FMath::Max(Simulation.GetCoolDown(), 0.0f);
+
+	// Keep the timer if it already expires at the same time
+	if (TimerIds[_Index] != 0 && FMath::IsNearlyEqual(TimerExpiryTimes[_Index], ExpiryTime, (double)KINDA_SMALL_NUMBER))
+	{
+		return;
+	}
+
+	// Skip the id 0, that means no timer
+	LastTimerId = LastTimerId + 1 != 0 ? LastTimerId + 1 : 1;
+
+	TimerIds[_Index] = LastTimerId;
+	TimerExpiryTimes[_Index] = ExpiryTime;
+	TimerWheel.Schedule(_Index, LastTimerId, ExpiryTime);
+
+	INC_DWORD_STAT(STAT_NWPWeaponTimersScheduled);
+}
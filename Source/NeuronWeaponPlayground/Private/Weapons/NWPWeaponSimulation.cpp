@@ -0,0 +1,218 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "NWPWeaponSimulation.h"
+
+FNWPWeaponSimulationParams::FNWPWeaponSimulationParams()
+{
+	for (float& CadenceCoolDown : CoolDowns)
+	{
+		CadenceCoolDown = 0.0f;
+	}
+
+	MagazineReloadTime = 0.0f;
+	InitialAmmo = 0;
+	MaximumAmmo = 0;
+	AmmoPerMagazine = 0;
+	DefaultCadenceType = ENWPWeaponSimulationCadenceType::COUNT;
+	bIsAutomatic = false;
+	bIsSemiAutomatic = false;
+	bAccumulateSubFrameShots = false;
+}
+
+FNWPWeaponSimulation::FNWPWeaponSimulation()
+{
+	State = ENWPWeaponSimulationState::Invalid;
+	CadenceType = ENWPWeaponSimulationCadenceType::COUNT;
+	CoolDown = 0.0f;
+	Ammo = 0;
+	AmmoInMagazine = 0;
+	StateBeforeReload = ENWPWeaponSimulationState::Invalid;
+	bForceReloadToNone = false;
+	StateChangeCounter = 0;
+}
+
+void FNWPWeaponSimulation::Configure(const FNWPWeaponSimulationParams& _Params)
+{
+	Params = _Params;
+
+	// Restore the cadence & the ammo
+	CadenceType = Params.DefaultCadenceType;
+	Ammo = FMath::Min(Params.InitialAmmo, Params.MaximumAmmo);
+	AmmoInMagazine = Params.AmmoPerMagazine;
+}
+
+void FNWPWeaponSimulation::SetState(ENWPWeaponSimulationState _State)
+{
+	// Check if the state to set is different
+	if (State == _State)
+	{
+		return;
+	}
+
+	State = _State;
+	++StateChangeCounter;
+}
+
+bool FNWPWeaponSimulation::SwapCadenceType()
+{
+	// Early return if weapon busy or cooling down
+	if (State != ENWPWeaponSimulationState::None || IsCoolDownActive())
+	{
+		return false;
+	}
+
+	// Swap between automatic / semi automatic
+	if (CadenceType == ENWPWeaponSimulationCadenceType::Automatic && Params.bIsSemiAutomatic)
+	{
+		CadenceType = ENWPWeaponSimulationCadenceType::SemiAutomatic;
+		return true;
+	}
+	else if (CadenceType == ENWPWeaponSimulationCadenceType::SemiAutomatic && Params.bIsAutomatic)
+	{
+		CadenceType = ENWPWeaponSimulationCadenceType::Automatic;
+		return true;
+	}
+
+	return false;
+}
+
+bool FNWPWeaponSimulation::ConsumeShot()
+{
+	// Try to consume the ammo. Otherwise, try to reload
+	if (!TryToConsumeAmmo())
+	{
+		CheckMagazineHasToReload();
+		return false;
+	}
+
+	ResetCoolDown();
+
+	return true;
+}
+
+int32 FNWPWeaponSimulation::ConsumeDueShots(float _DeltaSeconds, int32 _MaxShots, float* _OutTimeOffsets)
+{
+	const float CadenceCoolDown = GetCadenceCoolDown();
+	int32 NumShots = 0;
+
+	// The negative cool down is the time elapsed since the next shot was due
+	while (State == ENWPWeaponSimulationState::Shooting && !IsCoolDownActive() && NumShots < _MaxShots)
+	{
+		// Try to consume the ammo. Otherwise, try to reload
+		if (!TryToConsumeAmmo())
+		{
+			CheckMagazineHasToReload();
+			break;
+		}
+
+		_OutTimeOffsets[NumShots++] = FMath::Clamp(-CoolDown, 0.0f, _DeltaSeconds);
+
+		// Schedule the next shot keeping the exceeded time
+		SetCoolDown(CadenceCoolDown, true);
+	}
+
+	// Drop the remaining debt if the shots limit has been reached
+	if (State == ENWPWeaponSimulationState::Shooting && !IsCoolDownActive())
+	{
+		SetCoolDown(0.0f);
+	}
+
+	return NumShots;
+}
+
+void FNWPWeaponSimulation::StopShooting()
+{
+	// Set to force the none state if reloading
+	if (State == ENWPWeaponSimulationState::Reloading)
+	{
+		bForceReloadToNone = true;
+		return;
+	}
+
+	// Check if the state is shooting
+	if (State != ENWPWeaponSimulationState::Shooting)
+	{
+		return;
+	}
+
+	SetState(ENWPWeaponSimulationState::None);
+}
+
+void FNWPWeaponSimulation::ResetCoolDown()
+{
+	const float CadenceCoolDown = GetCadenceCoolDown();
+
+	// Discount the time elapsed since the shot was due. It is limited to one cool down, so a late frame does not owe several shots
+	SetCoolDown(CadenceCoolDown + FMath::Max(FMath::Min(CoolDown, 0.0f), -CadenceCoolDown));
+}
+
+void FNWPWeaponSimulation::SetCoolDown(float _Value, bool _bAdditive /*= false*/)
+{
+	CoolDown = !_bAdditive ? _Value : (CoolDown + _Value);
+}
+
+void FNWPWeaponSimulation::UpdateCoolDown(float _DeltaSeconds)
+{
+	CoolDown -= _DeltaSeconds;
+
+	// Finish the reload if the cool down has expired
+	if (CoolDown <= 0.0f && State == ENWPWeaponSimulationState::Reloading)
+	{
+		// Perform the reload
+		ReloadMagazine();
+
+		// Restore the state before reloading unless the none state is forced
+		SetState(!bForceReloadToNone ? StateBeforeReload : ENWPWeaponSimulationState::None);
+	}
+
+	// Keep the exceeded time while shooting, so the next shot is scheduled from the moment the cool down or the reload expired.
+	// An idle weapon does not owe any shot
+	if (State != ENWPWeaponSimulationState::Shooting)
+	{
+		CoolDown = FMath::Max(CoolDown, 0.0f);
+	}
+}
+
+bool FNWPWeaponSimulation::TryToConsumeAmmo()
+{
+	// Returns if there is enough ammo in the magazine
+	if (AmmoInMagazine > 0)
+	{
+		--AmmoInMagazine;
+		return true;
+	}
+
+	return false;
+}
+
+bool FNWPWeaponSimulation::CheckMagazineHasToReload()
+{
+	// Return if no ammo
+	if (Ammo == 0)
+	{
+		return false;
+	}
+
+	// Set the cool down to the reload time
+	SetCoolDown(Params.MagazineReloadTime);
+
+	// Cache current state
+	StateBeforeReload = State;
+
+	// Reset the force to reload flag
+	bForceReloadToNone = false;
+
+	SetState(ENWPWeaponSimulationState::Reloading);
+
+	return true;
+}
+
+void FNWPWeaponSimulation::ReloadMagazine()
+{
+	// Calculate the ammo to reload
+	const int32 AmmoDelta = Params.AmmoPerMagazine - AmmoInMagazine;
+	const int32 AmmoToReload = FMath::Min(Ammo, AmmoDelta);
+
+	Ammo -= AmmoToReload;
+	AmmoInMagazine += AmmoToReload;
+}
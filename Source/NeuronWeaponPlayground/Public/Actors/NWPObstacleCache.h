@@ -0,0 +1,85 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "NWPObstacleCache.generated.h"
+
+/**
+ * Data of an obstacle used by the smart projectiles to avoid it
+ */
+struct NEURONWEAPONPLAYGROUND_API FNWPObstacleCacheEntry
+{
+
+// Constructors
+public:
+
+	FNWPObstacleCacheEntry();
+
+// Member variables
+public:
+
+	// Transform of the obstacle when the data was computed
+	FTransform Transform;
+
+	// Bounding box of the components of the obstacle
+	FBox Bounds;
+
+	// Half of the diagonal of the bounding box in XY
+	float HalfXYDiagonal;
+
+	// Half of the height of the bounding box
+	float HalfHeight;
+};
+
+/**
+ * Per world cache of the obstacles found by the smart projectiles. Computing the bounds of an obstacle walks all its components, 
+ * so they are computed once per obstacle & shared by every projectile that finds it. The data is computed again when the transform
+ * of the obstacle changes, and removed when the obstacle ends play
+ */
+UCLASS(NotBlueprintable, Transient)
+class NEURONWEAPONPLAYGROUND_API ANWPObstacleCache : public AInfo
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPObstacleCache(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the obstacle cache of the world. Spawns it if it does not exist and it is allowed
+	static ANWPObstacleCache* GetObstacleCache(UWorld* World, bool _bSpawnIfMissing = true);
+
+	// Returns the number of cached obstacles
+	FORCEINLINE int32 GetNumObstacles() const { return Obstacles.Num(); }
+
+	// Returns the data of an obstacle. Computes it if the obstacle is not cached or it has moved since it was cached
+	const FNWPObstacleCacheEntry& GetObstacle(class AActor* _Obstacle);
+
+	// Computes the data of an obstacle without caching it
+	static void ComputeObstacle(const class AActor* _Obstacle, FNWPObstacleCacheEntry& _OutEntry);
+
+protected:
+
+	// Callback executed when a cached obstacle ends play
+	UFUNCTION()
+	void OnObstacleEndPlay(class AActor* _Obstacle, EEndPlayReason::Type EndPlayReason);
+
+// Member variables
+protected:
+
+	// Data of the cached obstacles
+	TMap<TWeakObjectPtr<class AActor>, FNWPObstacleCacheEntry> Obstacles;
+};
@@ -1,16 +1,48 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Engine/StaticMeshActor.h"
-#include "NWPTarget.generated.h"
-
-/**
- * Actor that represents the target that the smart weapon projectiles can follow
- */
-UCLASS()
-class NEURONWEAPONPLAYGROUND_API ANWPTarget : public AStaticMeshActor
-{
-	GENERATED_BODY()
-};
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StaticMeshActor.h"
+#include "NWPTarget.generated.h"
+
+/**
+ * Actor that represents the target that the smart weapon projectiles can follow
+ */
+UCLASS()
+class NEURONWEAPONPLAYGROUND_API ANWPTarget : public AStaticMeshActor
+{
+	GENERATED_BODY()
+
+// Friend class
+friend class ANWPTargetRegistry;
+
+// Constructors
+public:
+
+	ANWPTarget(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable native event for when play begins for this actor.
+	virtual void BeginPlay() override;
+
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/// AActor interface end
+
+	// Returns the index of the target in the target registry. INDEX_NONE if not registered
+	FORCEINLINE int32 GetRegistryIndex() const { return RegistryIndex; }
+
+// Member variables
+protected:
+
+	// Registry the target has joined
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPTargetRegistry* OwnerRegistry;
+
+	// Index of the target in the dense arrays of the registry
+	int32 RegistryIndex;
+};
@@ -0,0 +1,121 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "NWPTargetRegistry.generated.h"
+
+/**
+ * Per world registry of the targets. The targets join it in BeginPlay and leave it in EndPlay, so the weapons & the HUD do not need 
+ * to iterate the objects. The positions & bounds are stored in dense arrays that share the index of the targets.
+ * The targets are also stored in a uniform grid, updated when they move, so the weapons can query the targets inside a volume
+ */
+UCLASS(NotBlueprintable, Transient)
+class NEURONWEAPONPLAYGROUND_API ANWPTargetRegistry : public AInfo
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPTargetRegistry(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Function called every frame on this Actor. 
+	virtual void Tick(float DeltaSeconds) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the target registry of the world. Spawns it if it does not exist and it is allowed
+	static ANWPTargetRegistry* GetTargetRegistry(UWorld* World, bool _bSpawnIfMissing = true);
+
+	// Returns the number of registered targets
+	FORCEINLINE int32 GetNumTargets() const { return Targets.Num(); }
+
+	// Returns the registered targets
+	FORCEINLINE const TArray<class ANWPTarget*>& GetTargets() const { return Targets; }
+
+	// Returns the positions of the registered targets. Shares the index with the targets
+	FORCEINLINE const TArray<FVector>& GetTargetPositions() const { return TargetPositions; }
+
+	// Returns the bounds of the registered targets. Shares the index with the targets
+	FORCEINLINE const TArray<FBoxSphereBounds>& GetTargetBounds() const { return TargetBounds; }
+
+	// Returns the counter that is increased every time a target joins, leaves or moves
+	FORCEINLINE uint32 GetChangeCounter() const { return ChangeCounter; }
+
+	// Returns the position of a registered target. Returns if the target is registered
+	bool GetTargetPosition(const class ANWPTarget* _Target, FVector& _OutPosition) const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Query
+
+	// Adds the index of every target whose position is inside the frustum. The bounds of the frustum limit the cells that are visited
+	void QueryTargets(const struct FConvexVolume& _Frustum, const FBox& _FrustumBounds, TArray<int32>& _OutTargetIndices) const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Registration
+
+	// Adds a target to the registry
+	void RegisterTarget(class ANWPTarget* _Target);
+
+	// Removes a target from the registry
+	void UnregisterTarget(class ANWPTarget* _Target);
+
+protected:
+
+	// Reads the position & bounds of the target stored at the index. Returns if they have changed
+	bool RefreshTarget(int32 _Index, bool _bForce = false);
+
+	///////////////////////////////////////////////////////////////////////////
+	// Grid
+
+	// Returns the cell that contains a position
+	FIntVector GetGridCell(const FVector& _Position) const;
+
+	// Adds the target index to a cell
+	void AddToGridCell(const FIntVector& _Cell, int32 _Index);
+
+	// Removes the target index from a cell
+	void RemoveFromGridCell(const FIntVector& _Cell, int32 _Index);
+
+	// Moves the target to the cell of its current position
+	void UpdateGridCell(int32 _Index);
+
+	// Rebuilds the grid using a new cell size
+	void RebuildGrid(float _CellSize);
+
+// Member variables
+protected:
+
+	// Registered targets
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<class ANWPTarget*> Targets;
+
+	// Position of each target
+	TArray<FVector> TargetPositions;
+
+	// Bounds of each target
+	TArray<FBoxSphereBounds> TargetBounds;
+
+	// Counter increased every time a target joins, leaves or moves
+	uint32 ChangeCounter;
+
+	// Grid cell of each target
+	TArray<FIntVector> TargetGridCells;
+
+	// Indices of the targets inside each occupied cell
+	TMap<FIntVector, TArray<int32>> GridCells;
+
+	// Size of the grid cells
+	float GridCellSize;
+};
@@ -1,239 +1,326 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#pragma once
-
-// UE
-#include "Engine/SkeletalMesh.h"
-#include "Particles/ParticleSystem.h"
-
-// NWP
-#include "NeuronWeaponPlayground.h"
-
-#include "CoreMinimal.h"
-#include "UObject/NoExportTypes.h"
-#include "NWPWeaponConfig.generated.h"
-
-// Events / Delegates
-
-// Delegate for action end
-DECLARE_DELEGATE(FNWPOnWaponConfigLoaded)
-
-/**
- * Configuration for a weapon
- */
-UCLASS(Abstract, Blueprintable, BlueprintType)
-class NEURONWEAPONPLAYGROUND_API UNWPWeaponConfig : public UObject
-{
-	GENERATED_BODY()
-
-// Constructors
-public:
-
-	UNWPWeaponConfig(const class FObjectInitializer& ObjectInitializer);
-	
-// Member functions
-public:
-
-	////////////////////////////////////////////////////////////////
-	// Accesors
-
-	// Returns the cached component mesh
-	FORCEINLINE USkeletalMesh* GetWeaponMesh() const { return CachedWeaponMesh; }
-
-	// Returns the cached component mesh
-	FORCEINLINE TSubclassOf<class ANWPProjectile> GetDefaultProjectileClass() const { return DefaultProjectileClass; }
-
-	// Returns if the weapon is automatic
-	FORCEINLINE bool IsAutomatic() const { return CadenceConfig == ENWPWeaponCadenceConfig::Automatic || CadenceConfig == ENWPWeaponCadenceConfig::Both; }
-
-	// Returns if the weapon is semi automatic
-	FORCEINLINE bool IsSemiAutomatic() const { return CadenceConfig == ENWPWeaponCadenceConfig::SemiAutomatic || CadenceConfig == ENWPWeaponCadenceConfig::Both; }
-
-	// Returns the cadence config 
-	ENWPWeaponCadenceConfig GetCadenceConfig() const { return CadenceConfig; };
-
-	// Returns the cadence type 
-	ENWPWeaponCadenceType GetCadenceType() const;
-
-	// Returns the weapon cool down for a cadence type
-	FORCEINLINE float GetCoolDownForCadenceType(ENWPWeaponCadenceType _CadenceType) const { return 1.0f / GetMuzzleVelocityForCadenceType(_CadenceType); }
-
-	// Returns a muzzle velocity for a cadence type
-	FORCEINLINE float GetMuzzleVelocityForCadenceType(ENWPWeaponCadenceType _CadenceType) const { return MuzzleVelocity[(int32)_CadenceType];  }
-
-	// Returns the initial ammo
-	FORCEINLINE int32 GetInitialAmmo() const { return InitialAmmo; };
-
-	// Returns the maximum ammo
-	FORCEINLINE int32 GetMaximumAmmo() const { return MaximumAmmo; };
-
-	// Returns the ammo per magazine
-	FORCEINLINE int32 GetAmmoPerMagazine() const { return AmmoPerMagazine; };
-
-	// Returns the magazine reload time
-	FORCEINLINE int32 GetMagazineReloadTime() const { return MagazineReloadTime; };
-
-	// Returns the shoot distance
-	FORCEINLINE float GetShootDistance() const { return ShootDistance; };
-
-	// Returns if the projectile should be used as ammo
-	FORCEINLINE bool ShouldUseProjectileAsAmmo() const { return bUseProjectileAsAmmo; };
-
-	// Returns if the eyes should be used as shoot origin
-	FORCEINLINE bool ShouldUseEyesAsShootOrigin() const { return bUseEyesAsShootOrigin; };
-
-	// Returns the eyes bone offset location
-	FORCEINLINE FVector GetEyesOffsetLocation() const { return EyesOffsetLocation; };
-
-	// Returns the eyes bone offset rotation
-	FORCEINLINE FRotator GetEyesOffsetRotation() const { return EyesOffsetRotation; };
-
-	// Returns the muzzle bone name
-	FORCEINLINE FString GetMuzzleBoneName() const { return MuzzleSocketName; };
-
-	// Returns the muzzle bone offset location
-	FORCEINLINE FVector GetMuzzleBoneOffsetLocation() const { return MuzzleBoneOffsetLocation; };
-
-	// Returns the muzzle bone offset rotation
-	FORCEINLINE FRotator GetMuzzleBoneOffsetRotation() const { return MuzzleBoneOffsetRotation; };
-
-	// Returns the effect spawned at the muzzle each time we shot
-	FORCEINLINE UParticleSystem* GetMuzzleEffect() const { return CachedMuzzleEffect; };
-
-	// Returns the sound to play each time we shot
-	FORCEINLINE USoundBase* GetShootSound() const { return CachedShootSound; };
-
-	// Returns the montage that has to be played when shooting
-	FORCEINLINE UAnimMontage* GetShootingMontage() const { return CachedShootingMontage; };
-
-	////////////////////////////////////////////////////////////////
-	// Load / Unload
-
-	// Loads the weapon config synchronously
-	// TODO: [NWP-REVIEW] Make this load asynchronously
-	void LoadWeaponConfig(bool bSyncLoad = true, const FNWPOnWaponConfigLoaded& _Callback = nullptr);
-
-	// Releases the asset hard references
-	void ReleaseWeaponConfig();
-
-protected:
-
-	// Finishes the weapon config load
-	void FinishWeaponConfigLoad();
-	
-// Member variables
-protected:
-
-	///////////////////////////////////////////////////////////////////////////
-	// Configuration
-
-	// Specifies the skeletal mesh for this weapon
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	TSoftObjectPtr<class USkeletalMesh> WeaponMesh;
-
-	// Default projectile to spawn
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	TSubclassOf<class ANWPProjectile> DefaultProjectileClass;
-
-	// Specifies the cadence config for this weapon
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	ENWPWeaponCadenceConfig CadenceConfig;
-
-	// Specifies the muzzle velocity for a cadence type
-	UPROPERTY(EditAnywhere, Category = "Weapon Configuration")
-	float MuzzleVelocity[(int32)ENWPWeaponCadenceType::COUNT];
-
-	// Specifies the ammo when spawned
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	int32 InitialAmmo;
-
-	// Specifies the maximum ammount of ammo
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	int32 MaximumAmmo;
-
-	// Specifies the ammount of ammo per magazine
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	int32 AmmoPerMagazine;
-
-	// Specifies the magazine reload time
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	float MagazineReloadTime;
-
-	// Specifies the shoot distance
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	float ShootDistance;
-
-	// Specifies that the ammo that is going to be used is the projectile
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	bool bUseProjectileAsAmmo;
-
-	// Specifies that the shoot origin is the character eyes. If the shoot origin is not the eyes, the muzzle will be used.
-	// Be careful when shooting a projectile from the muzzle
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	bool bUseEyesAsShootOrigin;
-
-	// Specifies the muzzle bone name. If the muzzle socket does not exist, the shoot will be done from the eyes
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	FString MuzzleSocketName;
-
-	// Specifies an offset location that is going to be added to the eyes
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	FVector EyesOffsetLocation;
-
-	// Specifies an offset rotation that is going to be added to the eyes
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	FRotator EyesOffsetRotation;
-
-	// Specifies an offset location that is going to be added to the muzzle
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	FVector MuzzleBoneOffsetLocation;
-
-	// Specifies an offset rotation that is going to be added to the muzzle
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	FRotator MuzzleBoneOffsetRotation;
-
-	// Effect spawned at the muzzle each time we shot
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	TSoftObjectPtr<UParticleSystem> MuzzleEffect;
-
-	// Sound to play each time we shot
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
-	TSoftObjectPtr<USoundBase> ShootSound;
-
-	// Specifies the montage that has to be played when shooting
-	UPROPERTY(EditAnywhere, Category = "Weapon Configuration")
-	TSoftObjectPtr<UAnimMontage> ShootMontage;
-
-	////////////////////////////////////////////////////////////////
-	// Load / Unload
-
-	// Delegate for the load finish
-	FNWPOnWaponConfigLoaded CurrentLoadFinishedDelegate;
-
-	// Indicates that the weapon config is being loaded
-	bool bIsLoading;
-
-	///////////////////////////////////////////////////////////////////////////
-	// Cache
-
-	// Cached skeletal mesh
-	UPROPERTY(Transient, SkipSerialization)
-	class USkeletalMesh* CachedWeaponMesh;
-
-	// Cached muzzle effect
-	UPROPERTY(Transient, SkipSerialization)
-	class UParticleSystem* CachedMuzzleEffect;
-
-	// Cached shoot sound
-	UPROPERTY(Transient, SkipSerialization)
-	class USoundBase* CachedShootSound;
-
-	// Cached shooting montage
-	UPROPERTY(Transient, SkipSerialization)
-	class UAnimMontage* CachedShootingMontage;
-
-	// Cached reloading montage
-	UPROPERTY(Transient, SkipSerialization)
-	class UAnimMontage* CachedReloadingMontage;
-
-};
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/StaticMesh.h"
+#include "Particles/ParticleSystem.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "NWPWeaponConfig.generated.h"
+
+// Events / Delegates
+
+// Delegate for action end
+DECLARE_DELEGATE(FNWPOnWaponConfigLoaded)
+
+/**
+ * Configuration for a weapon. The instances are shared by every weapon of the same config class through ANWPWeaponConfigCache,
+ * so they are read only for the weapons
+ */
+UCLASS(Abstract, Blueprintable, BlueprintType)
+class NEURONWEAPONPLAYGROUND_API UNWPWeaponConfig : public UObject
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	UNWPWeaponConfig(const class FObjectInitializer& ObjectInitializer);
+	
+// Member functions
+public:
+
+	////////////////////////////////////////////////////////////////
+	// Accesors
+
+	// Returns the cached component mesh
+	FORCEINLINE USkeletalMesh* GetWeaponMesh() const { return CachedWeaponMesh; }
+
+	// Returns the cached component mesh
+	FORCEINLINE TSubclassOf<class ANWPProjectile> GetDefaultProjectileClass() const { return DefaultProjectileClass; }
+
+	// Returns if the weapon is automatic
+	FORCEINLINE bool IsAutomatic() const { return CadenceConfig == ENWPWeaponCadenceConfig::Automatic || CadenceConfig == ENWPWeaponCadenceConfig::Both; }
+
+	// Returns if the weapon is semi automatic
+	FORCEINLINE bool IsSemiAutomatic() const { return CadenceConfig == ENWPWeaponCadenceConfig::SemiAutomatic || CadenceConfig == ENWPWeaponCadenceConfig::Both; }
+
+	// Returns the cadence config 
+	ENWPWeaponCadenceConfig GetCadenceConfig() const { return CadenceConfig; };
+
+	// Returns the cadence type 
+	ENWPWeaponCadenceType GetCadenceType() const;
+
+	// Returns the weapon cool down for a cadence type
+	FORCEINLINE float GetCoolDownForCadenceType(ENWPWeaponCadenceType _CadenceType) const { return 1.0f / GetMuzzleVelocityForCadenceType(_CadenceType); }
+
+	// Returns a muzzle velocity for a cadence type
+	FORCEINLINE float GetMuzzleVelocityForCadenceType(ENWPWeaponCadenceType _CadenceType) const { return MuzzleVelocity[(int32)_CadenceType];  }
+
+	// Returns if the shots that are due between frames should be accumulated and fired
+	FORCEINLINE bool ShouldAccumulateSubFrameShots() const { return bAccumulateSubFrameShots; };
+
+	// Returns the initial ammo
+	FORCEINLINE int32 GetInitialAmmo() const { return InitialAmmo; };
+
+	// Returns the maximum ammo
+	FORCEINLINE int32 GetMaximumAmmo() const { return MaximumAmmo; };
+
+	// Returns the ammo per magazine
+	FORCEINLINE int32 GetAmmoPerMagazine() const { return AmmoPerMagazine; };
+
+	// Returns the magazine reload time
+	FORCEINLINE int32 GetMagazineReloadTime() const { return MagazineReloadTime; };
+
+	// Returns the number of projectiles that are spawned in the projectile pool when the weapon loads
+	FORCEINLINE int32 GetProjectilePoolPrewarmSize() const { return ProjectilePoolPrewarmSize; };
+
+	// Returns the shoot distance
+	FORCEINLINE float GetShootDistance() const { return ShootDistance; };
+
+	// Returns if the projectile should be used as ammo
+	FORCEINLINE bool ShouldUseProjectileAsAmmo() const { return bUseProjectileAsAmmo; };
+
+	// Returns if the projectiles should be simulated as data instead of being spawned as actors
+	FORCEINLINE bool ShouldUseSimulatedProjectiles() const { return bUseSimulatedProjectiles; };
+
+	// Returns the mesh used to draw the simulated projectiles
+	FORCEINLINE UStaticMesh* GetSimulatedProjectileMesh() const { return CachedSimulatedProjectileMesh; };
+
+	// Returns if the hitscan traces should be asynchronous
+	FORCEINLINE bool ShouldUseAsyncHitscan() const { return bUseAsyncHitscan; };
+
+	// Returns the quality of the hitscan traces
+	FORCEINLINE ENWPTraceQuality GetHitscanTraceQuality() const { return HitscanTraceQuality; };
+
+	// Returns if the eyes should be used as shoot origin
+	FORCEINLINE bool ShouldUseEyesAsShootOrigin() const { return bUseEyesAsShootOrigin; };
+
+	// Returns the eyes bone offset location
+	FORCEINLINE FVector GetEyesOffsetLocation() const { return EyesOffsetLocation; };
+
+	// Returns the eyes bone offset rotation
+	FORCEINLINE FRotator GetEyesOffsetRotation() const { return EyesOffsetRotation; };
+
+	// Returns the muzzle bone name
+	FORCEINLINE FString GetMuzzleBoneName() const { return MuzzleSocketName; };
+
+	// Returns the muzzle bone offset location
+	FORCEINLINE FVector GetMuzzleBoneOffsetLocation() const { return MuzzleBoneOffsetLocation; };
+
+	// Returns the muzzle bone offset rotation
+	FORCEINLINE FRotator GetMuzzleBoneOffsetRotation() const { return MuzzleBoneOffsetRotation; };
+
+	// Returns the effect spawned at the muzzle each time we shot
+	FORCEINLINE UParticleSystem* GetMuzzleEffect() const { return CachedMuzzleEffect; };
+
+	// Returns the sound to play each time we shot
+	FORCEINLINE USoundBase* GetShootSound() const { return CachedShootSound; };
+
+	// Returns the montage that has to be played when shooting
+	FORCEINLINE UAnimMontage* GetShootingMontage() const { return CachedShootingMontage; };
+
+	////////////////////////////////////////////////////////////////
+	// Load / Unload
+
+	// Loads the assets of the weapon config. Every asset is requested through a single streamable handle.
+	// The callback is executed when every asset is resident. If the config is already loaded, the callback is executed immediately
+	void LoadWeaponConfig(bool bSyncLoad = true, const FNWPOnWaponConfigLoaded& _Callback = nullptr, 
+		TAsyncLoadPriority _Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+	// Releases the asset hard references & the streamable handle. Cancels the load in progress
+	void ReleaseWeaponConfig();
+
+	// Removes the callbacks of the load in progress that are bound to the listener
+	void RemoveLoadFinishedCallbacks(const UObject* _Listener);
+
+	// Returns if the weapon config is being loaded
+	FORCEINLINE bool IsLoading() const { return bIsLoading; }
+
+	// Returns if every asset of the weapon config is resident
+	FORCEINLINE bool IsLoaded() const { return bIsLoaded; }
+
+	// Returns the time spent by the last load in seconds
+	FORCEINLINE float GetLastLoadLatency() const { return LastLoadLatency; }
+
+	// Writes the latency of the last load of each weapon config class to the log
+	static void LogLoadLatencies();
+
+protected:
+
+	// Adds the soft references of the assets that have to be loaded
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& _OutAssetsToLoad) const;
+
+	// Callback executed when the asynchronous load has finished
+	void OnAsyncLoadCompleted();
+
+	// Finishes the weapon config load
+	void FinishWeaponConfigLoad();
+	
+// Member variables
+protected:
+
+	///////////////////////////////////////////////////////////////////////////
+	// Configuration
+
+	// Specifies the skeletal mesh for this weapon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	TSoftObjectPtr<class USkeletalMesh> WeaponMesh;
+
+	// Default projectile to spawn
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	TSubclassOf<class ANWPProjectile> DefaultProjectileClass;
+
+	// Specifies the cadence config for this weapon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	ENWPWeaponCadenceConfig CadenceConfig;
+
+	// Specifies the muzzle velocity for a cadence type
+	UPROPERTY(EditAnywhere, Category = "Weapon Configuration")
+	float MuzzleVelocity[(int32)ENWPWeaponCadenceType::COUNT];
+
+	// Specifies that every shot that is due during a frame is fired, so the automatic fire rate does not depend on the frame rate.
+	// Otherwise, only one shot can be fired per frame. Enable it only on the weapons that fire faster than the frame rate,
+	// as the managed weapons that accumulate the shots are updated every frame while shooting
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	bool bAccumulateSubFrameShots;
+
+	// Specifies the ammo when spawned
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	int32 InitialAmmo;
+
+	// Specifies the maximum ammount of ammo
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	int32 MaximumAmmo;
+
+	// Specifies the ammount of ammo per magazine
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	int32 AmmoPerMagazine;
+
+	// Specifies the magazine reload time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	float MagazineReloadTime;
+
+	// Specifies the number of projectiles that are spawned in the projectile pool when the weapon loads
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration", meta = (ClampMin = "0"))
+	int32 ProjectilePoolPrewarmSize;
+
+	// Specifies the shoot distance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	float ShootDistance;
+
+	// Specifies that the ammo that is going to be used is the projectile
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	bool bUseProjectileAsAmmo;
+
+	// Specifies that the projectiles are simulated as data by the projectile simulation instead of being spawned as actors.
+	// The default projectile class is only used to read its configuration. Only used if the projectile is used as ammo
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	bool bUseSimulatedProjectiles;
+
+	// Specifies the mesh used to draw the simulated projectiles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	TSoftObjectPtr<class UStaticMesh> SimulatedProjectileMesh;
+
+	// Specifies that the hitscan traces are queued and submitted asynchronously. The hits are resolved the next frame.
+	// Only used if the projectile is not used as ammo
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	bool bUseAsyncHitscan;
+
+	// Specifies the collision traced by the hitscan shots. Only used if the projectile is not used as ammo
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	ENWPTraceQuality HitscanTraceQuality;
+
+	// Specifies that the shoot origin is the character eyes. If the shoot origin is not the eyes, the muzzle will be used.
+	// Be careful when shooting a projectile from the muzzle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	bool bUseEyesAsShootOrigin;
+
+	// Specifies the muzzle bone name. If the muzzle socket does not exist, the shoot will be done from the eyes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	FString MuzzleSocketName;
+
+	// Specifies an offset location that is going to be added to the eyes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	FVector EyesOffsetLocation;
+
+	// Specifies an offset rotation that is going to be added to the eyes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	FRotator EyesOffsetRotation;
+
+	// Specifies an offset location that is going to be added to the muzzle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	FVector MuzzleBoneOffsetLocation;
+
+	// Specifies an offset rotation that is going to be added to the muzzle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	FRotator MuzzleBoneOffsetRotation;
+
+	// Effect spawned at the muzzle each time we shot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	TSoftObjectPtr<UParticleSystem> MuzzleEffect;
+
+	// Sound to play each time we shot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Configuration")
+	TSoftObjectPtr<USoundBase> ShootSound;
+
+	// Specifies the montage that has to be played when shooting
+	UPROPERTY(EditAnywhere, Category = "Weapon Configuration")
+	TSoftObjectPtr<UAnimMontage> ShootMontage;
+
+	////////////////////////////////////////////////////////////////
+	// Load / Unload
+
+	// Delegates executed when the load finishes. Every listener that requests the load while it is in progress is added
+	TArray<FNWPOnWaponConfigLoaded> PendingLoadFinishedDelegates;
+
+	// Handle that keeps the loaded assets resident
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	// Indicates that the weapon config is being loaded
+	bool bIsLoading;
+
+	// Indicates that every asset of the weapon config is resident
+	bool bIsLoaded;
+
+	// Time in which the current load started
+	double LoadStartTime;
+
+	// Time spent by the last load in seconds
+	float LastLoadLatency;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Cache
+
+	// Cached skeletal mesh
+	UPROPERTY(Transient, SkipSerialization)
+	class USkeletalMesh* CachedWeaponMesh;
+
+	// Cached muzzle effect
+	UPROPERTY(Transient, SkipSerialization)
+	class UParticleSystem* CachedMuzzleEffect;
+
+	// Cached shoot sound
+	UPROPERTY(Transient, SkipSerialization)
+	class USoundBase* CachedShootSound;
+
+	// Cached shooting montage
+	UPROPERTY(Transient, SkipSerialization)
+	class UAnimMontage* CachedShootingMontage;
+
+	// Cached reloading montage
+	UPROPERTY(Transient, SkipSerialization)
+	class UAnimMontage* CachedReloadingMontage;
+
+	// Cached simulated projectile mesh
+	UPROPERTY(Transient, SkipSerialization)
+	class UStaticMesh* CachedSimulatedProjectileMesh;
+
+};
@@ -0,0 +1,103 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "Engine/StreamableManager.h"
+
+// NWP
+#include "NWPWeaponConfig.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "NWPWeaponConfigCache.generated.h"
+
+// Struct that contains a weapon config shared by every weapon that uses its class
+USTRUCT()
+struct FNWPSharedWeaponConfig
+{
+	GENERATED_USTRUCT_BODY()
+
+// Constructors
+public:
+
+	FNWPSharedWeaponConfig()
+	{
+		WeaponConfig = nullptr;
+		ReferenceCount = 0;
+	}
+
+// Member variables
+public:
+
+	// The shared weapon config
+	UPROPERTY(Transient, SkipSerialization)
+	UNWPWeaponConfig* WeaponConfig;
+
+	// Number of weapons that are using the weapon config
+	UPROPERTY(Transient, SkipSerialization)
+	int32 ReferenceCount;
+};
+
+/**
+ * Per world cache of the weapon configs. Hands out a single read only instance per weapon config class, so the weapons that share 
+ * a class also share the loaded assets & the load bookkeeping. The instances are reference counted and their assets are released 
+ * when the last weapon releases them. The mutable state of each weapon stays on the weapon
+ */
+UCLASS(NotBlueprintable, Transient)
+class NEURONWEAPONPLAYGROUND_API ANWPWeaponConfigCache : public AInfo
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPWeaponConfigCache(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the weapon config cache of the world. Spawns it if it does not exist and it is allowed
+	static ANWPWeaponConfigCache* GetWeaponConfigCache(UWorld* World, bool _bSpawnIfMissing = true);
+
+	// Returns the number of weapons that are using the weapon config
+	int32 GetReferenceCount(const UNWPWeaponConfig* _WeaponConfig) const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Acquire / Release
+
+	// Returns the shared weapon config of the class, creating it if required, and adds a reference to it
+	const UNWPWeaponConfig* AcquireWeaponConfig(TSubclassOf<UNWPWeaponConfig> _WeaponConfigClass);
+
+	// Requests the load of the assets of a shared weapon config. The weapon config only loads once, the rest of the listeners are told 
+	// when it finishes. The callback is executed when the assets are resident, immediately if they already are
+	void LoadWeaponConfig(const UNWPWeaponConfig* _WeaponConfig, bool _bSyncLoad = true, const FNWPOnWaponConfigLoaded& _Callback = nullptr, 
+		TAsyncLoadPriority _Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+	// Removes a reference from the shared weapon config. The callbacks bound to the listener are removed. The assets are released 
+	// when the last reference is removed
+	void ReleaseWeaponConfig(const UNWPWeaponConfig* _WeaponConfig, const UObject* _Listener = nullptr);
+
+	// Writes the shared weapon configs & their reference count to the log
+	void LogSharedWeaponConfigs() const;
+
+protected:
+
+	// Returns the entry of a weapon config shared by this cache
+	FNWPSharedWeaponConfig* FindSharedWeaponConfig(const UNWPWeaponConfig* _WeaponConfig);
+
+// Member variables
+protected:
+
+	// Shared weapon configs indexed by their class
+	UPROPERTY(Transient, SkipSerialization)
+	TMap<UClass*, FNWPSharedWeaponConfig> SharedWeaponConfigs;
+};
@@ -1,97 +1,176 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#pragma once
-
-// NWP
-#include "NWPProjectileMovementComponent.h"
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "NWPProjectile.generated.h"
-
-/**
- * Projectile that can be launched by a weapon
- * TODO: [NWP-REVIEW] Consider if it is necessary to have a UNWPProjectileConfig
- */
-UCLASS()
-class NEURONWEAPONPLAYGROUND_API ANWPProjectile : public AActor
-{
-	GENERATED_BODY()
-
-// Friend class
-friend class UNWPProjectileMovementComponent;
-
-// Constructors
-public:
-
-	ANWPProjectile(const class FObjectInitializer& ObjectInitializer);
-
-// Member functions
-public:
-
-	/// AActor interface begin
-	// Overridable native event for when play begins for this actor.
-	virtual void BeginPlay() override;
-	/// AActor interface end
-
-	////////////////////////////////////////////////////////////////
-	// Accesors
-
-	// Returns the projectile movement component
-	FORCEINLINE class UNWPProjectileMovementComponent* GetNWPProjectileMovementComponent() const  { return ProjectileMovement; };
-
-	////////////////////////////////////////////////////////////////
-	// Owner
-
-	// This function that sets the owner character for this weapon
-	void SetOwnerWeapon(class ANWPWeapon* _NewOwnerWeapon);
-
-protected:
-
-	// Called when projectile hits something
-	UFUNCTION()
-	void OnHit(class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
-
-	// Callback executed after the projectile velocity has been computed
-	virtual void OnProjectileVelocityComputed(FVector& _ComputedVelocity, float DeltaTime);
-
-// Member variables
-protected:
-
-	///////////////////////////////////////////////////////////////////////////
-	// Configuration
-
-	// Effect spawned where the projectile has impact
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile Configuration")
-	UParticleSystem* ImpactEffect;
-
-	// Effect spawned on the projectile when spawned
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile Configuration")
-	UParticleSystem* TracerEffect;
-
-	// Multiplicative factor applied to the impulse acting on the actor with whom the projectile collides
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile Configuration")
-	float ImpulseStrenghtFactor;
-
-	////////////////////////////////////////////////////////////////
-	// Components
-
-	// Sphere collision component 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile, meta = (AllowPrivateAccess = "true"))
-	class USphereComponent* CollisionComp;
-
-	// Projectile movement component 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile, meta = (AllowPrivateAccess = "true"))
-	class UNWPProjectileMovementComponent* ProjectileMovement;
-
-	// Particle tracer currently spawned
-	UPROPERTY(Transient, SkipSerialization)
-	class UParticleSystemComponent* TracerComponent;
-
-	////////////////////////////////////////////////////////////////
-	// State
-
-	// Reference to the owning weapon
-	UPROPERTY(Transient, SkipSerialization)
-	class ANWPWeapon* OwnerWeapon;
-};
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// NWP
+#include "NWPProjectileMovementComponent.h"
+#include "NWPSparseSet.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "NWPProjectile.generated.h"
+
+/**
+ * Projectile that can be launched by a weapon
+ * TODO: [NWP-REVIEW] Consider if it is necessary to have a UNWPProjectileConfig
+ */
+UCLASS()
+class NEURONWEAPONPLAYGROUND_API ANWPProjectile : public AActor
+{
+	GENERATED_BODY()
+
+// Friend class
+friend class UNWPProjectileMovementComponent;
+friend class ANWPProjectilePool;
+
+// Constructors
+public:
+
+	ANWPProjectile(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable native event for when play begins for this actor.
+	virtual void BeginPlay() override;
+
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Called when the lifespan timer expires
+	virtual void LifeSpanExpired() override;
+	/// AActor interface end
+
+	////////////////////////////////////////////////////////////////
+	// Accesors
+
+	// Returns the projectile movement component
+	FORCEINLINE class UNWPProjectileMovementComponent* GetNWPProjectileMovementComponent() const  { return ProjectileMovement; };
+
+	// Returns the effect spawned where the projectile has impact
+	FORCEINLINE UParticleSystem* GetImpactEffect() const { return ImpactEffect; };
+
+	// Returns the factor applied to the impulse acting on the actor with whom the projectile collides
+	FORCEINLINE float GetImpulseStrenghtFactor() const { return ImpulseStrenghtFactor; };
+
+	// Returns the radius of the collision sphere
+	float GetCollisionRadius() const;
+
+	////////////////////////////////////////////////////////////////
+	// Owner
+
+	// Returns the weapon that has fired the projectile
+	FORCEINLINE class ANWPWeapon* GetOwnerWeapon() const { return OwnerWeapon; }
+
+	// This function that sets the owner character for this weapon
+	void SetOwnerWeapon(class ANWPWeapon* _NewOwnerWeapon);
+
+	// Returns the handle of the projectile in the spawned projectiles of the owner weapon
+	FORCEINLINE const FNWPSparseSetHandle& GetOwnerWeaponHandle() const { return OwnerWeaponHandle; }
+
+	// Sets the handle of the projectile in the spawned projectiles of the owner weapon
+	FORCEINLINE void SetOwnerWeaponHandle(const FNWPSparseSetHandle& _OwnerWeaponHandle) { OwnerWeaponHandle = _OwnerWeaponHandle; }
+
+	////////////////////////////////////////////////////////////////
+	// Movement
+
+	// Simulates the movement of the projectile during the specified time. Used when the projectile has been fired late
+	void AdvanceSimulation(float _DeltaTime);
+
+	////////////////////////////////////////////////////////////////
+	// Pool
+
+	// Returns if the projectile is managed by a projectile pool
+	FORCEINLINE bool IsPooled() const { return OwnerPool != nullptr; }
+
+	// Returns if the projectile is disabled and available in its pool
+	FORCEINLINE bool IsInPool() const { return bIsInPool; }
+
+protected:
+
+	// Called when projectile hits something
+	UFUNCTION()
+	void OnHit(class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	// Callback executed after the projectile velocity has been computed
+	virtual void OnProjectileVelocityComputed(FVector& _ComputedVelocity, float DeltaTime);
+
+	// Releases the projectile to the pool if pooled. Otherwise, destroys it
+	void FinishProjectile();
+
+	// Tells the owner weapon that the projectile is going to be destroyed & forgets it. The weapon is only told once
+	void NotifyOwnerWeaponProjectileFinished();
+
+	////////////////////////////////////////////////////////////////
+	// Tracer
+
+	// Spawns the tracer effect or restarts it if it was already spawned
+	void ActivateTracer();
+
+	// Stops the tracer effect. The tracer is only destroyed if the projectile is not pooled
+	void DeactivateTracer();
+
+	////////////////////////////////////////////////////////////////
+	// Pool
+
+	// Sets the pool that owns this projectile
+	void SetOwnerPool(class ANWPProjectilePool* _NewOwnerPool);
+
+	// Callback executed when the projectile is taken from the pool. Places the projectile and restarts its movement
+	virtual void OnAcquiredFromPool(const FVector& _Location, const FRotator& _Rotation);
+
+	// Callback executed when the projectile is returned to the pool. Disables the projectile until it is acquired again
+	virtual void OnReleasedToPool();
+
+// Member variables
+protected:
+
+	///////////////////////////////////////////////////////////////////////////
+	// Configuration
+
+	// Effect spawned where the projectile has impact
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile Configuration")
+	UParticleSystem* ImpactEffect;
+
+	// Effect spawned on the projectile when spawned
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile Configuration")
+	UParticleSystem* TracerEffect;
+
+	// Multiplicative factor applied to the impulse acting on the actor with whom the projectile collides
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile Configuration")
+	float ImpulseStrenghtFactor;
+
+	////////////////////////////////////////////////////////////////
+	// Components
+
+	// Sphere collision component 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile, meta = (AllowPrivateAccess = "true"))
+	class USphereComponent* CollisionComp;
+
+	// Projectile movement component 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile, meta = (AllowPrivateAccess = "true"))
+	class UNWPProjectileMovementComponent* ProjectileMovement;
+
+	// Particle tracer currently spawned
+	UPROPERTY(Transient, SkipSerialization)
+	class UParticleSystemComponent* TracerComponent;
+
+	////////////////////////////////////////////////////////////////
+	// State
+
+	// Reference to the owning weapon
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPWeapon* OwnerWeapon;
+
+	// Handle of the projectile in the spawned projectiles of the owner weapon
+	FNWPSparseSetHandle OwnerWeaponHandle;
+
+	// Reference to the pool that owns this projectile
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPProjectilePool* OwnerPool;
+
+	// Indicates that the projectile is disabled and available in its pool
+	UPROPERTY(Transient, SkipSerialization)
+	bool bIsInPool;
+};
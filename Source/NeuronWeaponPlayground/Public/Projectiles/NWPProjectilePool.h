@@ -0,0 +1,138 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// NWP
+#include "NWPProjectile.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "NWPProjectilePool.generated.h"
+
+// Struct that contains the statistics of the pool of a projectile class
+USTRUCT()
+struct FNWPProjectilePoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+// Constructors
+public:
+
+	FNWPProjectilePoolStats()
+	{
+		Hits = 0;
+		Misses = 0;
+		ActiveProjectiles = 0;
+		HighWater = 0;
+		PooledProjectiles = 0;
+	}
+
+// Member variables
+public:
+
+	// Number of acquisitions served by an available projectile
+	UPROPERTY(Transient, SkipSerialization)
+	int32 Hits;
+
+	// Number of acquisitions that required to spawn a new projectile
+	UPROPERTY(Transient, SkipSerialization)
+	int32 Misses;
+
+	// Number of projectiles currently in use
+	UPROPERTY(Transient, SkipSerialization)
+	int32 ActiveProjectiles;
+
+	// Maximum number of projectiles in use at the same time
+	UPROPERTY(Transient, SkipSerialization)
+	int32 HighWater;
+
+	// Total number of projectiles owned by the pool (in use or available)
+	UPROPERTY(Transient, SkipSerialization)
+	int32 PooledProjectiles;
+};
+
+// Struct that contains the projectiles of a projectile class
+USTRUCT()
+struct FNWPProjectilePoolEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+// Member variables
+public:
+
+	// Projectiles ready to be acquired
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<ANWPProjectile*> AvailableProjectiles;
+
+	// Statistics of the pool
+	UPROPERTY(Transient, SkipSerialization)
+	FNWPProjectilePoolStats Stats;
+};
+
+/**
+ * Per world pool of projectiles. Projectiles are disabled and reused instead of being destroyed and spawned for each shot
+ */
+UCLASS(NotBlueprintable, Transient)
+class NEURONWEAPONPLAYGROUND_API ANWPProjectilePool : public AInfo
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPProjectilePool(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the projectile pool of the world. Spawns it if it does not exist
+	static ANWPProjectilePool* GetProjectilePool(UWorld* World);
+
+	// Returns the statistics of the pool of a projectile class. Returns nullptr if the class has no pool
+	const FNWPProjectilePoolStats* GetPoolStats(TSubclassOf<ANWPProjectile> _ProjectileClass) const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Pool
+
+	// Makes sure that the pool of a projectile class contains at least the specified number of projectiles
+	void PrewarmProjectiles(TSubclassOf<ANWPProjectile> _ProjectileClass, int32 _Count);
+
+	// Takes a projectile from the pool, spawning a new one if the pool is empty
+	ANWPProjectile* AcquireProjectile(TSubclassOf<ANWPProjectile> _ProjectileClass, const FVector& _Location, const FRotator& _Rotation, class ANWPWeapon* _OwnerWeapon);
+
+	// Returns a projectile to its pool
+	void ReleaseProjectile(ANWPProjectile* _ProjectileToRelease);
+
+	///////////////////////////////////////////////////////////////////////////
+	// Debug
+
+	// Writes the statistics of every pool to the log
+	void LogPoolStats() const;
+
+protected:
+
+	// Spawns a disabled projectile owned by the pool
+	ANWPProjectile* SpawnPooledProjectile(TSubclassOf<ANWPProjectile> _ProjectileClass);
+
+	// Updates the global stats using the pools
+	void UpdateGlobalStats();
+
+// Member variables
+protected:
+
+	// Pools indexed by projectile class
+	UPROPERTY(Transient, SkipSerialization)
+	TMap<UClass*, FNWPProjectilePoolEntry> ProjectilePools;
+
+	// Maximum number of projectiles of any class in use at the same time
+	UPROPERTY(Transient, SkipSerialization)
+	int32 HighWater;
+};
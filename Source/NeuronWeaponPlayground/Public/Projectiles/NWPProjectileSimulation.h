@@ -0,0 +1,192 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "WorldCollision.h"
+
+// NWP
+#include "NWPProjectile.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "NWPProjectileSimulation.generated.h"
+
+// Struct that contains the simulated projectiles that share the projectile class & mesh. The projectiles are stored as structure of arrays
+USTRUCT()
+struct FNWPSimulatedProjectileGroup
+{
+	GENERATED_USTRUCT_BODY()
+
+// Constructors
+public:
+
+	FNWPSimulatedProjectileGroup()
+	{
+		ProjectileClass = nullptr;
+		Mesh = nullptr;
+		InstancedMesh = nullptr;
+		Radius = 0.0f;
+		InitialSpeed = 0.0f;
+		MaxSpeed = 0.0f;
+		GravityScale = 0.0f;
+		LifeSpan = 0.0f;
+		ImpactEffect = nullptr;
+		ImpulseStrenghtFactor = 0.0f;
+	}
+
+// Member functions
+public:
+
+	// Returns the number of simulated projectiles
+	FORCEINLINE int32 Num() const { return Positions.Num(); }
+
+// Member variables
+public:
+
+	///////////////////////////////////////////////////////////////////////////
+	// Configuration
+
+	// Projectile class used to read the configuration
+	UPROPERTY(Transient, SkipSerialization)
+	TSubclassOf<ANWPProjectile> ProjectileClass;
+
+	// Mesh used to draw the projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	class UStaticMesh* Mesh;
+
+	// Component that draws every projectile of the group as an instance
+	UPROPERTY(Transient, SkipSerialization)
+	class UInstancedStaticMeshComponent* InstancedMesh;
+
+	// Radius of the projectile collision sphere
+	UPROPERTY(Transient, SkipSerialization)
+	float Radius;
+
+	// Speed of the projectiles when fired
+	UPROPERTY(Transient, SkipSerialization)
+	float InitialSpeed;
+
+	// Maximum speed of the projectiles. 0 means no limit
+	UPROPERTY(Transient, SkipSerialization)
+	float MaxSpeed;
+
+	// Scale applied to the world gravity
+	UPROPERTY(Transient, SkipSerialization)
+	float GravityScale;
+
+	// Life time of the projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	float LifeSpan;
+
+	// Effect spawned where the projectiles have impact
+	UPROPERTY(Transient, SkipSerialization)
+	class UParticleSystem* ImpactEffect;
+
+	// Factor applied to the impulse acting on the physics components hit by the projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	float ImpulseStrenghtFactor;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Projectiles
+
+	// Position of each projectile, confirmed by its last resolved sweep
+	TArray<FVector> Positions;
+
+	// Velocity of each projectile
+	TArray<FVector> Velocities;
+
+	// Remaining life time of each projectile
+	TArray<float> RemainingLifeTimes;
+
+	// Weapon that has fired each projectile
+	TArray<TWeakObjectPtr<class ANWPWeapon>> OwnerWeapons;
+
+	// Transform of each instance. Used to update the instanced mesh in a single call
+	TArray<FTransform> InstanceTransforms;
+
+	// Asynchronous sweep of each projectile, resolved during the next frame. Invalid if there is no sweep in flight
+	TArray<FTraceHandle> SweepHandles;
+
+	// End of the sweep in flight of each projectile
+	TArray<FVector> SweepEnds;
+
+	// Time that has not been simulated yet of each projectile. Used by the projectiles fired earlier in the frame
+	TArray<float> PendingTimes;
+};
+
+/**
+ * Per world simulation of projectiles that are not actors. The projectiles are moved using asynchronous sweeps that are resolved during the next frame, 
+ * drawn through an instanced mesh and the owner weapons are told through the same callbacks used by ANWPProjectile (without projectile actor).
+ * The simulated projectiles do not bounce, they are removed on the first blocking hit
+ */
+UCLASS(NotBlueprintable, Transient)
+class NEURONWEAPONPLAYGROUND_API ANWPProjectileSimulation : public AInfo
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPProjectileSimulation(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Function called every frame on this Actor. 
+	virtual void Tick(float DeltaSeconds) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the projectile simulation of the world. Spawns it if it does not exist
+	static ANWPProjectileSimulation* GetProjectileSimulation(UWorld* World);
+
+	// Returns the number of simulated projectiles
+	int32 GetNumSimulatedProjectiles() const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Projectiles
+
+	// Adds a projectile to the simulation. The projectile is advanced by the time offset if it was fired late
+	void SpawnProjectile(class ANWPWeapon* _OwnerWeapon, TSubclassOf<ANWPProjectile> _ProjectileClass, class UStaticMesh* _Mesh, 
+		const FVector& _Location, const FRotator& _Rotation, float _TimeOffset = 0.0f);
+
+	// Removes every projectile fired by a weapon
+	void RemoveProjectilesOfWeapon(const class ANWPWeapon* _OwnerWeapon);
+
+protected:
+
+	// Returns the group for a projectile class & mesh, creating it if required
+	FNWPSimulatedProjectileGroup* FindOrAddGroup(TSubclassOf<ANWPProjectile> _ProjectileClass, class UStaticMesh* _Mesh);
+
+	// Resolves the sweep submitted during the last frame, moving the projectile to its end. Returns false if the projectile has been removed
+	bool ResolveProjectileSweep(FNWPSimulatedProjectileGroup& _Group, int32 _Index, FCollisionQueryParams& _QueryParams);
+
+	// Computes the velocity of a projectile and submits its sweep. Returns false if the projectile has been removed
+	bool StepProjectile(FNWPSimulatedProjectileGroup& _Group, int32 _Index, float _DeltaTime, FCollisionQueryParams& _QueryParams);
+
+	// Makes the query params ignore the weapon that has fired the projectile. The params are only rebuilt when the weapon changes
+	void UpdateQueryParams(FCollisionQueryParams& _QueryParams, class ANWPWeapon* _OwnerWeapon);
+
+	// Handles the hit of a projectile
+	void OnProjectileHit(FNWPSimulatedProjectileGroup& _Group, int32 _Index, const FHitResult& _Hit);
+
+	// Removes a projectile from its group
+	void RemoveProjectile(FNWPSimulatedProjectileGroup& _Group, int32 _Index);
+
+	// Updates the instances of the group using the projectile positions & velocities
+	void UpdateInstances(FNWPSimulatedProjectileGroup& _Group);
+
+// Member variables
+protected:
+
+	// Groups of simulated projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<FNWPSimulatedProjectileGroup> ProjectileGroups;
+
+	// Weapon whose actors are ignored by the current query params
+	TWeakObjectPtr<class ANWPWeapon> CurrentQueryParamsWeapon;
+};
@@ -0,0 +1,78 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Projects world positions to screen positions in batches. The view projection is built once per frame from the player controller 
+ * (or from the projection data of a view) and every position is transformed with vector math. Matches the result of APlayerController::ProjectWorldLocationToScreen
+ */
+struct NEURONWEAPONPLAYGROUND_API FNWPBatchedScreenProjector
+{
+// Constructors
+public:
+
+	FNWPBatchedScreenProjector();
+
+// Member functions
+public:
+
+	// Builds the view projection of the player for the current frame. Does nothing if it was already built during the frame. Returns if the projector is valid
+	bool Setup(class APlayerController* _PlayerController);
+
+	// Builds the view projection from the projection data of a view. Used by Setup & by the tests, that have no player
+	void SetupFromProjectionData(const struct FSceneViewProjectionData& _ProjectionData);
+
+	// Returns if the projector has a valid view projection
+	FORCEINLINE bool IsValid() const { return bIsValid; }
+
+	// Returns the frame in which the view projection has been built
+	FORCEINLINE uint64 GetSetupFrame() const { return SetupFrame; }
+
+	// Projects a single position. Returns if the position is in front of the view
+	bool ProjectPosition(const FVector& _WorldPosition, FVector2D& _OutScreenPosition) const;
+
+	// Projects every position. The output arrays share the index with the positions. A position behind the view is not valid
+	void ProjectPositions(const TArray<FVector>& _WorldPositions, TArray<FVector2D>& _OutScreenPositions, TArray<bool>& _OutValidPositions) const;
+
+	// Projects the positions of the indices. The output arrays share the index with the positions. The positions not projected are not valid
+	void ProjectIndexedPositions(const TArray<FVector>& _WorldPositions, const TArray<int32>& _Indices, TArray<FVector2D>& _OutScreenPositions, 
+		TArray<bool>& _OutValidPositions) const;
+
+	// Builds the frustum that goes through a screen rectangle up to a distance, and its bounds. Returns if the frustum could be built
+	bool BuildScreenRectFrustum(const FVector2D& _ScreenMin, const FVector2D& _ScreenMax, float _MaxDistance, struct FConvexVolume& _OutFrustum, FBox& _OutBounds) const;
+
+protected:
+
+	// Projects a position using the rows of the view projection loaded in registers. Returns if the position is in front of the view
+	FORCEINLINE bool ProjectPositionVectorized(const VectorRegister& _Row0, const VectorRegister& _Row1, const VectorRegister& _Row2, const VectorRegister& _Row3,
+		const FVector& _WorldPosition, FVector2D& _OutScreenPosition) const;
+
+// Member variables
+protected:
+
+	// View projection matrix of the player
+	FMatrix ViewProjectionMatrix;
+
+	// Inverse of the view projection matrix of the player
+	FMatrix InvViewProjectionMatrix;
+
+	// Location of the view
+	FVector ViewOrigin;
+
+	// View rect in the viewport
+	FIntRect ViewRect;
+
+	// Origin of the view rect in the viewport
+	FVector2D ViewRectMin;
+
+	// Size of the view rect
+	FVector2D ViewRectSize;
+
+	// Frame in which the view projection has been built
+	uint64 SetupFrame;
+
+	// If the view projection is valid
+	bool bIsValid;
+};
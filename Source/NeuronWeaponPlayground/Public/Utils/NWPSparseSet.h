@@ -0,0 +1,89 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Handle of an element of a sparse set. The generation detects the handles of the elements that have been removed
+struct FNWPSparseSetHandle
+{
+// Constructors
+public:
+
+	FNWPSparseSetHandle()
+	{
+		Index = INDEX_NONE;
+		Generation = 0;
+	}
+
+// Member functions
+public:
+
+	// Returns if the handle has been given by a sparse set. It may be stale
+	FORCEINLINE bool IsSet() const { return Index != INDEX_NONE; }
+
+	// Forgets the element
+	FORCEINLINE void Reset() { Index = INDEX_NONE; Generation = 0; }
+
+	FORCEINLINE bool operator==(const FNWPSparseSetHandle& _Other) const { return Index == _Other.Index && Generation == _Other.Generation; }
+	FORCEINLINE bool operator!=(const FNWPSparseSetHandle& _Other) const { return !(*this == _Other); }
+
+// Member variables
+public:
+
+	// Sparse index of the element
+	int32 Index;
+
+	// Generation of the sparse index when the element was added
+	uint32 Generation;
+};
+
+/**
+ * Sparse set of generational handles. Maps the handles to dense indices in O(1). The owner keeps the elements in arrays that share 
+ * the dense index, so they are iterated without holes. When an element is removed, the owner has to remove the returned dense index 
+ * of its arrays with RemoveAtSwap, as the set moves the last element to the removed slot. A removed handle is never valid again
+ */
+struct NEURONWEAPONPLAYGROUND_API FNWPSparseSet
+{
+// Member functions
+public:
+
+	// Returns the number of elements
+	FORCEINLINE int32 Num() const { return DenseToSparse.Num(); }
+
+	// Returns the dense index of a handle. INDEX_NONE if the handle is stale
+	FORCEINLINE int32 GetDenseIndex(const FNWPSparseSetHandle& _Handle) const
+	{
+		return SparseGenerations.IsValidIndex(_Handle.Index) && SparseGenerations[_Handle.Index] == _Handle.Generation ? SparseToDense[_Handle.Index] : INDEX_NONE;
+	}
+
+	// Returns if the handle is not stale
+	FORCEINLINE bool Contains(const FNWPSparseSetHandle& _Handle) const { return GetDenseIndex(_Handle) != INDEX_NONE; }
+
+	// Returns the handle of the element at a dense index
+	FNWPSparseSetHandle GetHandle(int32 _DenseIndex) const;
+
+	// Adds an element at the end of the dense arrays. Returns its handle
+	FNWPSparseSetHandle Add();
+
+	// Removes an element. Returns the dense index to remove with RemoveAtSwap. INDEX_NONE if the handle is stale
+	int32 Remove(const FNWPSparseSetHandle& _Handle);
+
+	// Removes every element. The handles given before are stale
+	void Empty();
+
+// Member variables
+protected:
+
+	// Dense index of each sparse index. INDEX_NONE if the sparse index is free
+	TArray<int32> SparseToDense;
+
+	// Generation of each sparse index. Increased when its element is removed
+	TArray<uint32> SparseGenerations;
+
+	// Sparse index of each dense index
+	TArray<int32> DenseToSparse;
+
+	// Sparse indices that can be reused
+	TArray<int32> FreeSparseIndices;
+};
@@ -0,0 +1,128 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+
+#include "CoreMinimal.h"
+
+// Ranked target of a target ranking
+struct FNWPTargetRankingEntry
+{
+// Constructors
+public:
+
+	FNWPTargetRankingEntry()
+	{
+		Alignment = -1.0f;
+		NumAssignments = 0;
+		LastAllocation = 0;
+		UpdateStamp = 0;
+	}
+
+// Member variables
+public:
+
+	// The ranked target. Weak, so a target destroyed since the last update is not used
+	TWeakObjectPtr<const AActor> Target;
+
+	// Dot product between the weapon forward & the direction from the weapon to the target
+	float Alignment;
+
+	// Number of projectiles steered to the target
+	int32 NumAssignments;
+
+	// Allocation in which the target was selected. 0 if it has not been selected yet
+	uint32 LastAllocation;
+
+	// Update in which the target was ranked
+	uint32 UpdateStamp;
+};
+
+/**
+ * Ranking of the targets of a smart weapon, kept in an indexed binary heap. The best target according to the allocation policy is at 
+ * the top, so it is selected in O(1) and the ranking is fixed in O(log n) after each allocation. The targets are compared by the dot 
+ * product of their direction with the weapon forward. The targets are ranked between BeginUpdate & EndUpdate, which removes the ones 
+ * that have not been ranked again. The number of projectiles steered to each target is kept while they fly, even if it leaves the ranking.
+ * The targets are not tracked by the garbage collector, so the ones destroyed since the last update are skipped when they reach the top
+ */
+class NEURONWEAPONPLAYGROUND_API FNWPTargetRanking
+{
+
+// Constructors
+public:
+
+	FNWPTargetRanking();
+
+// Member functions
+public:
+
+	// Returns the number of ranked targets
+	FORCEINLINE int32 Num() const { return Heap.Num(); }
+
+	// Returns the allocation policy
+	FORCEINLINE ENWPTargetAllocationPolicy GetPolicy() const { return Policy; }
+
+	// Returns the best target without selecting it. Null if there are no targets or the best one has been destroyed since the last update
+	FORCEINLINE const AActor* GetBestTarget() const { return Heap.Num() > 0 ? Heap[0].Target.Get() : nullptr; }
+
+	// Changes the allocation policy & ranks the targets again
+	void SetPolicy(ENWPTargetAllocationPolicy _Policy);
+
+	// Starts ranking the targets
+	void BeginUpdate();
+
+	// Adds a target or updates its alignment
+	void RankTarget(const AActor* _Target, float _Alignment);
+
+	// Removes the targets that have not been ranked since BeginUpdate
+	void EndUpdate();
+
+	// Selects the best target that has not been destroyed & assigns a projectile to it. Null if there are no targets
+	const AActor* AllocateTarget();
+
+	// Removes the assignment of a projectile to a target
+	void ReleaseTarget(const AActor* _Target);
+
+	// Removes all the targets & assignments
+	void Empty();
+
+protected:
+
+	// Returns if the entry at the first heap index is better than the entry at the second one
+	bool IsBetter(int32 _HeapIndexA, int32 _HeapIndexB) const;
+
+	// Moves the entry at the heap index to its place
+	void FixHeapIndex(int32 _HeapIndex);
+
+	// Swaps the entries at two heap indices
+	void SwapHeapIndices(int32 _HeapIndexA, int32 _HeapIndexB);
+
+	// Removes the entry at the heap index
+	void RemoveAtHeapIndex(int32 _HeapIndex);
+
+// Member variables
+protected:
+
+	// Ranked targets, in heap order
+	TArray<FNWPTargetRankingEntry> Heap;
+
+	// Heap index of each ranked target
+	TMap<TWeakObjectPtr<const AActor>, int32> HeapIndices;
+
+	// Number of projectiles steered to each target, including the targets that are not ranked
+	TMap<TWeakObjectPtr<const AActor>, int32> Assignments;
+
+	// Policy used to compare the targets
+	ENWPTargetAllocationPolicy Policy;
+
+	// Counter increased on each allocation
+	uint32 AllocationCounter;
+
+	// Counter increased on each update
+	uint32 UpdateCounter;
+
+	// Targets that have not been ranked during the last update
+	TArray<TWeakObjectPtr<const AActor>> StaleTargets;
+};
@@ -0,0 +1,66 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Timer stored in a slot of the timer wheel
+struct FNWPTimerWheelEntry
+{
+	// Item that owns the timer
+	int32 Item;
+
+	// Id of the timer. The timer is discarded if it is not the current timer of the item anymore
+	uint32 Id;
+
+	// Time at which the timer expires
+	double ExpiryTime;
+};
+
+/**
+ * Hashed timer wheel. Each timer is stored in the slot of the tick in which it expires, so advancing the time only visits the slots 
+ * of the elapsed ticks instead of every item. The timers that expire after a full turn stay in their slot until their turn comes. 
+ * Timers are not removed when they are rescheduled or cancelled, they are discarded when their slot is visited
+ */
+struct NEURONWEAPONPLAYGROUND_API FNWPTimerWheel
+{
+// Constructors
+public:
+
+	FNWPTimerWheel();
+
+// Member functions
+public:
+
+	// Sets the duration of each slot & the number of slots, rounded up to a power of two. Removes every timer
+	void Initialize(float _SlotDuration, int32 _NumSlots);
+
+	// Returns the number of timers in the wheel, including the discarded ones that have not been visited yet
+	FORCEINLINE int32 GetNumTimers() const { return NumTimers; }
+
+	// Adds a timer of an item
+	void Schedule(int32 _Item, uint32 _Id, double _ExpiryTime);
+
+	// Advances the wheel to the time. Writes the items of the expired timers that are still valid
+	void Advance(double _CurrentTime, TFunctionRef<bool(int32 _Item, uint32 _Id)> _IsTimerValid, TArray<int32>& _OutExpiredItems);
+
+protected:
+
+	// Returns the tick in which a time is
+	FORCEINLINE int64 GetTick(double _Time) const { return (int64)FMath::FloorToDouble(_Time / SlotDuration); }
+
+// Member variables
+protected:
+
+	// Timers of each slot
+	TArray<TArray<FNWPTimerWheelEntry>> Slots;
+
+	// Duration of each slot
+	float SlotDuration;
+
+	// Tick of the last advance. Its slot is visited again in the next advance
+	int64 CurrentTick;
+
+	// Number of timers in the wheel
+	int32 NumTimers;
+};
@@ -0,0 +1,102 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "Engine/World.h"
+
+// NWP
+#include "NeuronWeaponPlayground.h"
+
+#include "CoreMinimal.h"
+
+// Enum for the kinds of traces whose quality is recorded
+enum class ENWPTraceCategory : uint8
+{
+	Obstacle,
+	Hitscan,
+	COUNT,
+};
+
+// Struct that counts how often the complex collision changes the result of the simple collision
+struct FNWPTraceQualityRecord
+{
+// Constructors
+public:
+
+	FNWPTraceQualityRecord()
+	{
+		NumCompared = 0;
+		NumSimpleHits = 0;
+		NumComplexHits = 0;
+		NumChanged = 0;
+	}
+
+// Member variables
+public:
+
+	// Number of traces done against both collisions
+	int32 NumCompared;
+
+	// Number of traces that have hit the simple collision
+	int32 NumSimpleHits;
+
+	// Number of traces that have hit the complex collision
+	int32 NumComplexHits;
+
+	// Number of traces whose complex result is a different hit than the simple one
+	int32 NumChanged;
+};
+
+/**
+ * Line traces of a configurable quality. The simple collision is enough for most queries, so the complex collision is only traced when
+ * the quality asks for it. A simple miss is trusted, the simple collision is expected to enclose the render geometry. A simple hit is 
+ * refined with a short complex trace that crosses the bounds of the hit component, instead of tracing the whole segment again.
+ * The traces done against both collisions are recorded per map, so the maps where the refinement never changes the result can be found
+ */
+class NEURONWEAPONPLAYGROUND_API FNWPTraceQuality
+{
+
+// Member functions
+public:
+
+	// Returns if the first trace of a quality is against the complex collision
+	static bool IsFirstTraceComplex(ENWPTraceQuality _Quality);
+
+	// Returns if the traces are also done against the collision their quality skips
+	static bool IsAuditEnabled();
+
+	// Traces a line with a quality. The complex flag of the query params is ignored. Returns if something has been hit
+	static bool LineTraceSingleByChannel(UWorld* _World, FHitResult& _OutHit, const FVector& _Start, const FVector& _End, ECollisionChannel _Channel, 
+		const FCollisionQueryParams& _QueryParams, ENWPTraceQuality _Quality, ENWPTraceCategory _Category);
+
+	// Refines the result of a first trace done with the complex flag returned by IsFirstTraceComplex. Used by the asynchronous traces.
+	// The cycles of the first trace are only used to measure the time saved by the two phases. Returns if something has been hit
+	static bool RefineFirstTrace(UWorld* _World, bool _bFirstHit, FHitResult& _InOutHit, const FVector& _Start, const FVector& _End, ECollisionChannel _Channel, 
+		const FCollisionQueryParams& _QueryParams, ENWPTraceQuality _Quality, ENWPTraceCategory _Category, uint32 _FirstTraceCycles = 0);
+
+	// Computes the window of the segment, as distances from its start, that crosses the bounds of the component of a simple hit. 
+	// The window does not begin before the minimum distance
+	static void ComputeRefinementWindow(const FHitResult& _SimpleHit, const FVector& _Start, const FVector& _End, float _MinDistance, float& _OutWindowBegin, 
+		float& _OutWindowEnd);
+
+	// Makes the hit of a trace that begins at a distance from the start of the segment relative to the whole segment
+	static void MakeHitRelativeToSegment(FHitResult& _InOutHit, float _TraceBeginDistance, const FVector& _Start, const FVector& _End);
+
+	// Records a trace done against both collisions in the records of the map of the world
+	static void RecordComparison(UWorld* _World, ENWPTraceCategory _Category, bool _bSimpleHit, const FHitResult& _SimpleHit, bool _bComplexHit, 
+		const FHitResult& _ComplexHit);
+
+	// Writes the records of every map to the log
+	static void LogRecords();
+
+	// Clears the records of every map
+	static void ResetRecords();
+
+protected:
+
+	// Traces the complex collision only inside short windows that cross the simple hits of the segment, starting with the given one.
+	// Returns if something has been hit
+	static bool TraceComplexAroundSimpleHit(UWorld* _World, const FHitResult& _SimpleHit, FHitResult& _OutHit, const FVector& _Start, const FVector& _End, 
+		ECollisionChannel _Channel, const FCollisionQueryParams& _QueryParams);
+};
@@ -1,30 +1,128 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "UObject/NoExportTypes.h"
-#include "NWPUtils.generated.h"
-
-/**
- * A set of useful functions
- */
-UCLASS()
-class NEURONWEAPONPLAYGROUND_API UNWPUtils : public UObject
-{
-	GENERATED_BODY()
-
-// Member functions
-public:
-
-	// This function retrieves the name for a given enum value.
-	template <typename T>
-	static FString GetEnumName(const TCHAR* EnumName, const T EnumValue)
-	{
-		static_assert(TIsEnum<T>::Value, "Should only call this with enum types");
-
-		// Find the enum and return the value
-		const UEnum* EnumPtr = FindObject<UEnum>(ANY_PACKAGE, EnumName, true);
-		return EnumPtr ? EnumPtr->GetNameStringByValue(static_cast<int64>(EnumValue)) : FString(TEXT("Invalid"));
-	}
-};
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "EngineUtils.h"
+#include "Engine/World.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "NWPUtils.generated.h"
+
+// Struct that counts the work done during a frame against a budget
+struct FNWPFrameBudget
+{
+// Constructors
+public:
+
+	FNWPFrameBudget()
+	{
+		CurrentFrame = 0;
+		CurrentUsed = 0;
+	}
+
+// Member functions
+public:
+
+	// Tries to consume an amount of the budget of the current frame. A budget lower or equal than 0 is unlimited
+	bool TryToConsume(int32 _Budget, int32 _Amount = 1)
+	{
+		RefreshFrame();
+
+		// Check if there is enough budget
+		if (_Budget > 0 && CurrentUsed + _Amount > _Budget)
+		{
+			return false;
+		}
+
+		CurrentUsed += _Amount;
+		return true;
+	}
+
+	// Returns the amount of budget used during the current frame
+	int32 GetUsed()
+	{
+		RefreshFrame();
+		return CurrentUsed;
+	}
+
+protected:
+
+	// Resets the used budget if a new frame has started
+	void RefreshFrame()
+	{
+		if (CurrentFrame != GFrameCounter)
+		{
+			CurrentFrame = GFrameCounter;
+			CurrentUsed = 0;
+		}
+	}
+
+// Member variables
+protected:
+
+	// Frame in which the budget has been used
+	uint64 CurrentFrame;
+
+	// Budget used during the frame
+	int32 CurrentUsed;
+};
+
+/**
+ * A set of useful functions
+ */
+UCLASS()
+class NEURONWEAPONPLAYGROUND_API UNWPUtils : public UObject
+{
+	GENERATED_BODY()
+
+// Member functions
+public:
+
+	// This function retrieves the name for a given enum value.
+	template <typename T>
+	static FString GetEnumName(const TCHAR* EnumName, const T EnumValue)
+	{
+		static_assert(TIsEnum<T>::Value, "Should only call this with enum types");
+
+		// Find the enum and return the value
+		const UEnum* EnumPtr = FindObject<UEnum>(ANY_PACKAGE, EnumName, true);
+		return EnumPtr ? EnumPtr->GetNameStringByValue(static_cast<int64>(EnumValue)) : FString(TEXT("Invalid"));
+	}
+
+	// Returns the manager actor of the given class that lives in the world. Spawns it if required and allowed.
+	// The lookup iterates the actors of the class, so callers should cache the result
+	template <typename T>
+	static T* GetWorldManager(UWorld* World, bool _bSpawnIfMissing = true)
+	{
+		static_assert(TIsDerivedFrom<T, AActor>::IsDerived, "Should only call this with actor types");
+
+		// Early return if invalid world
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		// Return the manager if it already exists
+		for (TActorIterator<T> It(World); It; ++It)
+		{
+			if (!It->IsPendingKill())
+			{
+				return *It;
+			}
+		}
+
+		// Only spawn managers in game worlds that are not being torn down
+		if (!_bSpawnIfMissing || !World->IsGameWorld() || World->bIsTearingDown)
+		{
+			return nullptr;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		return World->SpawnActor<T>(SpawnParams);
+	}
+};
@@ -1,199 +1,316 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#pragma once
-
-// NWP
-#include "NWPSmartWeaponConfig.h"
-
-#include "CoreMinimal.h"
-#include "Weapons/NWPWeapon.h"
-#include "NWPSmartWeapon.generated.h"
-
-// Struct that contains information of a smart controlled projectile
-USTRUCT()
-struct FNWPSmartProjectileData
-{
-	GENERATED_USTRUCT_BODY()
-
-// Constructors
-public:
-
-	FNWPSmartProjectileData()
-	{
-		TargetActor = nullptr;
-		TargetObstacle = nullptr;
-		AvoidObstaclePoint = FVector::ZeroVector;
-		CurrentState = ENWPSmartProjectileState::OrientatingToTarget;
-	}
-
-	FNWPSmartProjectileData(const AActor* _TargetActor)
-	{
-		TargetActor = _TargetActor;
-		TargetObstacle = nullptr;
-		AvoidObstaclePoint = FVector::ZeroVector;
-		CurrentState = ENWPSmartProjectileState::OrientatingToTarget;
-	}
-
-// Member functions
-public:
-
-	// Get the target actor
-	const AActor* GetTargetActor() const { return TargetActor; }
-
-	// Get the target obstacle
-	const AActor* GetTargetObstacle() const { return TargetObstacle; }
-
-	// Set the target obstacle
-	void SetTargetObstacle(const AActor* _TargetObstacle) { TargetObstacle = _TargetObstacle; }
-
-	// Get the point to avoid the obstacle
-	FVector GetAvoidObstaclePoint() const { return AvoidObstaclePoint; }
-
-	// Set the point to avoid the obstacle
-	void SetAvoidObstaclePoint(FVector _AvoidObstaclePoint) { AvoidObstaclePoint = _AvoidObstaclePoint; }
-
-	// Returns if the projectile is orientating to avoid obstacles
-	bool IsOrientatingToAvoidObstacles() const { return CurrentState == ENWPSmartProjectileState::OrientatingToAvoidObstacle; }
-
-	// Returns if the projectile is orientating to target
-	bool IsOrientatingToTarget() const { return CurrentState == ENWPSmartProjectileState::OrientatingToTarget; }
-
-	// Returns if the projectile has hit with something
-	bool HasHitWithSomthing() const { return CurrentState == ENWPSmartProjectileState::HitWithSomething; }
-
-	// Get the projectile current state
-	ENWPSmartProjectileState GetCurrentState() const { return CurrentState; }
-
-	// Set the projectile current state
-	void SetCurrentState(ENWPSmartProjectileState _CurrentState) { CurrentState = _CurrentState; }
-
-// Member variables
-protected:
-
-	// The target actor of the projectile 
-	UPROPERTY(Transient, SkipSerialization)
-	const AActor* TargetActor;
-
-	// The target obstacle of the projectile 
-	UPROPERTY(Transient, SkipSerialization)
-	const AActor* TargetObstacle;
-
-	// Point used to avoid the obstacle
-	UPROPERTY(Transient, SkipSerialization)
-	FVector AvoidObstaclePoint;
-
-	// The current state of the projectile
-	UPROPERTY(Transient, SkipSerialization)
-	ENWPSmartProjectileState CurrentState;
-};
-
-/**
- * Weapon that can launch projectiles that can follow a target and avoid some obstacles. Can be configured using UNWPSmartWeaponConfig
- */
-UCLASS()
-class NEURONWEAPONPLAYGROUND_API ANWPSmartWeapon : public ANWPWeapon
-{
-	GENERATED_BODY()
-
-// Constructors
-public:
-
-	ANWPSmartWeapon(const class FObjectInitializer& ObjectInitializer);
-
-// Member functions
-public:
-
-	/// AActor interface begin
-	// Function called every frame on this Actor. 
-	virtual void Tick(float DeltaSeconds) override;
-	/// AActor interface end
-
-	///////////////////////////////////////////////////////////////////////////
-	// Accessors
-
-	// Returns the smart weapon config
-	FORCEINLINE const class UNWPSmartWeaponConfig* GetSmartWeaponConfig() const { return Cast<UNWPSmartWeaponConfig>(CurrentWeaponConfig); }
-
-	// Returns the current targets
-	FORCEINLINE const TArray<AActor*> GetCurrentTargets() const { return CurrentTargets; }
-
-	// Returns the target area begin position
-	FORCEINLINE FVector2D GetTargetAreaBeginPosition() const { return TargetAreaBeginPosition; }
-
-	// Returns the target area begin
-	FORCEINLINE FVector2D GetTargetArea() const { return TargetArea; }
-
-protected:
-
-	/// ANWPWeapon interface begin
-	// Callback executed when the weapon loads
-	virtual void OnWeaponLoaded() override;
-	/// ANWPWeapon interface end
-
-	///////////////////////////////////////////////////////////////////////////
-	// Target
-
-	// Returns if at least there is one target to shoot
-	bool HasTargetToShoot();
-
-	// Returns the target to shoot
-	const AActor* GetTargetToShoot();
-
-	// Calculate the viewport target positions according to the current
-	void CalculateViewportTargetPositions();
-
-	// Update the targets
-	void UpdateTargets();
-
-	// Evaluate if a target is inside the target area
-	bool IsActorInsideTargetArea(class AActor* ActorToEvaluate);
-
-	///////////////////////////////////////////////////////////////////////////
-	// Projectile
-
-	// Spawns the projectile
-	virtual void SpawProjectile() override;
-
-	// Get the avoid obstacle point according to the obstacle
-	FVector GetAvoidObstaclePoint(class ANWPProjectile* _ProjectileToProcess, class AActor* TargetObstacle);
-
-	// Updates the smart projectiles
-	void UpdateSmartProjectiles(float DeltaTime);
-
-	// Updates a smart projectile
-	void UpdateSmartProjectile(class ANWPProjectile* _ProjectileToProcess, float DeltaTime);
-
-	// Callback executed after the projectile velocity has been computed
-	virtual void OnProjectileVelocityComputed(class ANWPProjectile* _ProjectileToProcess, FVector& _ComputedVelocity, float DeltaTime) override;
-
-	// Callback executed when the projectile has hit something
-	virtual void OnProjectileHit(class ANWPProjectile* _ProjectileToProcess, class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, 
-		FVector NormalImpulse, const FHitResult& Hit);
-
-	// Callback executed before the projectile is destroyed
-	virtual void OnProjectileIsGoingToBeDestroyed(class ANWPProjectile* _ProjectileToProcess) override;
-
-// Member variables
-protected:
-
-	// Targets inside the target area
-	UPROPERTY(Transient, SkipSerialization)
-	TArray<AActor*> CurrentTargets;
-
-	// The target area begin position
-	UPROPERTY(Transient, SkipSerialization)
-	FVector2D TargetAreaBeginPosition;
-
-	// The target area. The X is the horizontal size. The Y is the vertical size
-	UPROPERTY(Transient, SkipSerialization)
-	FVector2D TargetArea;
-
-	// Map that contains information about the smart projectiles
-	UPROPERTY(Transient, SkipSerialization)
-	TMap<ANWPProjectile*, FNWPSmartProjectileData> SmartProjectiles;
-
-	// Time used to evaluate if the projectiles have to be updated
-	UPROPERTY(Transient, SkipSerialization)
-	float CurrentUpdateProjectilesTime;
-
-};
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// NWP
+#include "NWPSmartWeaponConfig.h"
+#include "NWPScreenProjector.h"
+#include "NWPTargetRanking.h"
+
+#include "CoreMinimal.h"
+#include "Weapons/NWPWeapon.h"
+#include "NWPSmartWeapon.generated.h"
+
+// Steering state of the projectiles of a smart weapon. The projectiles are stored as structure of arrays that share the index 
+// with the spawned projectiles of the weapon, so the velocity callback reads only the arrays it needs without copies
+USTRUCT()
+struct FNWPSmartProjectileSteering
+{
+	GENERATED_USTRUCT_BODY()
+
+// Member functions
+public:
+
+	// Returns the number of projectiles
+	FORCEINLINE int32 Num() const { return States.Num(); }
+
+	// Returns if the projectile is steered. The projectiles fired without target fly straight
+	FORCEINLINE bool IsSmart(int32 _Index) const { return TargetActors[_Index] != nullptr; }
+
+	// Returns if the projectile is orientating to avoid obstacles
+	FORCEINLINE bool IsOrientatingToAvoidObstacles(int32 _Index) const { return States[_Index] == ENWPSmartProjectileState::OrientatingToAvoidObstacle; }
+
+	// Returns if the projectile is orientating to target
+	FORCEINLINE bool IsOrientatingToTarget(int32 _Index) const { return States[_Index] == ENWPSmartProjectileState::OrientatingToTarget; }
+
+	// Returns if the projectile has hit with something
+	FORCEINLINE bool HasHitWithSomthing(int32 _Index) const { return States[_Index] == ENWPSmartProjectileState::HitWithSomething; }
+
+	// Adds a projectile that is not steered at the end of the arrays. Returns its index
+	int32 Add();
+
+	// Starts steering a projectile to a target
+	void SetTarget(int32 _Index, const AActor* _TargetActor);
+
+	// Removes a projectile. The last projectile is moved to its index
+	void RemoveAtSwap(int32 _Index);
+
+// Member variables
+public:
+
+	// The target actor of each projectile 
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<AActor*> TargetActors;
+
+	// The target obstacle of each projectile 
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<AActor*> TargetObstacles;
+
+	// Point used by each projectile to avoid the obstacle
+	TArray<FVector> AvoidObstaclePoints;
+
+	// The current state of each projectile
+	TArray<ENWPSmartProjectileState> States;
+
+	// Time until each projectile has to be updated again
+	TArray<float> TimesUntilUpdate;
+
+	// If each projectile is waiting in the update queue
+	TArray<bool> QueuedFlags;
+};
+
+// Obstacle probe whose simple hit is refined against the complex collision by a follow up asynchronous trace
+struct FNWPObstacleProbeRefinement
+{
+// Constructors
+public:
+
+	FNWPObstacleProbeRefinement()
+	{
+		Start = FVector::ZeroVector;
+		End = FVector::ZeroVector;
+		TraceBeginDistance = 0.0f;
+		TraceEndDistance = 0.0f;
+		bIsWindow = false;
+	}
+
+// Member variables
+public:
+
+	// Handle of the probed projectile
+	FNWPSparseSetHandle ProjectileHandle;
+
+	// Hit of the probe against the simple collision
+	FHitResult SimpleHit;
+
+	// Start of the segment of the probe
+	FVector Start;
+
+	// End of the segment of the probe
+	FVector End;
+
+	// Distance along the segment where the refinement trace begins
+	float TraceBeginDistance;
+
+	// Distance along the segment where the refinement trace ends
+	float TraceEndDistance;
+
+	// If the refinement trace only covers the window around the simple hit. The rest of the segment is traced if the window misses
+	bool bIsWindow;
+};
+
+/**
+ * Weapon that can launch projectiles that can follow a target and avoid some obstacles. Can be configured using UNWPSmartWeaponConfig
+ */
+UCLASS()
+class NEURONWEAPONPLAYGROUND_API ANWPSmartWeapon : public ANWPWeapon
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPSmartWeapon(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the smart weapon config
+	FORCEINLINE const class UNWPSmartWeaponConfig* GetSmartWeaponConfig() const { return Cast<const UNWPSmartWeaponConfig>(CurrentWeaponConfig); }
+
+	// Returns the current targets
+	FORCEINLINE const TArray<AActor*> GetCurrentTargets() const { return CurrentTargets; }
+
+	// Returns the target area begin position
+	FORCEINLINE FVector2D GetTargetAreaBeginPosition() const { return TargetAreaBeginPosition; }
+
+	// Returns the target area begin
+	FORCEINLINE FVector2D GetTargetArea() const { return TargetArea; }
+
+	// Returns the screen position of a target computed during the last update. Returns if the target is registered & in front of the view
+	bool GetTargetScreenPosition(const AActor* _Target, FVector2D& _OutScreenPosition) const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Steering
+
+	// Returns the velocity of a projectile orientated to a point during a movement substep. The velocity does not change if the projectile moves away from the point
+	static FVector SteerVelocity(const FVector& _Velocity, const FVector& _ProjectileLocation, const FVector& _TargetPoint, float _DeltaTime, float _OrientationVelocity);
+
+protected:
+
+	/// ANWPWeapon interface begin
+	// Configures the weapon using the values of the config. Called before the assets are loaded
+	virtual void ConfigureWeapon() override;
+
+	// Updates the shooting, the targets & the smart projectiles. Called after the cool down update
+	virtual void UpdateWeapon(float DeltaSeconds) override;
+
+	// Returns if the weapon has work to do in the current frame. The equipped weapon always updates its targets
+	virtual bool NeedsWeaponUpdate() const override;
+	/// ANWPWeapon interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Target
+
+	// Returns if at least there is one target to shoot
+	bool HasTargetToShoot();
+
+	// Returns the target to shoot & assigns the projectile to it
+	const AActor* GetTargetToShoot();
+
+	// Calculate the viewport target positions according to the current
+	void CalculateViewportTargetPositions();
+
+	// Update the targets
+	void UpdateTargets();
+
+	// Evaluate if a target is inside the target area
+	bool IsActorInsideTargetArea(class AActor* ActorToEvaluate);
+
+	// Evaluate if a screen location is inside the target area
+	bool IsScreenLocationInsideTargetArea(const FVector2D& TargetScreenLocation) const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Projectile
+
+	// Callback executed after a shot has been fired
+	virtual void OnShotFired(const FNWPShotData& _ShotData, class ANWPProjectile* _SpawnedProjectile) override;
+
+	// Returns if the projectiles are simulated as data. Smart projectiles are steered per actor, so they are never simulated
+	virtual bool ShouldUseSimulatedProjectiles() const override { return false; };
+
+	// Get the avoid obstacle point according to the obstacle
+	FVector GetAvoidObstaclePoint(class ANWPProjectile* _ProjectileToProcess, class AActor* TargetObstacle);
+
+	// Updates the smart projectiles
+	void UpdateSmartProjectiles(float DeltaTime);
+
+	// Builds the query params shared by the obstacle traces of the smart projectiles
+	void BuildObstacleQueryParams();
+
+	// Returns the time until the next update of a projectile. Projectiles close to the target or to an obstacle are updated more often
+	float GetSmartProjectileUpdateInterval(int32 _ProjectileIndex) const;
+
+	// Updates a smart projectile
+	void UpdateSmartProjectile(int32 _ProjectileIndex, float DeltaTime);
+
+	// Computes the segment of the obstacle probe of a projectile, from the projectile towards its target
+	void ComputeObstacleProbe(int32 _ProjectileIndex, FVector& _OutStart, FVector& _OutEnd) const;
+
+	// Traces the obstacle probe of a projectile from the game thread. Returns if something has been hit
+	bool TraceObstacleProbe(int32 _ProjectileIndex, FHitResult& _OutHit) const;
+
+	// Steers a projectile according to the blocking hit of its obstacle probe
+	void ApplyObstacleProbe(int32 _ProjectileIndex, const FHitResult& _Hit);
+
+	// Returns the index of a probed projectile, or INDEX_NONE if it has been destroyed, has hit with something or is no longer steered
+	int32 GetProbedProjectileIndex(const FNWPSparseSetHandle& _ProjectileHandle) const;
+
+	// Callback executed when an asynchronous obstacle probe has finished
+	void OnObstacleProbeCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData);
+
+	// Submits the asynchronous trace against the complex collision of an obstacle probe refinement
+	void SubmitObstacleRefinementTrace(const FNWPObstacleProbeRefinement& _Refinement);
+
+	// Callback executed when the asynchronous trace of an obstacle probe refinement has finished
+	void OnObstacleRefinementCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData);
+
+	// Applies a finished asynchronous obstacle probe to its projectile
+	void ResolveObstacleProbe(int32 _ProjectileIndex, const FHitResult& _Hit, bool _bHit);
+
+	// Callback executed after the projectile velocity has been computed
+	virtual void OnProjectileVelocityComputed(class ANWPProjectile* _ProjectileToProcess, FVector& _ComputedVelocity, float DeltaTime) override;
+
+	// Callback executed when the projectile has hit something
+	virtual void OnProjectileHit(class ANWPProjectile* _ProjectileToProcess, class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, 
+		FVector NormalImpulse, const FHitResult& Hit);
+
+	// Callback executed after a projectile has been added at the end of the spawned projectiles
+	virtual void OnSpawnedProjectileAdded(int32 _ProjectileIndex) override;
+
+	// Callback executed before a projectile is removed from the spawned projectiles. The last projectile is moved to its index
+	virtual void OnSpawnedProjectileRemoved(int32 _ProjectileIndex) override;
+
+// Member variables
+protected:
+
+	// Targets inside the target area
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<AActor*> CurrentTargets;
+
+	// Ranking of the current targets used to select the target of each projectile
+	FNWPTargetRanking TargetRanking;
+
+	// The target area begin position
+	UPROPERTY(Transient, SkipSerialization)
+	FVector2D TargetAreaBeginPosition;
+
+	// The target area. The X is the horizontal size. The Y is the vertical size
+	UPROPERTY(Transient, SkipSerialization)
+	FVector2D TargetArea;
+
+	// Steering state of each spawned projectile. Shares the index with the spawned projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	FNWPSmartProjectileSteering SmartProjectiles;
+
+	// Handles of the smart projectiles waiting to be updated, in round robin order
+	TArray<FNWPSparseSetHandle> ProjectileUpdateQueue;
+
+	// Registry that contains the targets of the world
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPTargetRegistry* CurrentTargetRegistry;
+
+	// Cache of the obstacles of the world found by the projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPObstacleCache* CurrentObstacleCache;
+
+	// Projector used to transform the target positions to screen positions
+	FNWPBatchedScreenProjector TargetProjector;
+
+	// Screen position of the registered targets inside the target area frustum. Shares the index with the target registry
+	TArray<FVector2D> TargetScreenPositions;
+
+	// If the screen position of each registered target is valid
+	TArray<bool> TargetScreenPositionsValid;
+
+	// Registry index of the targets found inside the target area frustum during the last update
+	TArray<int32> CandidateTargetIndices;
+
+	// Marks the registry index of the targets acquired during the previous update
+	TBitArray<> PreviousTargetsMask;
+
+	// Query params shared by the obstacle traces of the current update. The probes that finish during the next frame reuse them
+	FCollisionQueryParams ObstacleQueryParams;
+
+	// Query params shared by the complex refinement traces of the asynchronous obstacle probes
+	FCollisionQueryParams ObstacleRefinementQueryParams;
+
+	// Handles of the projectiles whose asynchronous obstacle probe has not finished yet, indexed by probe id
+	TMap<uint32, FNWPSparseSetHandle> InFlightObstacleProbes;
+
+	// Obstacle probes whose refinement trace has not finished yet, indexed by probe id
+	TMap<uint32, FNWPObstacleProbeRefinement> InFlightObstacleRefinements;
+
+	// Id assigned to the next asynchronous obstacle probe
+	uint32 NextObstacleProbeId;
+
+	// Delegate executed when an asynchronous obstacle probe finishes
+	FTraceDelegate ObstacleProbeDelegate;
+
+	// Delegate executed when the asynchronous trace of an obstacle probe refinement finishes
+	FTraceDelegate ObstacleRefinementDelegate;
+
+};
@@ -1,238 +1,624 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#pragma once
-
-// NWP
-#include "NeuronTestCharacter.h"
-#include "NWPWeaponConfig.h"
-#include "NWPProjectile.h"
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "NWPWeapon.generated.h"
-
-/**
- * Basic class for a weapon. It can shoot & reload. It has support for ammo (including projectiles). Can be configured using UNWPWeaponConfig
- */
-UCLASS()
-class NEURONWEAPONPLAYGROUND_API ANWPWeapon : public AActor
-{
-	GENERATED_BODY()
-
-// Friend class
-friend class ANWPProjectile;
-
-// Constructors
-public:
-
-	ANWPWeapon(const class FObjectInitializer& ObjectInitializer);
-
-// Member functions
-public:
-
-	/// AActor interface begin
-	// Overridable native event for when play begins for this actor.
-	virtual void BeginPlay() override;
-	
-	// Function called every frame on this Actor. 
-	virtual void Tick(float DeltaSeconds) override;
-	/// AActor interface end
-
-	///////////////////////////////////////////////////////////////////////////
-	// Accessors
-
-	// Returns the weapon config
-	FORCEINLINE const class UNWPWeaponConfig* GetWeaponConfig() const { return CurrentWeaponConfig; }
-
-	// Returns the weapon current state 
-	FORCEINLINE ENWPWeaponState GetWeaponState() const { return CurrentWeaponState; }
-
-	// Returns the weapon current cadence type
-	FORCEINLINE ENWPWeaponCadenceType GetCurrentConfiguredCadenceType() const { return CurrentConfiguredCadenceType; }
-
-	// Returns the weapon current cooldown
-	FORCEINLINE float GetCurrentCoolDown() const { return CurrentCoolDown; }
-
-	// Returns the weapon current ammo
-	FORCEINLINE int32 GetCurrentAmmo() const { return CurrentAmmo; }
-
-	// Returns the weapon current ammo in magazine
-	FORCEINLINE int32 GetCurrentAmmoInMagazine() const { return CurrentAmmoInMagazine; }
-
-	///////////////////////////////////////////////////////////////////////////
-	// Load / Unload
-
-	// Loads the required weapon assets
-	void LoadWeapon(TSubclassOf<class UNWPWeaponConfig> _WeaponConfig);
-
-	// Releases the loaded weapon assets
-	void ReleaseWeapon();
-
-	///////////////////////////////////////////////////////////////////////////
-	// Weapon State
-
-	// Returns if the weapon is shooting
-	FORCEINLINE bool IsShooting() const { return CurrentWeaponState == ENWPWeaponState::Shooting; }
-
-	// Returns if the weapon is reloading
-	FORCEINLINE bool IsReloading() const { return CurrentWeaponState == ENWPWeaponState::Reloading; }
-
-	// Changes the cadence type
-	void SwapCadenceType();
-
-	///////////////////////////////////////////////////////////////////////////
-	// Attach
-
-	// Returns if the weapon has an owner
-	FORCEINLINE bool HasOwner() const { return OwnerCharacter != nullptr; }
-
-	// Returns the weapon owner
-	FORCEINLINE class ANeuronTestCharacter* GetCharacterOwner() const { return OwnerCharacter; }
-
-	// This function that sets the owner character for this weapon
-	void SetOwnerCharacter(class ANeuronTestCharacter* _NewOwnerCharacter, bool _bAttachToOwner = true);
-
-	// Attaches the weapon to the owner
-	void AttachToOwner();
-
-	// Detaches the weapon from the owner
-	void DetachFromOwner();
-
-	///////////////////////////////////////////////////////////////////////////
-	// Shoot
-
-	// Starts the shooting process
-	void StartShooting();
-
-	// Stops the shooting process
-	void StopShooting();
-
-protected:
-
-	///////////////////////////////////////////////////////////////////////////
-	// Load / Unload
-
-	// Callback executed when the weapon loads
-	virtual void OnWeaponLoaded();
-
-	///////////////////////////////////////////////////////////////////////////
-	// Weapon State
-
-	// Set the weapon state
-	void SetWeaponState(ENWPWeaponState _WeaponStateToSet);
-
-	// Callback called when the weapon state has just changed
-	void OnWeaponStateChanged();
-
-	// Updates the shooting state
-	void UpdateShootingState(float DeltaSeconds);
-
-	///////////////////////////////////////////////////////////////////////////
-	// Shoot
-
-	// Executes a shoot step. Returns if the shoot step has caused a reload
-	bool InternalShootStep();
-
-	///////////////////////////////////////////////////////////////////////////
-	// Cool down
-
-	// Returns if the weapon cool down is active
-	bool IsCoolDownActive();
-
-	// Reset the cool down using the cadence type
-	void ResetCoolDown();
-
-	// Sets a new value for the cool down
-	void SetCoolDown(float Value, bool bAdditive = false);
-
-	// Updates the weapon cool down
-	void UpdateCoolDown(float DeltaTime);
-
-	///////////////////////////////////////////////////////////////////////////
-	// Ammo
-
-	// Tries to consume the ammo
-	bool TryToConsumeAmmo();
-
-	// Checks if the magazine has to reload
-	void CheckMagazineHasToReload();
-
-	// Reloads the magazine using the current ammo
-	void ReloadMagazine();
-
-	///////////////////////////////////////////////////////////////////////////
-	// Projectile
-
-	// Spawns the projectile
-	virtual void SpawProjectile();
-
-	// Callback executed after the projectile velocity has been computed
-	virtual void OnProjectileVelocityComputed(class ANWPProjectile* _ProjectileToProcess, FVector& _ComputedVelocity, float DeltaTime) {};
-
-	// Callback executed when the projectile has hit something
-	virtual void OnProjectileHit(class ANWPProjectile* _ProjectileToProcess, class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp,
-		FVector NormalImpulse, const FHitResult& Hit) {};
-
-	// Callback executed before the projectile is destroyed
-	virtual void OnProjectileIsGoingToBeDestroyed(class ANWPProjectile* _ProjectileToProcess);
-
-// Member variables
-protected:
-
-	////////////////////////////////////////////////////////////////
-	// Components
-
-	// First person view (seen only by self) 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Mesh, meta = (AllowPrivateAccess = "true"))
-	class USkeletalMeshComponent* FirstPersonGun;
-
-	///////////////////////////////////////////////////////////////////////////
-	// Configuration
-
-	// Default weapon configuration class to create
-	UPROPERTY(EditDefaultsOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
-	TSubclassOf<class UNWPWeaponConfig> DefaultWeaponConfigClass;
-
-	///////////////////////////////////////////////////////////////////////////
-	// State
-
-	// Reference to the owning character
-	UPROPERTY(Transient, SkipSerialization)
-	class ANeuronTestCharacter* OwnerCharacter;
-
-	// Current weapon config
-	UPROPERTY(Transient, SkipSerialization)
-	class UNWPWeaponConfig* CurrentWeaponConfig;
-
-	// Current weapon state
-	UPROPERTY(Transient, SkipSerialization)
-	ENWPWeaponState CurrentWeaponState;
-
-	// Current cadence configured
-	UPROPERTY(Transient, SkipSerialization)
-	ENWPWeaponCadenceType CurrentConfiguredCadenceType;
-
-	// The current value of the cooldown
-	UPROPERTY(Transient, SkipSerialization)
-	float CurrentCoolDown;
-
-	// The current amount of ammo 
-	UPROPERTY(Transient, SkipSerialization)
-	int32 CurrentAmmo;
-
-	// The current amount of ammo in the magazine
-	UPROPERTY(BlueprintReadOnly, Transient, SkipSerialization)
-	int32 CurrentAmmoInMagazine;
-
-	// The weapon state before the reload
-	UPROPERTY(Transient, SkipSerialization)
-	ENWPWeaponState WeaponStateBeforeReload;
-
-	// When finishing a reload, forces the none state
-	UPROPERTY(Transient, SkipSerialization)
-	bool bForceReloadToNone;
-
-	// Current spawned projectiles 
-	UPROPERTY(Transient, SkipSerialization)
-	TArray<ANWPProjectile*> CurrentSpawnedProjectiles;
-};
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// UE
+#include "WorldCollision.h"
+
+// NWP
+#include "NeuronTestCharacter.h"
+#include "NWPWeaponConfig.h"
+#include "NWPProjectile.h"
+#include "NWPSparseSet.h"
+#include "NWPWeaponManager.h"
+#include "NWPWeaponSimulation.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "NWPWeapon.generated.h"
+
+// Struct that contains the information of a single shot
+USTRUCT()
+struct FNWPShotData
+{
+	GENERATED_USTRUCT_BODY()
+
+// Constructors
+public:
+
+	FNWPShotData()
+	{
+		Location = FVector::ZeroVector;
+		Rotation = FRotator::ZeroRotator;
+		TimeOffset = 0.0f;
+		TimeStamp = 0.0f;
+	}
+
+// Member variables
+public:
+
+	// Origin of the shot
+	UPROPERTY(Transient, SkipSerialization)
+	FVector Location;
+
+	// Orientation of the shot
+	UPROPERTY(Transient, SkipSerialization)
+	FRotator Rotation;
+
+	// Time elapsed since the shot was due. The shot is fired late by this amount of seconds
+	UPROPERTY(Transient, SkipSerialization)
+	float TimeOffset;
+
+	// World time in which the shot was due
+	UPROPERTY(Transient, SkipSerialization)
+	float TimeStamp;
+};
+
+// Struct that contains a hitscan shot whose simple hit is refined against the complex collision by a follow up asynchronous trace
+USTRUCT()
+struct FNWPHitscanRefinement
+{
+	GENERATED_USTRUCT_BODY()
+
+// Constructors
+public:
+
+	FNWPHitscanRefinement()
+	{
+		Start = FVector::ZeroVector;
+		End = FVector::ZeroVector;
+		TraceBeginDistance = 0.0f;
+		TraceEndDistance = 0.0f;
+		bIsWindow = false;
+	}
+
+// Member variables
+public:
+
+	// The refined shot
+	UPROPERTY(Transient, SkipSerialization)
+	FNWPShotData ShotData;
+
+	// Hit of the first trace against the simple collision
+	UPROPERTY(Transient, SkipSerialization)
+	FHitResult SimpleHit;
+
+	// Start of the segment of the shot
+	UPROPERTY(Transient, SkipSerialization)
+	FVector Start;
+
+	// End of the segment of the shot
+	UPROPERTY(Transient, SkipSerialization)
+	FVector End;
+
+	// Distance from the start of the segment at which the refinement trace begins
+	UPROPERTY(Transient, SkipSerialization)
+	float TraceBeginDistance;
+
+	// Distance from the start of the segment at which the refinement trace ends
+	UPROPERTY(Transient, SkipSerialization)
+	float TraceEndDistance;
+
+	// Indicates that the refinement trace only crosses the component of the simple hit. Otherwise it goes to the end of the segment
+	UPROPERTY(Transient, SkipSerialization)
+	bool bIsWindow;
+};
+
+// Compact copy of the weapon config read by the fire path. Baked when the weapon is configured & when its mesh changes, 
+// so firing a shot does not build names, look up sockets or go through the config accessors. The cadence & the ammo 
+// parameters are baked into the weapon simulation
+struct FNWPWeaponRuntimeProfile
+{
+// Constructors
+public:
+
+	FNWPWeaponRuntimeProfile()
+	{
+		Reset();
+	}
+
+// Member functions
+public:
+
+	// Clears the profile
+	void Reset()
+	{
+		ShootDistance = 0.0f;
+		MuzzleSocketName = NAME_None;
+		MuzzleSocket = nullptr;
+		MuzzleBoneIndex = INDEX_NONE;
+		MuzzleOffsetLocation = FVector::ZeroVector;
+		MuzzleOffsetRotation = FRotator::ZeroRotator;
+		EyesOffsetLocation = FVector::ZeroVector;
+		EyesOffsetRotation = FRotator::ZeroRotator;
+		ProjectileClass = nullptr;
+		SimulatedProjectileMesh = nullptr;
+		MuzzleEffect = nullptr;
+		ShootSound = nullptr;
+		bUseProjectileAsAmmo = false;
+		bUseSimulatedProjectiles = false;
+		bUseAsyncHitscan = false;
+		HitscanTraceQuality = ENWPTraceQuality::Complex;
+		bUseEyesAsShootOrigin = false;
+		bMuzzleSocketIsValid = false;
+		bHasMuzzleOffset = false;
+		bHasEyesOffset = false;
+	}
+
+// Member variables
+public:
+
+	// Shoot distance
+	float ShootDistance;
+
+	// Name of the muzzle socket. Used to attach the muzzle effect
+	FName MuzzleSocketName;
+
+	// Muzzle socket of the weapon mesh. Null if the muzzle is a bone
+	const class USkeletalMeshSocket* MuzzleSocket;
+
+	// Index of the muzzle bone of the weapon mesh. Only used if the muzzle is not a socket
+	int32 MuzzleBoneIndex;
+
+	// Offset location added to the muzzle
+	FVector MuzzleOffsetLocation;
+
+	// Offset rotation added to the muzzle
+	FRotator MuzzleOffsetRotation;
+
+	// Offset location added to the eyes
+	FVector EyesOffsetLocation;
+
+	// Offset rotation added to the eyes
+	FRotator EyesOffsetRotation;
+
+	// Projectile to spawn. The config keeps the class referenced
+	UClass* ProjectileClass;
+
+	// Mesh used to draw the simulated projectiles. The config keeps the mesh referenced
+	class UStaticMesh* SimulatedProjectileMesh;
+
+	// Effect spawned at the muzzle. The config keeps the effect referenced
+	class UParticleSystem* MuzzleEffect;
+
+	// Sound played when shooting. The config keeps the sound referenced
+	class USoundBase* ShootSound;
+
+	// Quality of the hitscan traces
+	ENWPTraceQuality HitscanTraceQuality;
+
+	// Flags of the config
+	uint16 bUseProjectileAsAmmo : 1;
+	uint16 bUseSimulatedProjectiles : 1;
+	uint16 bUseAsyncHitscan : 1;
+	uint16 bUseEyesAsShootOrigin : 1;
+
+	// Indicates that the muzzle socket or bone exists in the current weapon mesh
+	uint16 bMuzzleSocketIsValid : 1;
+
+	// Indicates that the offsets are not zero, so they have to be added
+	uint16 bHasMuzzleOffset : 1;
+	uint16 bHasEyesOffset : 1;
+};
+
+// Sizes of the spawned projectiles of the weapons of a world compared to the projectiles in flight. Used to detect the 
+// projectiles that are never removed from their weapon
+struct FNWPProjectileLifecycleReport
+{
+// Constructors
+public:
+
+	FNWPProjectileLifecycleReport()
+	{
+		NumWeapons = 0;
+		NumSpawnedProjectiles = 0;
+		NumStaleProjectiles = 0;
+		NumLiveProjectiles = 0;
+	}
+
+// Member functions
+public:
+
+	// Returns the spawned projectiles that are not in flight anymore
+	FORCEINLINE int32 GetNumLeakedProjectiles() const { return FMath::Max(NumSpawnedProjectiles - NumLiveProjectiles, NumStaleProjectiles); }
+
+// Member variables
+public:
+
+	// Number of weapons
+	int32 NumWeapons;
+
+	// Number of projectiles in the spawned projectiles of the weapons
+	int32 NumSpawnedProjectiles;
+
+	// Number of spawned projectiles that are destroyed, back in their pool or owned by another weapon
+	int32 NumStaleProjectiles;
+
+	// Number of projectile actors in flight
+	int32 NumLiveProjectiles;
+};
+
+/**
+ * Basic class for a weapon. It can shoot & reload. It has support for ammo (including projectiles). Can be configured using UNWPWeaponConfig
+ */
+UCLASS()
+class NEURONWEAPONPLAYGROUND_API ANWPWeapon : public AActor
+{
+	GENERATED_BODY()
+
+// Friend class
+friend class ANWPProjectile;
+friend class ANWPProjectileSimulation;
+friend class ANWPWeaponManager;
+friend struct FNWPWeaponTestAccess;
+
+// Constructors
+public:
+
+	ANWPWeapon(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable native event for when play begins for this actor.
+	virtual void BeginPlay() override;
+
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	
+	// Function called every frame on this Actor. 
+	virtual void Tick(float DeltaSeconds) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the weapon config
+	FORCEINLINE const class UNWPWeaponConfig* GetWeaponConfig() const { return CurrentWeaponConfig; }
+
+	// Returns the weapon current state 
+	FORCEINLINE ENWPWeaponState GetWeaponState() const { return (ENWPWeaponState)GetSimulation().GetState(); }
+
+	// Returns the weapon current cadence type
+	FORCEINLINE ENWPWeaponCadenceType GetCurrentConfiguredCadenceType() const { return (ENWPWeaponCadenceType)GetSimulation().GetCadenceType(); }
+
+	// Returns the weapon current cooldown. The simulation keeps the time elapsed since the next shot was due as a negative cool down
+	FORCEINLINE float GetCurrentCoolDown() const { return FMath::Max(GetSimulation().GetCoolDown(), 0.0f); }
+
+	// Returns the weapon current ammo
+	FORCEINLINE int32 GetCurrentAmmo() const { return GetSimulation().GetAmmo(); }
+
+	// Returns the weapon current ammo in magazine
+	FORCEINLINE int32 GetCurrentAmmoInMagazine() const { return GetSimulation().GetAmmoInMagazine(); }
+
+	// Returns the simulation of the cool down, ammo, reload & cadence. Stored in the weapon manager while the weapon is managed,
+	// where it is only advanced when the weapon is updated or AdvanceSimulation is called
+	FORCEINLINE const FNWPWeaponSimulation& GetSimulation() const { return OwnerWeaponManager ? OwnerWeaponManager->GetSimulation(WeaponManagerIndex) : Simulation; }
+
+	// Advances the simulation of a managed weapon to the weapon manager time. The simulation of an unmanaged weapon is advanced by its tick
+	void AdvanceSimulation();
+
+	// Returns if the weapon is updated by the weapon manager
+	FORCEINLINE bool IsManagedByWeaponManager() const { return OwnerWeaponManager != nullptr; }
+
+	// Returns the profile read by the fire path
+	FORCEINLINE const FNWPWeaponRuntimeProfile& GetRuntimeProfile() const { return RuntimeProfile; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Load / Unload
+
+	// Acquires the shared weapon config & loads its assets. The weapon can be used while the assets are loaded asynchronously
+	void LoadWeapon(TSubclassOf<class UNWPWeaponConfig> _WeaponConfig);
+
+	// Returns if the weapon assets are loaded
+	bool IsWeaponLoaded() const;
+
+	// Releases the shared weapon config. Its assets are released when no other weapon uses it
+	void ReleaseWeapon();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Weapon State
+
+	// Returns if the weapon is shooting
+	FORCEINLINE bool IsShooting() const { return GetSimulation().GetState() == ENWPWeaponSimulationState::Shooting; }
+
+	// Returns if the weapon is reloading
+	FORCEINLINE bool IsReloading() const { return GetSimulation().GetState() == ENWPWeaponSimulationState::Reloading; }
+
+	// Changes the cadence type
+	void SwapCadenceType();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Lifecycle
+
+	// Returns the number of spawned projectiles
+	FORCEINLINE int32 GetNumSpawnedProjectiles() const { return CurrentSpawnedProjectiles.Num(); }
+
+	// Returns the number of spawned projectiles that are destroyed, back in their pool or owned by another weapon
+	int32 CountStaleSpawnedProjectiles() const;
+
+	// Compares the spawned projectiles of every weapon of the world with the projectiles in flight
+	static FNWPProjectileLifecycleReport BuildProjectileLifecycleReport(UWorld* _World);
+
+	///////////////////////////////////////////////////////////////////////////
+	// Attach
+
+	// Returns if the weapon has an owner
+	FORCEINLINE bool HasOwner() const { return OwnerCharacter != nullptr; }
+
+	// Returns the weapon owner
+	FORCEINLINE class ANeuronTestCharacter* GetCharacterOwner() const { return OwnerCharacter; }
+
+	// This function that sets the owner character for this weapon
+	void SetOwnerCharacter(class ANeuronTestCharacter* _NewOwnerCharacter, bool _bAttachToOwner = true);
+
+	// Attaches the weapon to the owner
+	void AttachToOwner();
+
+	// Detaches the weapon from the owner
+	void DetachFromOwner();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Inventory
+
+	// Returns if the weapon is the one being used by its owner
+	FORCEINLINE bool IsWeaponActive() const { return bIsWeaponActive; }
+
+	// Equips the weapon. Shows it, attaches it to the owner and enables the tick
+	virtual void ActivateWeapon();
+
+	// Holsters the weapon. Hides it and detaches it, keeping the ammo & cool down. Ticks until the fired shots are resolved
+	virtual void DeactivateWeapon();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Shoot
+
+	// Starts the shooting process
+	void StartShooting();
+
+	// Stops the shooting process
+	void StopShooting();
+
+protected:
+
+	///////////////////////////////////////////////////////////////////////////
+	// Load / Unload
+
+	// Configures the weapon using the values of the config. Called before the assets are loaded
+	virtual void ConfigureWeapon();
+
+	// Callback executed when the weapon assets are loaded
+	virtual void OnWeaponLoaded();
+
+	// Bakes the runtime profile from the weapon config & the current weapon mesh
+	void BakeRuntimeProfile();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Weapon State
+
+	// Set the weapon state
+	void SetWeaponState(ENWPWeaponState _WeaponStateToSet);
+
+	// Executes the state changed callback if the simulation has changed the state since the last call
+	void SyncWeaponState();
+
+	// Returns the mutable simulation, stored in the weapon manager while the weapon is managed. Wakes the managed weapon
+	FORCEINLINE FNWPWeaponSimulation& GetMutableSimulation() { return OwnerWeaponManager ? OwnerWeaponManager->GetMutableSimulation(WeaponManagerIndex) : Simulation; }
+
+	// Updates the shooting & submits the pending hitscan traces. Called after the cool down update
+	virtual void UpdateWeapon(float DeltaSeconds);
+
+	// Returns if the weapon has work to do in the current frame. The weapon manager lets the rest sleep until their timer expires
+	virtual bool NeedsWeaponUpdate() const;
+
+	// Callback called when the weapon state has just changed
+	void OnWeaponStateChanged();
+
+	// Updates the shooting state
+	void UpdateShootingState(float DeltaSeconds);
+
+	// Emits every shot that is due during the frame using the time accumulated in the cool down
+	void UpdateAccumulatedShots(float DeltaSeconds);
+
+	// Returns if the weapon has fired shots that still require the tick to be resolved
+	virtual bool HasShotsInFlight() const;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Shoot
+
+	// Executes a shoot step. Returns if the shoot step has caused a reload
+	bool InternalShootStep();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Projectile
+
+	// Calculates the shot origin. Returns if the muzzle socket is valid
+	bool ComputeShotOrigin(FVector& _OutLocation, FRotator& _OutRotation, FTransform& _OutMuzzleTransform) const;
+
+	// Spawns the projectile
+	virtual void SpawProjectile();
+
+	// Fires a batch of shots. The muzzle effects are only spawned once per batch
+	virtual void SpawProjectiles(const TArray<FNWPShotData>& _Shots, bool _bMuzzleSocketIsValid, const FTransform& _MuzzleTransform);
+
+	// Fires a single shot, spawning a projectile or shooting a ray
+	void FireShot(const FNWPShotData& _ShotData);
+
+	// Returns if the projectiles are simulated as data instead of spawned as actors
+	virtual bool ShouldUseSimulatedProjectiles() const;
+
+	// Callback executed after a shot has been fired. The spawned projectile is nullptr if no projectile has been spawned
+	virtual void OnShotFired(const FNWPShotData& _ShotData, class ANWPProjectile* _SpawnedProjectile) {};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Spawned projectiles
+
+	// Adds a projectile to the spawned projectiles & gives it its handle
+	void AddSpawnedProjectile(class ANWPProjectile* _Projectile);
+
+	// Removes a projectile from the spawned projectiles using its handle. Returns if it was a spawned projectile
+	bool RemoveSpawnedProjectile(class ANWPProjectile* _Projectile);
+
+	// Returns the index of a projectile in the spawned projectiles. INDEX_NONE if its handle is stale
+	int32 FindSpawnedProjectileIndex(const class ANWPProjectile* _Projectile) const;
+
+	// Callback executed after a projectile has been added at the end of the spawned projectiles
+	virtual void OnSpawnedProjectileAdded(int32 _ProjectileIndex) {};
+
+	// Callback executed before a projectile is removed from the spawned projectiles. The last projectile is moved to its index
+	virtual void OnSpawnedProjectileRemoved(int32 _ProjectileIndex) {};
+
+	// Removes every spawned projectile. The projectiles keep flying without owner weapon
+	void ReleaseSpawnedProjectiles();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Hitscan
+
+	// Fills the query params used by the hitscan traces
+	void BuildHitscanQueryParams(FCollisionQueryParams& _OutQueryParams) const;
+
+	// Submits the queued hitscan shots as asynchronous traces, respecting the per frame trace budget
+	void SubmitPendingHitscanTraces();
+
+	// Callback executed when an asynchronous hitscan trace has finished
+	void OnHitscanTraceCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData);
+
+	// Submits the asynchronous trace against the complex collision of a hitscan refinement
+	void SubmitHitscanRefinementTrace(const FNWPHitscanRefinement& _Refinement);
+
+	// Callback executed when the asynchronous trace of a hitscan refinement has finished
+	void OnHitscanRefinementCompleted(const FTraceHandle& _TraceHandle, FTraceDatum& _TraceData);
+
+	// Callback executed when a hitscan shot has been resolved
+	virtual void OnHitscanResolved(const FNWPShotData& _ShotData, const FHitResult& _Hit, bool _bHit);
+
+	// Callback executed after the projectile velocity has been computed. The projectile is null for the simulated projectiles
+	virtual void OnProjectileVelocityComputed(class ANWPProjectile* _ProjectileToProcess, FVector& _ComputedVelocity, float DeltaTime) {};
+
+	// Callback executed when the projectile has hit something. The projectile is null for the simulated projectiles
+	virtual void OnProjectileHit(class ANWPProjectile* _ProjectileToProcess, class UPrimitiveComponent* HitComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp,
+		FVector NormalImpulse, const FHitResult& Hit) {};
+
+	// Callback executed before the projectile is destroyed
+	virtual void OnProjectileIsGoingToBeDestroyed(class ANWPProjectile* _ProjectileToProcess);
+
+// Member variables
+protected:
+
+	////////////////////////////////////////////////////////////////
+	// Components
+
+	// First person view (seen only by self) 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Mesh, meta = (AllowPrivateAccess = "true"))
+	class USkeletalMeshComponent* FirstPersonGun;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Configuration
+
+	// Default weapon configuration class to create
+	UPROPERTY(EditDefaultsOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class UNWPWeaponConfig> DefaultWeaponConfigClass;
+
+	// Specifies that the assets of the weapon config are loaded asynchronously. The placeholder mesh is shown while loading
+	UPROPERTY(EditDefaultsOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	bool bLoadWeaponConfigAsync;
+
+	// Priority of the asynchronous load of the weapon config assets
+	UPROPERTY(EditDefaultsOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	int32 WeaponConfigLoadPriority;
+
+	// Mesh shown while the weapon config assets are being loaded
+	UPROPERTY(EditDefaultsOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	class USkeletalMesh* PlaceholderWeaponMesh;
+
+	///////////////////////////////////////////////////////////////////////////
+	// State
+
+	// Reference to the owning character
+	UPROPERTY(Transient, SkipSerialization)
+	class ANeuronTestCharacter* OwnerCharacter;
+
+	// Current weapon config. Shared with the rest of weapons that use the same config class
+	UPROPERTY(Transient, SkipSerialization)
+	const class UNWPWeaponConfig* CurrentWeaponConfig;
+
+	// Cache that hands out the shared weapon configs
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPWeaponConfigCache* CurrentWeaponConfigCache;
+
+	// Compact copy of the weapon config read by the fire path
+	FNWPWeaponRuntimeProfile RuntimeProfile;
+
+	// Simulation of the cool down, ammo, magazine, reload & cadence. Only used while the weapon is not managed
+	FNWPWeaponSimulation Simulation;
+
+	// Weapon manager that stores the simulation & updates the weapon
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPWeaponManager* OwnerWeaponManager;
+
+	// Index of the weapon in the weapon manager
+	int32 WeaponManagerIndex;
+
+	// State change counter of the simulation when the state changed callback was last executed
+	uint32 LastStateChangeCounter;
+
+	// Indicates that the weapon is equipped. A holstered weapon is hidden and stops ticking once its shots are resolved
+	UPROPERTY(Transient, SkipSerialization)
+	bool bIsWeaponActive;
+
+	// Current spawned projectiles. Dense array indexed by the spawned projectile set
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<ANWPProjectile*> CurrentSpawnedProjectiles;
+
+	// Handles of the spawned projectiles
+	FNWPSparseSet SpawnedProjectileSet;
+
+	// Pool used to acquire the projectiles
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPProjectilePool* CurrentProjectilePool;
+
+	// Simulation used to move the projectiles that are not actors
+	UPROPERTY(Transient, SkipSerialization)
+	class ANWPProjectileSimulation* CurrentProjectileSimulation;
+
+	// Shots fired during the current frame
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<FNWPShotData> CurrentShotBatch;
+
+	// Time elapsed since each shot of the current frame was due
+	TArray<float> ShotTimeOffsets;
+
+	// Shot origin location of the previous frame. Used to interpolate the accumulated shots
+	UPROPERTY(Transient, SkipSerialization)
+	FVector PreviousShotLocation;
+
+	// Shot origin rotation of the previous frame. Used to interpolate the accumulated shots
+	UPROPERTY(Transient, SkipSerialization)
+	FRotator PreviousShotRotation;
+
+	// Indicates that the previous shot origin is valid
+	UPROPERTY(Transient, SkipSerialization)
+	bool bHasPreviousShotOrigin;
+
+	// Hitscan shots waiting to be submitted as asynchronous traces
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<FNWPShotData> PendingHitscanShots;
+
+	// Hitscan shots whose asynchronous trace has not finished yet, indexed by trace id
+	UPROPERTY(Transient, SkipSerialization)
+	TMap<uint32, FNWPShotData> InFlightHitscanShots;
+
+	// Hitscan shots whose refinement trace has not finished yet, indexed by trace id
+	UPROPERTY(Transient, SkipSerialization)
+	TMap<uint32, FNWPHitscanRefinement> InFlightHitscanRefinements;
+
+	// Id assigned to the next asynchronous hitscan trace
+	uint32 NextHitscanTraceId;
+
+	// Delegate executed when an asynchronous hitscan trace finishes
+	FTraceDelegate HitscanTraceDelegate;
+
+	// Delegate executed when the asynchronous trace of a hitscan refinement finishes
+	FTraceDelegate HitscanRefinementDelegate;
+};
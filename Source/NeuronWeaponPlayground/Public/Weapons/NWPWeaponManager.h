@@ -0,0 +1,127 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// NWP
+#include "NWPTimerWheel.h"
+#include "NWPWeaponSimulation.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "NWPWeaponManager.generated.h"
+
+/**
+ * Per world manager that updates the weapons. The simulations of the weapons are stored in dense arrays that share the index with 
+ * the weapons. Only the active weapons are updated: the ones changed since the last tick, the ones with pending work, and the ones 
+ * whose cool down, reload or next shot has expired in the timer wheel. The simulations are advanced lazily to the manager time, 
+ * so an idle weapon costs nothing per frame & its state changes at the exact scheduled time. The managed weapons do not tick
+ */
+UCLASS(NotBlueprintable, Transient)
+class NEURONWEAPONPLAYGROUND_API ANWPWeaponManager : public AInfo
+{
+	GENERATED_BODY()
+
+// Constructors
+public:
+
+	ANWPWeaponManager(const class FObjectInitializer& ObjectInitializer);
+
+// Member functions
+public:
+
+	/// AActor interface begin
+	// Overridable function called whenever this actor is being removed from a level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Function called every frame on this Actor. 
+	virtual void Tick(float DeltaSeconds) override;
+	/// AActor interface end
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the weapon manager of the world. Spawns it if it does not exist and it is allowed
+	static ANWPWeaponManager* GetWeaponManager(UWorld* World, bool _bSpawnIfMissing = true);
+
+	// Returns the number of managed weapons
+	FORCEINLINE int32 GetNumWeapons() const { return Weapons.Num(); }
+
+	// Returns the number of weapons updated during the next tick
+	FORCEINLINE int32 GetNumActiveWeapons() const { return ActiveIndices.Num(); }
+
+	// Returns the simulation of a managed weapon as it was when last advanced
+	FORCEINLINE const FNWPWeaponSimulation& GetSimulation(int32 _Index) const { return Simulations[_Index]; }
+
+	// Returns the mutable simulation of a managed weapon advanced to the manager time. The weapon is updated during the next tick
+	FNWPWeaponSimulation& GetMutableSimulation(int32 _Index);
+
+	///////////////////////////////////////////////////////////////////////////
+	// Registration
+
+	// Adds a weapon to the manager. Its simulation is moved to the manager
+	void RegisterWeapon(class ANWPWeapon* _Weapon);
+
+	// Removes a weapon from the manager. Its simulation is moved back to the weapon
+	void UnregisterWeapon(class ANWPWeapon* _Weapon);
+
+	///////////////////////////////////////////////////////////////////////////
+	// Update
+
+	// Adds a weapon to the weapons updated during the next tick
+	void WakeWeapon(int32 _Index);
+
+	// Advances the simulation of a weapon to the manager time
+	void AdvanceSimulation(int32 _Index);
+
+protected:
+
+	// Schedules the timer of a weapon from its cool down. Cancels it if there is no cool down
+	void ScheduleWeaponTimer(int32 _Index);
+
+// Member variables
+protected:
+
+	// Managed weapons
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<class ANWPWeapon*> Weapons;
+
+	// Simulation of each weapon
+	TArray<FNWPWeaponSimulation> Simulations;
+
+	// Manager time to which the simulation of each weapon has been advanced
+	TArray<double> SimulationTimes;
+
+	// Id of the scheduled timer of each weapon. 0 if there is no timer
+	TArray<uint32> TimerIds;
+
+	// Expiry time of the scheduled timer of each weapon
+	TArray<double> TimerExpiryTimes;
+
+	// Indicates that each weapon is in the active weapons
+	TArray<bool> ActiveFlags;
+
+	// Indices of the weapons updated during the next tick
+	TArray<int32> ActiveIndices;
+
+	// Timers of the cool downs & reloads
+	FNWPTimerWheel TimerWheel;
+
+	// Time accumulated by the manager ticks
+	double ManagerTime;
+
+	// Id of the last scheduled timer
+	uint32 LastTimerId;
+
+	// Index of the weapon being updated. It decides if it stays active after the update
+	int32 UpdatingWeaponIndex;
+
+	// Indices of the weapons whose timer has expired during the current tick
+	TArray<int32> ExpiredIndices;
+
+	// Weapons updated during the current tick
+	UPROPERTY(Transient, SkipSerialization)
+	TArray<class ANWPWeapon*> UpdatedWeapons;
+
+	// Indicates that the simulation of each updated weapon has changed its state since its last state callback
+	TArray<bool> StateChangedFlags;
+};
@@ -0,0 +1,180 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+// NWP
+#include "NWPWeaponSimulationTypes.h"
+
+#include "CoreMinimal.h"
+
+// Parameters of the weapon simulation. Baked from the weapon config
+struct NEURONWEAPONPLAYGROUND_API FNWPWeaponSimulationParams
+{
+// Constructors
+public:
+
+	FNWPWeaponSimulationParams();
+
+// Member variables
+public:
+
+	// Cool down of each cadence type
+	float CoolDowns[(int32)ENWPWeaponSimulationCadenceType::COUNT];
+
+	// Time needed to reload the magazine
+	float MagazineReloadTime;
+
+	// Ammo when configured
+	int32 InitialAmmo;
+
+	// Maximum ammount of ammo
+	int32 MaximumAmmo;
+
+	// Ammount of ammo per magazine
+	int32 AmmoPerMagazine;
+
+	// Cadence type used when configured
+	ENWPWeaponSimulationCadenceType DefaultCadenceType;
+
+	// Indicates that the weapon can shoot automatically
+	bool bIsAutomatic;
+
+	// Indicates that the weapon can shoot semi automatically
+	bool bIsSemiAutomatic;
+
+	// Indicates that every shot that is due during a frame is fired
+	bool bAccumulateSubFrameShots;
+};
+
+/**
+ * State machine of the cool down, ammo, magazine, reload & cadence of a weapon. It is plain C++ that only depends on Core, 
+ * so it can be stepped without the engine (see NWPWeaponSimulationTest.cpp). ANWPWeapon wraps it & reacts to its state changes
+ */
+class NEURONWEAPONPLAYGROUND_API FNWPWeaponSimulation
+{
+// Constructors
+public:
+
+	FNWPWeaponSimulation();
+
+// Member functions
+public:
+
+	///////////////////////////////////////////////////////////////////////////
+	// Accessors
+
+	// Returns the parameters of the simulation
+	FORCEINLINE const FNWPWeaponSimulationParams& GetParams() const { return Params; }
+
+	// Returns the current state 
+	FORCEINLINE ENWPWeaponSimulationState GetState() const { return State; }
+
+	// Returns the current cadence type
+	FORCEINLINE ENWPWeaponSimulationCadenceType GetCadenceType() const { return CadenceType; }
+
+	// Returns the current cool down
+	FORCEINLINE float GetCoolDown() const { return CoolDown; }
+
+	// Returns the current ammo
+	FORCEINLINE int32 GetAmmo() const { return Ammo; }
+
+	// Returns the current ammo in magazine
+	FORCEINLINE int32 GetAmmoInMagazine() const { return AmmoInMagazine; }
+
+	// Returns the counter increased every time the state changes. Used to detect the changes without callbacks
+	FORCEINLINE uint32 GetStateChangeCounter() const { return StateChangeCounter; }
+
+	// Returns the cool down of the current cadence type
+	FORCEINLINE float GetCadenceCoolDown() const 
+	{ 
+		return (int32)CadenceType < (int32)ENWPWeaponSimulationCadenceType::COUNT ? Params.CoolDowns[(int32)CadenceType] : 0.0f; 
+	}
+
+	// Returns if the cool down is active
+	FORCEINLINE bool IsCoolDownActive() const { return CoolDown > 0.0f; }
+
+	// Returns if the shots that are due between frames are being accumulated
+	FORCEINLINE bool IsSubFrameFireAccumulatorActive() const { return Params.bAccumulateSubFrameShots && State == ENWPWeaponSimulationState::Shooting; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// State
+
+	// Sets the parameters & restores the cadence, the ammo & the magazine
+	void Configure(const FNWPWeaponSimulationParams& _Params);
+
+	// Sets the state. Increases the state change counter if it is different
+	void SetState(ENWPWeaponSimulationState _State);
+
+	// Changes the cadence type. Returns if it has changed
+	bool SwapCadenceType();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Shoot
+
+	// Returns if the shooting can start
+	FORCEINLINE bool CanStartShooting() const { return State == ENWPWeaponSimulationState::None && !IsCoolDownActive(); }
+
+	// Consumes the ammo of a shot & resets the cool down. Starts the reload if the magazine is empty. Returns if the shot has to be fired
+	bool ConsumeShot();
+
+	// Consumes every shot that is due during the frame, keeping the exceeded time. Writes the time elapsed since each shot was due. 
+	// Returns the number of shots
+	int32 ConsumeDueShots(float _DeltaSeconds, int32 _MaxShots, float* _OutTimeOffsets);
+
+	// Stops the shooting. If reloading, the weapon goes to none when the reload finishes
+	void StopShooting();
+
+	///////////////////////////////////////////////////////////////////////////
+	// Cool down
+
+	// Reset the cool down using the cadence type, keeping the time elapsed since the shot was due
+	void ResetCoolDown();
+
+	// Sets a new value for the cool down
+	void SetCoolDown(float _Value, bool _bAdditive = false);
+
+	// Updates the cool down. Finishes the reload when the cool down expires
+	void UpdateCoolDown(float _DeltaSeconds);
+
+	///////////////////////////////////////////////////////////////////////////
+	// Ammo
+
+	// Tries to consume the ammo
+	bool TryToConsumeAmmo();
+
+	// Starts the reload if there is ammo left. Returns if the reload has started
+	bool CheckMagazineHasToReload();
+
+	// Reloads the magazine using the current ammo
+	void ReloadMagazine();
+
+// Member variables
+protected:
+
+	// Parameters of the simulation
+	FNWPWeaponSimulationParams Params;
+
+	// Current state
+	ENWPWeaponSimulationState State;
+
+	// Current cadence type
+	ENWPWeaponSimulationCadenceType CadenceType;
+
+	// Current value of the cool down. Negative while shooting, it is the time elapsed since the next shot was due
+	float CoolDown;
+
+	// Current ammount of ammo 
+	int32 Ammo;
+
+	// Current ammount of ammo in the magazine
+	int32 AmmoInMagazine;
+
+	// State before the reload
+	ENWPWeaponSimulationState StateBeforeReload;
+
+	// When finishing a reload, forces the none state
+	bool bForceReloadToNone;
+
+	// Counter increased every time the state changes
+	uint32 StateChangeCounter;
+};
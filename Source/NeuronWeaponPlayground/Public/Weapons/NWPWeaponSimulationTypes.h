@@ -0,0 +1,22 @@
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Enum for the states of the weapon simulation. Plain mirror of ENWPWeaponState, so the simulation does not depend on UObject code
+enum class ENWPWeaponSimulationState : uint8
+{
+	Invalid,
+	None,
+	Shooting,
+	Reloading,
+};
+
+// Enum for the cadence types of the weapon simulation. Plain mirror of ENWPWeaponCadenceType
+enum class ENWPWeaponSimulationCadenceType : uint8
+{
+	Automatic,
+	SemiAutomatic,
+	COUNT,
+};
@@ -1,6 +1,6 @@
-// Copyright 2019 Neuron Station. All Rights Reserved.
-
-#include "TemplateClass.h"
-
-// UE
-// NWP
+// Copyright 2019 Neuron Station. All Rights Reserved.
+
+#include "TemplateClass.h"
+
+// UE
+// NWP